@@ -213,7 +213,11 @@ cui_c_make_append_defines(CMakeCommand *command)
     bool cui_renderer_direct3d11_enabled = c_make_config_is_enabled("cui_renderer_direct3d11", true);
 
     bool cui_framebuffer_screenshot_enabled = c_make_config_is_enabled("cui_framebuffer_screenshot", false);
+    bool cui_renderer_software_render_times_enabled = c_make_config_is_enabled("cui_renderer_software_render_times", false);
     bool cui_renderer_opengles2_render_times_enabled = c_make_config_is_enabled("cui_renderer_opengles2_render_times", false);
+    bool cui_primitive_merging_enabled = c_make_config_is_enabled("cui_primitive_merging", true);
+    bool cui_command_buffer_capture_enabled = c_make_config_is_enabled("cui_command_buffer_capture", false);
+    bool cui_glyph_cache_statistics_enabled = c_make_config_is_enabled("cui_glyph_cache_statistics", false);
 
     switch (c_make_get_target_platform())
     {
@@ -239,6 +243,11 @@ cui_c_make_append_defines(CMakeCommand *command)
             if (cui_renderer_software_enabled)
             {
                 c_make_command_append(command, "-DCUI_RENDERER_SOFTWARE_ENABLED=1");
+
+                if (cui_renderer_software_render_times_enabled)
+                {
+                    c_make_command_append(command, "-DCUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED=1");
+                }
             }
 
             if (cui_renderer_direct3d11_enabled)
@@ -262,6 +271,11 @@ cui_c_make_append_defines(CMakeCommand *command)
             if (cui_renderer_software_enabled)
             {
                 c_make_command_append(command, "-DCUI_RENDERER_SOFTWARE_ENABLED=1");
+
+                if (cui_renderer_software_render_times_enabled)
+                {
+                    c_make_command_append(command, "-DCUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED=1");
+                }
             }
 
             if (cui_renderer_opengles2_enabled)
@@ -280,6 +294,11 @@ cui_c_make_append_defines(CMakeCommand *command)
             if (cui_renderer_software_enabled)
             {
                 c_make_command_append(command, "-DCUI_RENDERER_SOFTWARE_ENABLED=1");
+
+                if (cui_renderer_software_render_times_enabled)
+                {
+                    c_make_command_append(command, "-DCUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED=1");
+                }
             }
 
             if (cui_renderer_metal_enabled)
@@ -297,6 +316,21 @@ cui_c_make_append_defines(CMakeCommand *command)
     {
         c_make_command_append(command, "-DCUI_FRAMEBUFFER_SCREENSHOT_ENABLED=1");
     }
+
+    if (cui_primitive_merging_enabled)
+    {
+        c_make_command_append(command, "-DCUI_PRIMITIVE_MERGING_ENABLED=1");
+    }
+
+    if (cui_command_buffer_capture_enabled)
+    {
+        c_make_command_append(command, "-DCUI_COMMAND_BUFFER_CAPTURE_ENABLED=1");
+    }
+
+    if (cui_glyph_cache_statistics_enabled)
+    {
+        c_make_command_append(command, "-DCUI_GLYPH_CACHE_STATISTICS_ENABLED=1");
+    }
 }
 
 static void
@@ -476,6 +510,26 @@ cui_c_make_build_static_library(const char *library_name, CMakeArchitecture targ
     c_make_command_run(command);
 }
 
+// The tools include the whole library, so they have access to its internals.
+static void
+cui_c_make_build_tool(const char *name)
+{
+    CMakeCommand command = { 0 };
+
+    cui_c_make_append_default_compiler_flags(&command, c_make_get_target_architecture());
+    cui_c_make_append_defines(&command);
+
+    c_make_command_append(&command, c_make_c_string_concat("-I", c_make_c_string_path_concat(c_make_get_source_path(), "include")));
+
+    c_make_command_append_output_executable(&command, c_make_c_string_path_concat(c_make_get_build_path(), name), c_make_get_target_platform());
+    c_make_command_append(&command, c_make_c_string_path_concat(c_make_get_source_path(), "src", c_make_c_string_concat(name, ".c")));
+
+    cui_c_make_append_linker_flags(&command, c_make_get_target_architecture());
+
+    c_make_log(CMakeLogLevelInfo, "compile '%s'\n", name);
+    c_make_command_run(command);
+}
+
 static void
 cui_c_make_build(const char *output_folder, const char *output_name, const char *input_name, CMakeArchitecture target_architecture)
 {
@@ -698,7 +752,11 @@ C_MAKE_ENTRY(command, argument_count, arguments)
         c_make_config_set_if_not_exists("cui_renderer_direct3d11", "on");
 
         c_make_config_set_if_not_exists("cui_framebuffer_screenshot", "off");
+        c_make_config_set_if_not_exists("cui_renderer_software_render_times", "off");
         c_make_config_set_if_not_exists("cui_renderer_opengles2_render_times", "off");
+        c_make_config_set_if_not_exists("cui_primitive_merging", "on");
+        c_make_config_set_if_not_exists("cui_command_buffer_capture", "off");
+        c_make_config_set_if_not_exists("cui_glyph_cache_statistics", "off");
 
         if (!cui_c_make_configuration_is_valid(CMakeLogLevelWarning))
         {
@@ -828,6 +886,13 @@ C_MAKE_ENTRY(command, argument_count, arguments)
         cui_c_make_build_example("Image Viewer", "image_viewer");
         cui_c_make_build_example("File Search", "file_search");
         cui_c_make_build_example("Color Tool", "color_tool");
+
+        if ((c_make_get_target_platform() == CMakePlatformLinux) || (c_make_get_target_platform() == CMakePlatformMacOs))
+        {
+            cui_c_make_build_tool("command_buffer_replay");
+            cui_c_make_build_tool("glyph_benchmark");
+            cui_c_make_build_tool("glyph_cache_benchmark");
+        }
     }
     else
     {
@@ -352,6 +352,23 @@ filename_matches(CuiString filename, CuiString search)
     return false;
 }
 
+typedef struct SearchJob
+{
+    CuiString search;
+    bool *matches;
+} SearchJob;
+
+static void
+search_files(void *data, int64_t begin, int64_t end)
+{
+    SearchJob *job = (SearchJob *) data;
+
+    for (int64_t i = begin; i < end; i += 1)
+    {
+        job->matches[i] = filename_matches(app.files[i].name, job->search);
+    }
+}
+
 static void
 on_input_action(CuiWidget *widget)
 {
@@ -361,13 +378,21 @@ on_input_action(CuiWidget *widget)
 
     if (cui_utf8_get_character_count(value) >= 3)
     {
+        CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(&app.temporary_memory);
+
         int32_t count = cui_array_count(app.files);
 
+        SearchJob job;
+        job.search = value;
+        job.matches = cui_alloc_array(&app.temporary_memory, bool, count, CuiDefaultAllocationParams());
+
+        cui_parallel_for(count, 4096, search_files, &job);
+
         for (int32_t i = 0; i < count; i += 1)
         {
             FileEntry file_entry = app.files[i];
 
-            if (filename_matches(file_entry.name, value))
+            if (job.matches[i])
             {
                 CuiString path = { 0 };
 
@@ -380,6 +405,8 @@ on_input_action(CuiWidget *widget)
             }
         }
 
+        cui_end_temporary_memory(temp_memory);
+
         cui_widget_relayout_parent(app.last_search_result);
     }
 }
@@ -455,6 +455,12 @@ typedef struct CuiSizedFontSpec
     float line_height;
 } CuiSizedFontSpec;
 
+typedef struct CuiCodepointRange
+{
+    uint32_t first;
+    uint32_t last; // inclusive
+} CuiCodepointRange;
+
 typedef enum CuiFileAttributeFlags
 {
     CUI_FILE_ATTRIBUTE_IS_DIRECTORY = (1 << 0),
@@ -626,6 +632,15 @@ cui_make_sized_font_spec(CuiString name, float size, float line_height)
     return result;
 }
 
+static inline CuiCodepointRange
+cui_make_codepoint_range(uint32_t first, uint32_t last)
+{
+    CuiCodepointRange result;
+    result.first = first;
+    result.last = last;
+    return result;
+}
+
 static inline CuiPoint
 cui_point_add(CuiPoint a, CuiPoint b)
 {
@@ -931,6 +946,10 @@ typedef enum CuiDirection
 
 typedef struct CuiBackgroundTask { uint32_t state; } CuiBackgroundTask;
 
+// NOTE: The contents of a task group are private. A zero initialized task group
+// can be waited on, which returns immediately.
+typedef struct CuiTaskGroup { uint64_t opaque[12]; } CuiTaskGroup;
+
 typedef enum CuiEventType
 {
     CUI_EVENT_TYPE_QUIT         = 0,
@@ -1057,6 +1076,13 @@ typedef enum CuiWidgetFlags
     CUI_WIDGET_FLAG_FIXED_WIDTH     = (1 << 1),
     CUI_WIDGET_FLAG_FIXED_HEIGHT    = (1 << 2),
     CUI_WIDGET_FLAG_CLIP_CONTENT    = (1 << 3),
+    // NOTE: The commands of the draw call, including those of all children, are recorded and
+    // replayed in the next frame as long as the rect, state, value, flags, ui scale, color theme
+    // and drawing version stay the same. The cui_widget_set_* functions, child list changes and
+    // handled events bump the drawing version. Code that writes to the members of a widget
+    // directly, or custom widgets that draw anything else, have to call
+    // cui_widget_invalidate_drawing() themselves. No built-in widget sets this flag by default.
+    CUI_WIDGET_FLAG_RETAIN_DRAWING  = (1 << 4),
 } CuiWidgetFlags;
 
 typedef enum CuiWidgetStateFlags
@@ -1071,6 +1097,11 @@ typedef enum CuiWindowCreationFlags
     // all platforms
     CUI_WINDOW_CREATION_FLAG_PREFER_SYSTEM_DECORATION = (1 << 0),
     CUI_WINDOW_CREATION_FLAG_NOT_USER_RESIZABLE       = (1 << 1),
+    // Stores the rasterized glyphs in the data directory when the window is
+    // destroyed and uses them to fill the glyph cache of the next window.
+    CUI_WINDOW_CREATION_FLAG_PERSISTENT_GLYPH_CACHE   = (1 << 3),
+    // Shares the glyph caches with all other windows with this flag, that use the same renderer.
+    CUI_WINDOW_CREATION_FLAG_SHARED_GLYPH_CACHE       = (1 << 4),
 
     // macos
     /* This creates a full height titlebar without a title
@@ -1080,6 +1111,14 @@ typedef enum CuiWindowCreationFlags
     CUI_WINDOW_CREATION_FLAG_MACOS_UNIFIED_TITLEBAR   = (1 << 2),
 } CuiWindowCreationFlags;
 
+typedef enum CuiCoverageMode
+{
+    // 16 samples per pixel, this is the default.
+    CUI_COVERAGE_MODE_SAMPLED  = 0,
+    // The exact area of every pixel that is covered by the outline.
+    CUI_COVERAGE_MODE_ANALYTIC = 1,
+} CuiCoverageMode;
+
 typedef enum CuiWindowFrameActions
 {
     CUI_WINDOW_FRAME_ACTION_CLOSE           = (1 << 0),
@@ -1117,6 +1156,10 @@ struct CuiWidget
     uint32_t flags;
     uint32_t state;
 
+    // NOTE: Added for CUI_WIDGET_FLAG_RETAIN_DRAWING, code that was compiled against
+    // an older layout of this struct has to be rebuilt.
+    uint32_t drawing_version;
+
     uint32_t value;
     uint32_t old_value;
 
@@ -1284,7 +1327,8 @@ CuiFile *cui_platform_file_create(CuiArena *temporary_memory, CuiString filename
 CuiFileAttributes cui_platform_file_get_attributes(CuiFile *file);
 CuiFileAttributes cui_platform_get_file_attributes(CuiArena *temporary_memory, CuiString filename);
 void cui_platform_file_truncate(CuiFile *file, uint64_t size);
-void cui_platform_file_read(CuiFile *file, void *buffer, uint64_t offset, uint64_t size);
+// Returns the number of bytes that were read, less than 'size' if the file ended or an error occurred.
+uint64_t cui_platform_file_read(CuiFile *file, void *buffer, uint64_t offset, uint64_t size);
 void cui_platform_file_write(CuiFile *file, void *buffer, uint64_t offset, uint64_t size);
 void cui_platform_file_close(CuiFile *file);
 
@@ -1375,6 +1419,15 @@ bool cui_background_task_start(CuiBackgroundTask *task, void (*task_func)(CuiBac
 void cui_background_task_cancel(CuiBackgroundTask *task);
 bool cui_background_task_has_finished(CuiBackgroundTask *task);
 
+// Calls 'func' for consecutive ranges [begin, end) of at most 'grain' elements covering [0, count)
+// on the worker threads and the calling thread. A 'grain' <= 0 lets CUI choose one.
+void cui_parallel_for(int64_t count, int64_t grain, void (*func)(void *data, int64_t begin, int64_t end), void *data);
+// Same as cui_parallel_for, but returns immediately. Use cui_task_group_wait() before
+// touching the results or reusing the task group.
+void cui_task_group_parallel_for(CuiTaskGroup *task_group, int64_t count, int64_t grain,
+                                 void (*func)(void *data, int64_t begin, int64_t end), void *data);
+void cui_task_group_wait(CuiTaskGroup *task_group);
+
 //
 // window
 //
@@ -1406,6 +1459,18 @@ void cui_window_set_cursor(CuiWindow *window, CuiCursorType cursor_type);
 
 CuiFontId cui_window_find_font_n(CuiWindow *window, const uint32_t n, ...);
 void cui_window_update_font(CuiWindow *window, CuiFontId font_id, float size, float line_height);
+// Rasterizes the glyphs of 'ranges' (printable ASCII if 'range_count' is 0) into the glyph cache ahead of
+// the first frame that needs them. The glyphs are rasterized again whenever the ui scale of the window changes.
+void cui_window_prewarm_font(CuiWindow *window, CuiFontId font_id, const CuiCodepointRange *ranges, int32_t range_count, bool in_background);
+// Rasterizes all glyphs that are at least 'min_glyph_height' pixels high with 'coverage_mode', smaller ones with
+// CUI_COVERAGE_MODE_SAMPLED. The coverage mode is part of the glyph cache key, so after a change the glyphs
+// are rasterized again with the new mode, glyphs of the previous mode are evicted once they are no longer used.
+void cui_window_set_glyph_coverage_mode(CuiWindow *window, CuiCoverageMode coverage_mode, float min_glyph_height);
+// Switches occlusion culling of the software renderer while the app runs, e.g. to compare render times.
+// The default comes from CUI_SOFTWARE_RENDERER_OCCLUSION_CULLING (on unless set to 0). Other renderers
+// don't cull, for them the setting is ignored and the getter returns false.
+void cui_window_set_occlusion_culling(CuiWindow *window, bool enabled);
+bool cui_window_get_occlusion_culling(CuiWindow *window);
 int32_t cui_window_get_font_line_height(CuiWindow *window, CuiFontId font_id);
 int32_t cui_window_get_font_cursor_offset(CuiWindow *window, CuiFontId font_id);
 int32_t cui_window_get_font_cursor_height(CuiWindow *window, CuiFontId font_id);
@@ -1468,6 +1533,7 @@ void cui_widget_set_box_shadow(CuiWidget *widget, float x_offset, float y_offset
 void cui_widget_set_ui_scale(CuiWidget *widget, float ui_scale);
 void cui_widget_set_font(CuiWidget *widget, CuiFontId font_id);
 void cui_widget_set_color_theme(CuiWidget *widget, const CuiColorTheme *color_theme);
+void cui_widget_invalidate_drawing(CuiWidget *widget);
 void cui_widget_relayout_parent(CuiWidget *widget);
 CuiPoint cui_widget_get_preferred_size(CuiWidget *widget);
 void cui_widget_layout(CuiWidget *widget, CuiRect rect);
@@ -0,0 +1,531 @@
+// Renders a command buffer capture (see CuiCommandBufferCaptureHeader) with the software
+// renderer without opening a window and prints how long the phases of a frame took.
+//
+//   command_buffer_replay <capture file> [-n <iterations>] [-incremental] [-o <output.bmp>]
+//
+// By default every iteration redraws all tiles. With -incremental the tile hashes of the
+// previous iteration are kept, which measures the cost of a frame in which nothing changed.
+
+#include <stdio.h>
+
+#if !defined(CUI_RENDERER_SOFTWARE_ENABLED)
+#  define CUI_RENDERER_SOFTWARE_ENABLED 1
+#endif
+
+#include "cui.c"
+
+typedef struct CuiReplayPhase
+{
+    const char *name;
+    uint64_t min_time;
+    uint64_t max_time;
+    uint64_t sum_time;
+} CuiReplayPhase;
+
+typedef struct CuiReplayCapture
+{
+    CuiCommandBufferCaptureHeader *header;
+
+    uint8_t *push_buffer;
+    uint32_t *index_buffer;
+    CuiCommandBufferCaptureTextureOperation *texture_operations;
+
+    uint32_t *texture_ids;
+    CuiTextureFormat *texture_formats;
+    CuiBitmap *textures;
+} CuiReplayCapture;
+
+static void
+_cui_replay_phase_add(CuiReplayPhase *phase, uint64_t time)
+{
+    if (time < phase->min_time) phase->min_time = time;
+    if (time > phase->max_time) phase->max_time = time;
+
+    phase->sum_time += time;
+}
+
+static inline double
+_cui_replay_to_ms(uint64_t time)
+{
+    return (1000.0 * (double) time) / (double) _cui_context.common.perf_frequency;
+}
+
+// Returns the index of the texture with 'texture_id' among the first 'texture_count' textures, or -1.
+static int32_t
+_cui_replay_find_texture(CuiReplayCapture *capture, uint32_t texture_count, uint32_t texture_id)
+{
+    for (uint32_t index = 0; index < texture_count; index += 1)
+    {
+        if (capture->texture_ids[index] == texture_id)
+        {
+            return (int32_t) index;
+        }
+    }
+
+    return -1;
+}
+
+// Primitives and clip rects are pushed in blocks of 16 byte, see CuiTexturedRect.
+static bool
+_cui_replay_is_valid_primitive(CuiReplayCapture *capture, uint32_t offset)
+{
+    uint32_t push_buffer_size = capture->header->push_buffer_size;
+
+    if ((offset % 16) || (((uint64_t) offset + sizeof(CuiTexturedRect)) > push_buffer_size))
+    {
+        return false;
+    }
+
+    CuiTexturedRect *textured_rect = (CuiTexturedRect *) (capture->push_buffer + offset);
+
+    // NOTE: A clip rect offset is stored plus one, 0 means that there is no clip rect.
+    if (textured_rect->clip_rect &&
+        (((textured_rect->clip_rect - 1) % 16) ||
+         (((uint64_t) textured_rect->clip_rect - 1 + sizeof(CuiClipRect)) > push_buffer_size)))
+    {
+        return false;
+    }
+
+    int32_t texture_index = _cui_replay_find_texture(capture, capture->header->texture_count, textured_rect->texture_id);
+
+    if (texture_index < 0)
+    {
+        return false;
+    }
+
+    // NOTE: The renderer doesn't clamp texture coordinates. It reads the texels between both
+    // coordinates, without the second one, or only the first one if both are the same.
+    CuiBitmap *texture = capture->textures + texture_index;
+
+    int32_t u_min = cui_min_int32(textured_rect->u0, textured_rect->u1);
+    int32_t v_min = cui_min_int32(textured_rect->v0, textured_rect->v1);
+    int32_t u_max = cui_max_int32(textured_rect->u0, textured_rect->u1);
+    int32_t v_max = cui_max_int32(textured_rect->v0, textured_rect->v1);
+
+    if (u_min == u_max) u_max += 1;
+    if (v_min == v_max) v_max += 1;
+
+    return (u_min >= 0) && (v_min >= 0) && (u_max <= texture->width) && (v_max <= texture->height);
+}
+
+static bool
+_cui_replay_load_capture(CuiReplayCapture *capture, CuiString filename, CuiArena *arena)
+{
+    CuiClearStruct(*capture);
+
+    CuiFile *file = cui_platform_file_open(&_cui_context.common.temporary_memory, filename, CUI_FILE_MODE_READ);
+
+    if (!file)
+    {
+        fprintf(stderr, "error: could not open '%.*s'\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    uint64_t size = cui_platform_file_get_size(file);
+    uint8_t *data = (uint8_t *) cui_alloc(arena, size, CuiDefaultAllocationParams());
+
+    if (!data)
+    {
+        fprintf(stderr, "error: could not allocate %llu bytes\n", (unsigned long long) size);
+        cui_platform_file_close(file);
+        return false;
+    }
+
+    cui_platform_file_read(file, data, 0, size);
+    cui_platform_file_close(file);
+
+    uint8_t *end = data + size;
+
+    if (size < sizeof(CuiCommandBufferCaptureHeader))
+    {
+        fprintf(stderr, "error: '%.*s' is too small\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    capture->header = (CuiCommandBufferCaptureHeader *) data;
+    data += sizeof(CuiCommandBufferCaptureHeader);
+
+    if ((capture->header->magic != CUI_COMMAND_BUFFER_CAPTURE_MAGIC) ||
+        (capture->header->version != CUI_COMMAND_BUFFER_CAPTURE_VERSION))
+    {
+        fprintf(stderr, "error: '%.*s' is not a command buffer capture of version %u\n",
+                (int) filename.count, filename.data, CUI_COMMAND_BUFFER_CAPTURE_VERSION);
+        return false;
+    }
+
+    // NOTE: Primitives store their coordinates as int16_t.
+    if ((capture->header->width <= 0) || (capture->header->height <= 0) ||
+        (capture->header->width > INT16_MAX) || (capture->header->height > INT16_MAX))
+    {
+        fprintf(stderr, "error: '%.*s' has an invalid size of %dx%d\n", (int) filename.count, filename.data,
+                capture->header->width, capture->header->height);
+        return false;
+    }
+
+    // NOTE: The index buffer directly follows the push buffer, which only grows in blocks of 16 byte.
+    if (capture->header->push_buffer_size % 16)
+    {
+        fprintf(stderr, "error: '%.*s' contains an invalid push buffer\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    uint64_t buffer_size = (uint64_t) capture->header->push_buffer_size +
+                           (uint64_t) capture->header->index_buffer_count * sizeof(uint32_t) +
+                           (uint64_t) capture->header->texture_operation_count * sizeof(CuiCommandBufferCaptureTextureOperation);
+
+    if (buffer_size > (uint64_t) (end - data))
+    {
+        fprintf(stderr, "error: '%.*s' is truncated\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    capture->push_buffer = data;
+    data += capture->header->push_buffer_size;
+
+    capture->index_buffer = (uint32_t *) data;
+    data += capture->header->index_buffer_count * sizeof(uint32_t);
+
+    capture->texture_operations = (CuiCommandBufferCaptureTextureOperation *) data;
+    data += capture->header->texture_operation_count * sizeof(CuiCommandBufferCaptureTextureOperation);
+
+    if (((uint64_t) capture->header->texture_count * sizeof(CuiCommandBufferCaptureTexture)) > (uint64_t) (end - data))
+    {
+        fprintf(stderr, "error: '%.*s' is truncated\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    capture->texture_ids = cui_alloc_array(arena, uint32_t, capture->header->texture_count, CuiDefaultAllocationParams());
+    capture->texture_formats = cui_alloc_array(arena, CuiTextureFormat, capture->header->texture_count, CuiDefaultAllocationParams());
+    capture->textures = cui_alloc_array(arena, CuiBitmap, capture->header->texture_count, CuiDefaultAllocationParams());
+
+    for (uint32_t index = 0; index < capture->header->texture_count; index += 1)
+    {
+        if (sizeof(CuiCommandBufferCaptureTexture) > (uint64_t) (end - data))
+        {
+            fprintf(stderr, "error: '%.*s' is truncated\n", (int) filename.count, filename.data);
+            return false;
+        }
+
+        CuiCommandBufferCaptureTexture *capture_texture = (CuiCommandBufferCaptureTexture *) data;
+        data += sizeof(CuiCommandBufferCaptureTexture);
+
+        if (capture_texture->format > CUI_TEXTURE_FORMAT_A8)
+        {
+            fprintf(stderr, "error: '%.*s' contains an invalid texture\n", (int) filename.count, filename.data);
+            return false;
+        }
+
+        CuiTextureFormat format = (CuiTextureFormat) capture_texture->format;
+        int32_t bytes_per_pixel = _cui_texture_format_get_bytes_per_pixel(format);
+
+        uint64_t pixel_size = (uint64_t) bytes_per_pixel * (uint64_t) capture_texture->width * (uint64_t) capture_texture->height;
+
+        if (!capture_texture->texture_id || (capture_texture->width <= 0) || (capture_texture->height <= 0) ||
+            (_cui_replay_find_texture(capture, index, capture_texture->texture_id) >= 0) ||
+            (pixel_size > (uint64_t) (end - data)))
+        {
+            fprintf(stderr, "error: '%.*s' contains an invalid texture\n", (int) filename.count, filename.data);
+            return false;
+        }
+
+        CuiBitmap *texture = capture->textures + index;
+
+        capture->texture_ids[index] = capture_texture->texture_id;
+        capture->texture_formats[index] = format;
+
+        texture->width = capture_texture->width;
+        texture->height = capture_texture->height;
+        texture->stride = bytes_per_pixel * capture_texture->width;
+        texture->pixels = data;
+
+        data += pixel_size;
+    }
+
+    // NOTE: The renderer trusts the command buffer, so everything that it uses as an offset
+    // or to look up a texture is checked before the capture is replayed.
+    for (uint32_t index = 0; index < capture->header->texture_operation_count; index += 1)
+    {
+        CuiCommandBufferCaptureTextureOperation *capture_op = capture->texture_operations + index;
+
+        if (capture_op->type != CUI_TEXTURE_OPERATION_UPDATE)
+        {
+            continue;
+        }
+
+        int32_t texture_index = _cui_replay_find_texture(capture, capture->header->texture_count, capture_op->texture_id);
+
+        if ((texture_index < 0) || (capture_op->rect_count > CUI_MAX_TEXTURE_UPDATE_RECT_COUNT))
+        {
+            fprintf(stderr, "error: '%.*s' contains an invalid texture operation\n", (int) filename.count, filename.data);
+            return false;
+        }
+
+        CuiBitmap *texture = capture->textures + texture_index;
+
+        for (uint32_t rect_index = 0; rect_index < capture_op->rect_count; rect_index += 1)
+        {
+            CuiRect rect = capture_op->rects[rect_index];
+
+            if ((rect.min.x < 0) || (rect.min.y < 0) || (rect.min.x > rect.max.x) || (rect.min.y > rect.max.y) ||
+                (rect.max.x > texture->width) || (rect.max.y > texture->height))
+            {
+                fprintf(stderr, "error: '%.*s' contains an invalid texture operation\n", (int) filename.count, filename.data);
+                return false;
+            }
+        }
+    }
+
+    for (uint32_t index = 0; index < capture->header->index_buffer_count; index += 1)
+    {
+        if (!_cui_replay_is_valid_primitive(capture, capture->index_buffer[index]))
+        {
+            fprintf(stderr, "error: '%.*s' contains an invalid primitive\n", (int) filename.count, filename.data);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Refills the command buffer like the application would have done it during a frame.
+static void
+_cui_replay_build_command_buffer(CuiCommandBuffer *command_buffer, CuiReplayCapture *capture, bool allocate_textures)
+{
+    if (allocate_textures)
+    {
+        for (uint32_t index = 0; index < capture->header->texture_count; index += 1)
+        {
+            CuiTextureOperation *texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+
+            texture_op->type = CUI_TEXTURE_OPERATION_ALLOCATE;
+            texture_op->format = (uint16_t) capture->texture_formats[index];
+            texture_op->texture_id = capture->texture_ids[index];
+            texture_op->payload.bitmap = capture->textures[index];
+        }
+    }
+
+    // The captured textures already contain the result of every update, only the
+    // operations themselves are needed so the renderer invalidates the right tiles.
+    for (uint32_t index = 0; index < capture->header->texture_operation_count; index += 1)
+    {
+        CuiCommandBufferCaptureTextureOperation *capture_op = capture->texture_operations + index;
+
+        if (capture_op->type == CUI_TEXTURE_OPERATION_UPDATE)
+        {
+            CuiTextureOperation *texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+
+            texture_op->type = CUI_TEXTURE_OPERATION_UPDATE;
+            texture_op->texture_id = capture_op->texture_id;
+            texture_op->payload.update.rect_count = capture_op->rect_count;
+
+            for (uint32_t rect_index = 0; rect_index < capture_op->rect_count; rect_index += 1)
+            {
+                texture_op->payload.update.rects[rect_index] = capture_op->rects[rect_index];
+            }
+        }
+    }
+
+    uint8_t *push_buffer = (uint8_t *) _cui_command_buffer_push_primitive(command_buffer, capture->header->push_buffer_size);
+    _cui_retained_drawing_copy(push_buffer, capture->push_buffer, capture->header->push_buffer_size);
+
+    for (uint32_t index = 0; index < capture->header->index_buffer_count; index += 1)
+    {
+        _cui_command_buffer_push_index(command_buffer, capture->index_buffer[index]);
+    }
+}
+
+int main(int argument_count, char **arguments)
+{
+    const char *capture_filename = 0;
+    const char *output_filename = 0;
+    int32_t iteration_count = 100;
+    bool incremental = false;
+
+    for (int argument_index = 1; argument_index < argument_count; argument_index += 1)
+    {
+        CuiString argument = CuiCString(arguments[argument_index]);
+
+        if (cui_string_equals(argument, CuiStringLiteral("-n")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            iteration_count = cui_max_int32(1, cui_string_parse_int32(CuiCString(arguments[argument_index])));
+        }
+        else if (cui_string_equals(argument, CuiStringLiteral("-o")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            output_filename = arguments[argument_index];
+        }
+        else if (cui_string_equals(argument, CuiStringLiteral("-incremental")))
+        {
+            incremental = true;
+        }
+        else
+        {
+            capture_filename = arguments[argument_index];
+        }
+    }
+
+    if (!capture_filename)
+    {
+        fprintf(stderr, "usage: %s <capture file> [-n <iterations>] [-incremental] [-o <output.bmp>]\n", arguments[0]);
+        return 1;
+    }
+
+    _cui_context.common.perf_frequency = cui_platform_get_performance_frequency();
+    cui_arena_allocate(&_cui_context.common.temporary_memory, CuiMiB(4));
+
+    CuiArena capture_arena;
+    cui_arena_allocate(&capture_arena, CuiGiB(1));
+
+    CuiReplayCapture capture;
+
+    if (!_cui_replay_load_capture(&capture, CuiCString(capture_filename), &capture_arena))
+    {
+        return 1;
+    }
+
+    int32_t worker_thread_count = cui_platform_get_performance_core_count() - 1;
+
+    worker_thread_count = cui_max_int32(1, worker_thread_count);
+
+    if (!_cui_init_worker_thread_queue(&_cui_context.common.worker_thread_queue, worker_thread_count))
+    {
+        fprintf(stderr, "error: could not allocate the worker thread queue\n");
+        return 1;
+    }
+
+    pthread_cond_init(&_cui_context.common.worker_thread_queue.semaphore_cond, 0);
+    pthread_mutex_init(&_cui_context.common.worker_thread_queue.semaphore_mutex, 0);
+
+    for (int32_t worker_thread_index = 0;
+         worker_thread_index < worker_thread_count;
+         worker_thread_index += 1)
+    {
+        pthread_t worker_thread;
+        pthread_create(&worker_thread, 0, _cui_worker_thread_proc, (void *) (uintptr_t) (worker_thread_index + 1));
+    }
+
+    CuiRendererSoftware *renderer = CuiContainerOf(_cui_renderer_software_create(), CuiRendererSoftware, base);
+
+    int32_t width = capture.header->width;
+    int32_t height = capture.header->height;
+
+    CuiFramebuffer framebuffer;
+    CuiClearStruct(framebuffer);
+
+    framebuffer.width = width;
+    framebuffer.height = height;
+    framebuffer.bitmap.width = width;
+    framebuffer.bitmap.height = height;
+    framebuffer.bitmap.stride = CuiAlign(width * 4, 64);
+    framebuffer.bitmap.pixels = cui_platform_allocate((uint64_t) framebuffer.bitmap.stride * (uint64_t) height);
+
+    CuiReplayPhase phases[] = {
+        { "build command buffer", UINT64_MAX, 0, 0 },
+        { "finish + merge"      , UINT64_MAX, 0, 0 },
+        { "binning"             , UINT64_MAX, 0, 0 },
+        { "render"              , UINT64_MAX, 0, 0 },
+        { "total"               , UINT64_MAX, 0, 0 },
+    };
+
+    uint32_t unmerged_primitive_count = 0;
+    uint32_t primitive_count = 0;
+
+    for (int32_t iteration = 0; iteration < iteration_count; iteration += 1)
+    {
+        uint64_t build_start = cui_platform_get_performance_counter();
+
+        CuiCommandBuffer *command_buffer = _cui_renderer_software_begin_command_buffer(renderer);
+        _cui_replay_build_command_buffer(command_buffer, &capture, iteration == 0);
+
+        uint64_t finish_start = cui_platform_get_performance_counter();
+
+        _cui_command_buffer_finish(command_buffer);
+
+#if CUI_PRIMITIVE_MERGING_ENABLED
+        _cui_command_buffer_merge_primitives(command_buffer);
+#endif
+
+        unmerged_primitive_count = command_buffer->unmerged_index_buffer_count;
+        primitive_count = command_buffer->index_buffer_count;
+
+        if (!incremental)
+        {
+            renderer->tile_state_width = 0;
+            renderer->tile_state_height = 0;
+        }
+
+        // Binning runs once more on its own to measure it, the renderer bins again.
+        uint64_t binning_start = cui_platform_get_performance_counter();
+
+        if (renderer->tile_count_x)
+        {
+            CuiRenderBinning binning;
+            binning.command_buffer = command_buffer;
+            binning.framebuffer_rect = cui_make_rect(0, 0, width, height);
+            binning.tile_width = renderer->tile_width;
+            binning.tile_height = renderer->tile_height;
+            binning.tile_count_x = renderer->tile_count_x;
+            binning.tile_count_y = renderer->tile_count_y;
+            binning.wait_time = 0;
+            binning.park_count = 0;
+
+            _cui_renderer_software_bin_primitives(renderer, &binning);
+        }
+
+        uint64_t render_start = cui_platform_get_performance_counter();
+
+        _cui_renderer_software_render(renderer, &framebuffer, command_buffer, capture.header->clear_color);
+
+        uint64_t render_end = cui_platform_get_performance_counter();
+
+        // The first iteration sets up the tile grid and allocates the scratch memory.
+        if (iteration > 0)
+        {
+            _cui_replay_phase_add(phases + 0, finish_start - build_start);
+            _cui_replay_phase_add(phases + 1, binning_start - finish_start);
+            _cui_replay_phase_add(phases + 2, render_start - binning_start);
+            _cui_replay_phase_add(phases + 3, render_end - render_start);
+            _cui_replay_phase_add(phases + 4, (render_end - render_start) + (binning_start - build_start));
+        }
+    }
+
+    printf("capture:     %dx%d, %u bytes push buffer, %u texture operations, %u textures\n", width, height,
+           capture.header->push_buffer_size, capture.header->texture_operation_count, capture.header->texture_count);
+    printf("primitives:  %u, %u after merging\n", unmerged_primitive_count, primitive_count);
+    printf("tile grid:   %ux%u tiles of %dx%d pixels, %d worker threads\n", renderer->tile_count_x, renderer->tile_count_y,
+           renderer->tile_width, renderer->tile_height, worker_thread_count);
+
+    if (iteration_count > 1)
+    {
+        double measured_count = (double) (iteration_count - 1);
+
+        printf("%d iterations (%s redraw):\n", iteration_count - 1, incremental ? "incremental" : "full");
+
+        for (uint32_t phase_index = 0; phase_index < CuiArrayCount(phases); phase_index += 1)
+        {
+            CuiReplayPhase *phase = phases + phase_index;
+            printf("  %-22s min=%8.3fms  avg=%8.3fms  max=%8.3fms\n", phase->name, _cui_replay_to_ms(phase->min_time),
+                   _cui_replay_to_ms(phase->sum_time) / measured_count, _cui_replay_to_ms(phase->max_time));
+        }
+    }
+
+    if (output_filename)
+    {
+        CuiString bmp_data = cui_image_encode_bmp(framebuffer.bitmap, true, true, &capture_arena);
+        CuiFile *output_file = cui_platform_file_create(&capture_arena, CuiCString(output_filename));
+
+        if (output_file)
+        {
+            cui_platform_file_truncate(output_file, bmp_data.count);
+            cui_platform_file_write(output_file, bmp_data.data, 0, bmp_data.count);
+            cui_platform_file_close(output_file);
+        }
+        else
+        {
+            fprintf(stderr, "error: could not create '%s'\n", output_filename);
+        }
+    }
+
+    return 0;
+}
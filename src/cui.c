@@ -26,16 +26,72 @@ _cui_atomic_read(volatile uint32_t *src)
 #endif
 }
 
-static inline void
+static inline uint32_t
 _cui_atomic_increment(volatile uint32_t *dst)
 {
 #if CUI_PLATFORM_WINDOWS
-    _InterlockedIncrement((volatile long *) dst);
+    return (uint32_t) _InterlockedIncrement((volatile long *) dst);
+#else
+    return __sync_add_and_fetch(dst, 1);
+#endif
+}
+
+static inline void
+_cui_atomic_decrement(volatile uint32_t *dst)
+{
+#if CUI_PLATFORM_WINDOWS
+    _InterlockedDecrement((volatile long *) dst);
+#else
+    __sync_sub_and_fetch(dst, 1);
+#endif
+}
+
+static inline void
+_cui_atomic_add(volatile uint32_t *dst, uint32_t value)
+{
+#if CUI_PLATFORM_WINDOWS
+    _InterlockedExchangeAdd((volatile long *) dst, (long) value);
 #else
-    __sync_add_and_fetch(dst, 1);
+    __sync_add_and_fetch(dst, value);
 #endif
 }
 
+static inline void
+_cui_cpu_relax(void)
+{
+#if CUI_ARCH_X86_64
+    _mm_pause();
+#elif CUI_ARCH_ARM64
+#  if CUI_PLATFORM_WINDOWS
+    __yield();
+#  else
+    __asm__ __volatile__ ("yield");
+#  endif
+#endif
+}
+
+static inline uint64_t
+_cui_hash_mix_u64(uint64_t hash, uint64_t value)
+{
+    hash = (hash ^ value) * 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 32);
+}
+
+// Identifies the contents of a font file across runs of the application.
+static uint64_t
+_cui_font_file_get_identity(CuiString path, CuiFileAttributes attributes)
+{
+    uint64_t hash = _cui_hash_mix_u64(0, attributes.size);
+    hash = _cui_hash_mix_u64(hash, attributes.modification_time);
+
+    for (int64_t index = 0; index < path.count; index += 1)
+    {
+        hash = _cui_hash_mix_u64(hash, path.data[index]);
+    }
+
+    return hash;
+}
+
 static void
 _cui_font_file_manager_scan_fonts(CuiArena *temporary_memory, CuiFontFileManager *font_file_manager)
 {
@@ -343,12 +399,16 @@ _cui_font_manager_find_font_valist(CuiArena *temporary_memory, CuiFontManager *f
                     font_file_id.value = cui_array_count(font_manager->font_file_manager->font_files);
 
                     CuiString font_contents = { 0 };
+                    uint64_t font_identity = 0;
 
                     CuiFile *file = cui_platform_file_open(temporary_memory, font_ref->path, CUI_FILE_MODE_READ);
 
                     if (file)
                     {
-                        uint64_t file_size = cui_platform_file_get_size(file);
+                        CuiFileAttributes attributes = cui_platform_file_get_attributes(file);
+
+                        uint64_t file_size = attributes.size;
+                        font_identity = _cui_font_file_get_identity(font_ref->path, attributes);
                         font_contents.data = (uint8_t *) cui_platform_allocate(file_size);
 
                         if (font_contents.data)
@@ -368,6 +428,7 @@ _cui_font_manager_find_font_valist(CuiArena *temporary_memory, CuiFontManager *f
                     else
                     {
                         font_file->name = font_ref->name;
+                        font_file->identity = font_identity;
                     }
 
                     break;
@@ -430,323 +491,2618 @@ _cui_font_manager_find_font_n(CuiArena *temporary_memory, CuiFontManager *font_m
 
 #ifndef CUI_NO_BACKEND
 
-static const uint32_t _CUI_MAX_PUSH_BUFFER_SIZE        = CuiMiB(1);
-static const uint32_t _CUI_MAX_INDEX_BUFFER_COUNT      = 16 * 1024;
-static const uint32_t _CUI_MAX_TEXTURE_OPERATION_COUNT = 32;
+// The command buffer grows beyond these if needed.
+static const uint32_t _CUI_INITIAL_PUSH_BUFFER_SIZE        = CuiMiB(1);
+static const uint32_t _CUI_INITIAL_INDEX_BUFFER_COUNT      = 16 * 1024;
+static const uint32_t _CUI_INITIAL_TEXTURE_OPERATION_COUNT = 32;
+
+// Number of spin iterations before a thread waiting for a task group goes to sleep.
+static const uint32_t _CUI_WORKER_THREAD_SPIN_COUNT        = 2048;
+
+#if CUI_PLATFORM_WINDOWS
+static __declspec(thread) uint32_t _cui_worker_thread_index;
+#else
+static __thread uint32_t _cui_worker_thread_index;
+#endif
+
+// Scratch memory for glyph rasterization. The main thread and the background threads all have
+// the worker thread index 0, so this can't be indexed by it and is thread local instead.
+#if CUI_PLATFORM_WINDOWS
+static __declspec(thread) CuiArena _cui_glyph_rasterization_arena;
+#else
+static __thread CuiArena _cui_glyph_rasterization_arena;
+#endif
 
 static bool
-_cui_do_next_worker_thread_queue_entry(CuiWorkerThreadQueue *queue)
+_cui_init_worker_thread_queue(CuiWorkerThreadQueue *queue, int32_t worker_thread_count)
 {
-    bool should_sleep = true;
+    CuiAssert(worker_thread_count >= 0);
 
-    uint32_t read_index = queue->read_index;
-    uint32_t next_read_index = (read_index + 1) % CuiArrayCount(queue->entries);
+    queue->pending_count = 0;
+    queue->sleeping_count = 0;
+    queue->parked_count = 0;
+    queue->deque_count = (uint32_t) worker_thread_count + 1;
 
-    if (read_index != queue->write_index)
+    // NOTE: The allocation is page aligned, so every deque starts on its own cache line.
+    queue->deques = (CuiWorkerThreadDeque *) cui_platform_allocate(queue->deque_count * sizeof(CuiWorkerThreadDeque));
+
+    if (!queue->deques)
     {
-        if (_cui_atomic_compare_and_swap(&queue->read_index, read_index, next_read_index))
-        {
-            CuiWorkerThreadQueueEntry entry = queue->entries[read_index];
-            CuiWorkerThreadTaskGroup *task_group = entry.task_group;
+        return false;
+    }
 
-            task_group->task_func(entry.data);
+#if CUI_PLATFORM_WINDOWS
+    InitializeSRWLock(&queue->completion_lock);
+    InitializeConditionVariable(&queue->completion_cond);
+#elif !CUI_PLATFORM_LINUX && !CUI_PLATFORM_ANDROID
+    pthread_mutex_init(&queue->completion_mutex, 0);
+    pthread_cond_init(&queue->completion_cond, 0);
+#endif
 
-            _cui_atomic_increment(&task_group->completion_count);
-        }
+    for (uint32_t deque_index = 0; deque_index < queue->deque_count; deque_index += 1)
+    {
+        CuiWorkerThreadDeque *deque = queue->deques + deque_index;
 
-        should_sleep = false;
+        deque->lock = 0;
+        deque->top = 0;
+        deque->bottom = 0;
+        deque->capacity = 0;
+        deque->entries = 0;
     }
 
-    return should_sleep;
+    return true;
 }
 
-static CuiWorkerThreadTaskGroup
-_cui_begin_worker_thread_task_group(void (*task_func)(void *))
+static inline void
+_cui_worker_thread_deque_lock(CuiWorkerThreadDeque *deque)
 {
-    CuiWorkerThreadTaskGroup result = { 0 };
-
-    result.task_func = task_func;
+    while (!_cui_atomic_compare_and_swap(&deque->lock, 0, 1))
+    {
+        _cui_cpu_relax();
+    }
+}
 
-    return result;
+static inline void
+_cui_worker_thread_deque_unlock(CuiWorkerThreadDeque *deque)
+{
+    _cui_atomic_compare_and_swap(&deque->lock, 1, 0);
 }
 
 static void
-_cui_add_worker_thread_queue_entry(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group, void *data)
+_cui_worker_thread_deque_push(CuiWorkerThreadDeque *deque, CuiWorkerThreadTaskGroup *task_group,
+                              uint8_t *data, uint64_t data_stride, uint32_t count)
 {
-    uint32_t write_index = queue->write_index;
-    uint32_t next_write_index = (write_index + 1) % CuiArrayCount(queue->entries);
+    _cui_worker_thread_deque_lock(deque);
 
-    CuiAssert(next_write_index != queue->read_index);
+    uint32_t entry_count = deque->bottom - deque->top;
 
-    CuiWorkerThreadQueueEntry *entry = queue->entries + write_index;
-    entry->task_group = task_group;
-    entry->data = data;
+    if ((entry_count + count) > deque->capacity)
+    {
+        uint32_t new_capacity = cui_max_uint32(64, deque->capacity);
 
-    _cui_atomic_increment(&task_group->completion_goal);
-    queue->write_index = next_write_index;
+        while (new_capacity < (entry_count + count))
+        {
+            new_capacity *= 2;
+        }
 
-#if CUI_PLATFORM_WINDOWS
-    ReleaseSemaphore(queue->semaphore, 1, 0);
-#else
-    pthread_cond_signal(&queue->semaphore_cond);
-#endif
-}
+        CuiWorkerThreadQueueEntry *new_entries =
+            (CuiWorkerThreadQueueEntry *) cui_platform_allocate(new_capacity * sizeof(CuiWorkerThreadQueueEntry));
 
-static void
-_cui_complete_worker_thread_task_group(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group)
-{
-    while (task_group->completion_count != task_group->completion_goal)
-    {
-        _cui_do_next_worker_thread_queue_entry(queue);
-    }
-}
+        for (uint32_t index = 0; index < entry_count; index += 1)
+        {
+            new_entries[index] = deque->entries[(deque->top + index) & (deque->capacity - 1)];
+        }
 
-static CuiTextureOperation *
-_cui_command_buffer_add_texture_operation(CuiCommandBuffer *command_buffer)
-{
-    CuiAssert(command_buffer->texture_operation_count < command_buffer->max_texture_operation_count);
+        if (deque->entries)
+        {
+            cui_platform_deallocate(deque->entries, deque->capacity * sizeof(CuiWorkerThreadQueueEntry));
+        }
 
-    CuiTextureOperation *texture_op = command_buffer->texture_operations +
-                                      command_buffer->texture_operation_count;
-    command_buffer->texture_operation_count += 1;
+        deque->entries = new_entries;
+        deque->capacity = new_capacity;
+        deque->top = 0;
+        deque->bottom = entry_count;
+    }
 
-    return texture_op;
-}
+    for (uint32_t index = 0; index < count; index += 1)
+    {
+        CuiWorkerThreadQueueEntry *entry = deque->entries + ((deque->bottom + index) & (deque->capacity - 1));
 
-static inline void *
-_cui_command_buffer_push_primitive(CuiCommandBuffer *command_buffer, uint32_t size)
-{
-    CuiAssert((command_buffer->push_buffer_size + size) <= command_buffer->max_push_buffer_size);
+        entry->task_group = task_group;
+        entry->data = data + (index * data_stride);
+    }
 
-    void *result = command_buffer->push_buffer + command_buffer->push_buffer_size;
-    command_buffer->push_buffer_size += size;
+    deque->bottom += count;
 
-    return result;
+    _cui_worker_thread_deque_unlock(deque);
 }
 
-static inline uint32_t
-_cui_command_buffer_push_clip_rect(CuiCommandBuffer *command_buffer, CuiRect rect)
+static bool
+_cui_worker_thread_deque_take(CuiWorkerThreadDeque *deque, CuiWorkerThreadQueueEntry *entry, bool steal)
 {
-    uint32_t offset = command_buffer->push_buffer_size + 1;
+    bool result = false;
 
-    CuiAssert((rect.min.x >= INT16_MIN) && (rect.min.x <= INT16_MAX));
-    CuiAssert((rect.min.y >= INT16_MIN) && (rect.min.y <= INT16_MAX));
-    CuiAssert((rect.max.x >= INT16_MIN) && (rect.max.x <= INT16_MAX));
-    CuiAssert((rect.max.y >= INT16_MIN) && (rect.max.y <= INT16_MAX));
+    // NOTE: This unlocked check is only a hint to avoid touching the lock of empty deques.
+    if (deque->top != deque->bottom)
+    {
+        _cui_worker_thread_deque_lock(deque);
 
-    CuiClipRect *clip_rect = (CuiClipRect *) _cui_command_buffer_push_primitive(command_buffer, sizeof(CuiClipRect));
+        if (deque->top != deque->bottom)
+        {
+            if (steal)
+            {
+                *entry = deque->entries[deque->top & (deque->capacity - 1)];
+                deque->top += 1;
+            }
+            else
+            {
+                deque->bottom -= 1;
+                *entry = deque->entries[deque->bottom & (deque->capacity - 1)];
+            }
 
-    clip_rect->x_min = (int16_t) rect.min.x;
-    clip_rect->y_min = (int16_t) rect.min.y;
-    clip_rect->x_max = (int16_t) rect.max.x;
-    clip_rect->y_max = (int16_t) rect.max.y;
+            result = true;
+        }
 
-    return offset;
+        _cui_worker_thread_deque_unlock(deque);
+    }
+
+    return result;
 }
 
-static void
-_cui_glyph_cache_reset(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer)
+// Takes any entry of 'task_group'. The order of the entries within a deque carries no meaning,
+// so the gap is closed with the entry at the bottom.
+static bool
+_cui_worker_thread_deque_take_from_group(CuiWorkerThreadDeque *deque, CuiWorkerThreadQueueEntry *entry,
+                                         CuiWorkerThreadTaskGroup *task_group)
 {
-    cache->count = 0;
-    cache->insertion_failure_count = 0;
+    bool result = false;
 
-    for (uint32_t index = 0; index < cache->allocated; index++)
+    // NOTE: This unlocked check is only a hint to avoid touching the lock of empty deques.
+    if (deque->top != deque->bottom)
     {
-        cache->hashes[index] = 0;
-    }
+        _cui_worker_thread_deque_lock(deque);
 
-    cache->x = 1;
-    cache->y = 0;
-    cache->y_max = 1;
+        for (uint32_t index = deque->bottom; index != deque->top; index -= 1)
+        {
+            CuiWorkerThreadQueueEntry *candidate = deque->entries + ((index - 1) & (deque->capacity - 1));
 
-    cui_bitmap_clear(&cache->texture, cui_make_color(0.0f, 0.0f, 0.0f, 0.0f));
+            if (candidate->task_group == task_group)
+            {
+                *entry = *candidate;
 
-    *(uint32_t *) cache->texture.pixels = 0xFFFFFFFF;
+                deque->bottom -= 1;
+                *candidate = deque->entries[deque->bottom & (deque->capacity - 1)];
 
-    // TODO: remove all texture updates from the command buffer
+                result = true;
+                break;
+            }
+        }
 
-    CuiTextureOperation *texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+        _cui_worker_thread_deque_unlock(deque);
+    }
 
-    texture_op->type = CUI_TEXTURE_OPERATION_UPDATE;
-    texture_op->texture_id = cache->texture_id;
-    texture_op->payload.rect = cui_make_rect(0, 0, 1, 1);
+    return result;
 }
 
 static void
-_cui_glyph_cache_maybe_reset(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer)
+_cui_finish_worker_thread_task(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group)
 {
-    float hash_map_fill_rate = (float) cache->count / (float) cache->allocated;
-    float texture_fill_rate = (float) cache->y / (float) cache->texture.height;
+    // NOTE: As soon as the completion count reaches the goal the task group
+    // may go out of scope, so it must not be dereferenced after the increment.
+    uint32_t completion_goal = task_group->completion_goal;
+    volatile uint32_t *completion_count_address = &task_group->completion_count;
 
-    if ((cache->insertion_failure_count > 0) ||
-        (hash_map_fill_rate > 0.75f) || (texture_fill_rate > 0.8f))
+    uint32_t completion_count = _cui_atomic_increment(completion_count_address);
+
+    if ((completion_count == completion_goal) && _cui_atomic_read(&queue->parked_count))
     {
-        _cui_glyph_cache_reset(cache, command_buffer);
+#if CUI_PLATFORM_LINUX || CUI_PLATFORM_ANDROID
+        // A stale address can at most cause a spurious wakeup of some other futex.
+        syscall(SYS_futex, completion_count_address, FUTEX_WAKE_PRIVATE, INT32_MAX, 0, 0, 0);
+#elif CUI_PLATFORM_WINDOWS
+        AcquireSRWLockExclusive(&queue->completion_lock);
+        ReleaseSRWLockExclusive(&queue->completion_lock);
+        WakeAllConditionVariable(&queue->completion_cond);
+#else
+        pthread_mutex_lock(&queue->completion_mutex);
+        pthread_cond_broadcast(&queue->completion_cond);
+        pthread_mutex_unlock(&queue->completion_mutex);
+#endif
     }
 }
 
 static void
-_cui_glyph_cache_initialize(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer, int32_t texture_id)
+_cui_park_worker_thread_task_group(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group)
 {
-    cache->texture_id = texture_id;
-
-    cache->allocated = 4096;
-
-    cache->texture.width  = cui_min_int32(2048, command_buffer->max_texture_width);
-    cache->texture.height = cui_min_int32(2048, command_buffer->max_texture_height);
-    cache->texture.stride = CuiAlign(cache->texture.width * 4, 16);
-
-    uint64_t hashes_size  = CuiAlign(cache->allocated * sizeof(uint32_t), 16);
-    uint64_t keys_size    = CuiAlign(cache->allocated * sizeof(CuiGlyphKey), 16);
-    uint64_t rects_size   = CuiAlign(cache->allocated * sizeof(CuiRect), 16);
-    uint64_t texture_size = cache->texture.stride * cache->texture.height;
+    // NOTE: The parked count is incremented before checking the completion count
+    // for the last time, so either we see the completion or the finishing thread sees us.
+    _cui_atomic_increment(&queue->parked_count);
 
-    cache->allocation_size = hashes_size + keys_size + rects_size + texture_size;
-
-    uint8_t *allocation = (uint8_t *) cui_platform_allocate(cache->allocation_size);
+#if CUI_PLATFORM_LINUX || CUI_PLATFORM_ANDROID
+    uint32_t completion_count = _cui_atomic_read(&task_group->completion_count);
 
-    cache->hashes = (uint32_t *) allocation;
-    allocation += hashes_size;
+    if (completion_count != task_group->completion_goal)
+    {
+        syscall(SYS_futex, &task_group->completion_count, FUTEX_WAIT_PRIVATE, completion_count, 0, 0, 0);
+    }
+#elif CUI_PLATFORM_WINDOWS
+    AcquireSRWLockExclusive(&queue->completion_lock);
 
-    cache->keys = (CuiGlyphKey *) allocation;
-    allocation += keys_size;
+    while (_cui_atomic_read(&task_group->completion_count) != task_group->completion_goal)
+    {
+        SleepConditionVariableSRW(&queue->completion_cond, &queue->completion_lock, INFINITE, 0);
+    }
 
-    cache->rects = (CuiRect *) allocation;
-    allocation += rects_size;
+    ReleaseSRWLockExclusive(&queue->completion_lock);
+#else
+    pthread_mutex_lock(&queue->completion_mutex);
 
-    cache->texture.pixels = allocation;
+    while (_cui_atomic_read(&task_group->completion_count) != task_group->completion_goal)
+    {
+        pthread_cond_wait(&queue->completion_cond, &queue->completion_mutex);
+    }
 
-    CuiTextureOperation *texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+    pthread_mutex_unlock(&queue->completion_mutex);
+#endif
 
-    texture_op->type = CUI_TEXTURE_OPERATION_ALLOCATE;
-    texture_op->texture_id = cache->texture_id;
-    texture_op->payload.bitmap = cache->texture;
+    _cui_atomic_decrement(&queue->parked_count);
 
-    _cui_glyph_cache_reset(cache, command_buffer);
+    task_group->park_count += 1;
 }
 
 static bool
-_cui_glyph_cache_find(CuiGlyphCache *cache, uint32_t id, uint32_t codepoint, float scale, float offset_x, float offset_y, CuiRect *rect)
+_cui_do_next_worker_thread_queue_entry(CuiWorkerThreadQueue *queue)
 {
-    CuiAssert((cache->allocated > 0) && !((cache->allocated - 1) & cache->allocated));
+    CuiAssert(queue->deque_count > 0);
 
-    uint32_t mask = cache->allocated - 1;
+    uint32_t own_index = _cui_worker_thread_index;
 
-    uint32_t hash = codepoint + 1;
-    uint32_t bucket = hash & mask;
+    CuiWorkerThreadQueueEntry entry;
+    bool found = _cui_worker_thread_deque_take(queue->deques + own_index, &entry, false);
 
-    uint32_t probe_increment = 1 + (hash % mask);
+    for (uint32_t offset = 1; !found && (offset < queue->deque_count); offset += 1)
+    {
+        found = _cui_worker_thread_deque_take(queue->deques + ((own_index + offset) % queue->deque_count), &entry, true);
+    }
 
-    while (cache->hashes[bucket])
+    if (found)
     {
-        if (cache->hashes[bucket] == hash)
-        {
-            if ((cache->keys[bucket].id == id) &&
-                (cache->keys[bucket].codepoint == codepoint) &&
-                (cache->keys[bucket].scale == scale) &&
-                (cache->keys[bucket].offset_x == offset_x) &&
-                (cache->keys[bucket].offset_y == offset_y))
-            {
-                *rect = cache->rects[bucket];
-                return true;
-            }
-        }
+        _cui_atomic_decrement(&queue->pending_count);
 
-        bucket = (bucket + probe_increment) & mask;
-        probe_increment += 1;
+        CuiWorkerThreadTaskGroup *task_group = entry.task_group;
+
+        task_group->task_func(entry.data);
+
+        _cui_finish_worker_thread_task(queue, task_group);
     }
 
-    return false;
+    return !found;
 }
 
-static void
-_cui_glyph_cache_put(CuiGlyphCache *cache, uint32_t id, uint32_t codepoint, float scale, float offset_x, float offset_y, CuiRect rect)
+// Same as _cui_do_next_worker_thread_queue_entry, but only runs entries of 'task_group'.
+// A thread that waits for its own group must not pick up unrelated tasks: they can take
+// much longer than the group itself and may use per thread state of the waiting thread.
+static bool
+_cui_do_next_worker_thread_task_group_entry(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group)
 {
-    CuiAssert((cache->allocated > 0) && !((cache->allocated - 1) & cache->allocated));
+    CuiAssert(queue->deque_count > 0);
 
-    uint32_t mask = cache->allocated - 1;
-
-    uint32_t hash = codepoint + 1;
-    uint32_t bucket = hash & mask;
+    uint32_t own_index = _cui_worker_thread_index;
 
-    uint32_t probe_increment = 1 + (hash % mask);
+    CuiWorkerThreadQueueEntry entry;
+    bool found = false;
 
-    cache->count += 1;
+    for (uint32_t offset = 0; !found && (offset < queue->deque_count); offset += 1)
+    {
+        found = _cui_worker_thread_deque_take_from_group(queue->deques + ((own_index + offset) % queue->deque_count), &entry, task_group);
+    }
 
-    for (;;)
+    if (found)
     {
-        if (!cache->hashes[bucket])
-        {
-            cache->hashes[bucket] = hash;
-            cache->keys[bucket].id = id;
-            cache->keys[bucket].codepoint = codepoint;
-            cache->keys[bucket].scale = scale;
-            cache->keys[bucket].offset_x = offset_x;
-            cache->keys[bucket].offset_y = offset_y;
-            cache->rects[bucket] = rect;
-            return;
-        }
+        _cui_atomic_decrement(&queue->pending_count);
 
-        bucket = (bucket + probe_increment) & mask;
-        probe_increment += 1;
+        task_group->task_func(entry.data);
+
+        _cui_finish_worker_thread_task(queue, task_group);
     }
+
+    return !found;
 }
 
-static CuiRect
-_cui_glyph_cache_allocate_texture(CuiGlyphCache *cache, int32_t width, int32_t height, CuiCommandBuffer *command_buffer)
+static CuiWorkerThreadTaskGroup
+_cui_begin_worker_thread_task_group(void (*task_func)(void *))
 {
-    CuiRect result = cui_make_rect(0, 0, 0, 0);
+    CuiWorkerThreadTaskGroup result = { 0 };
 
-    if ((cache->x + width) > cache->texture.width)
-    {
-        cache->y = cache->y_max;
-        cache->x = 0;
-    }
+    result.task_func = task_func;
 
-    if ((cache->y + height) <= cache->texture.height)
-    {
-        result.min = cui_make_point(cache->x, cache->y);
-        result.max = cui_make_point(cache->x + width, cache->y + height);
+    return result;
+}
 
-        cache->x += width;
+// Adds 'count' entries at once, the data pointer of the n-th entry is 'data + n * data_stride'.
+// Wakes up at most as many sleeping worker threads as there are new entries.
+static void
+_cui_add_worker_thread_queue_entries(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group,
+                                     void *data, uint64_t data_stride, uint32_t count)
+{
+    CuiAssert(queue->deque_count > 0);
 
-        if ((cache->y + height) > cache->y_max)
-        {
-            cache->y_max = cache->y + height;
-        }
+    if (!count) return;
 
-        CuiTextureOperation *texture_op = 0;
+    _cui_atomic_add(&task_group->completion_goal, count);
 
-        for (int32_t index = command_buffer->texture_operation_count - 1; index > 0; index -= 1)
-        {
-            CuiTextureOperation *op = command_buffer->texture_operations + index;
+    _cui_worker_thread_deque_push(queue->deques + _cui_worker_thread_index, task_group, (uint8_t *) data, data_stride, count);
 
-            if ((op->type == CUI_TEXTURE_OPERATION_UPDATE) && (op->texture_id == cache->texture_id))
-            {
-                texture_op = op;
-                break;
-            }
+    _cui_atomic_add(&queue->pending_count, count);
+
+    // NOTE: Sleeping threads increment 'sleeping_count' before they check 'pending_count'
+    // for the last time. So either they see the new entries or we see them here.
+    if (_cui_atomic_read(&queue->sleeping_count))
+    {
+#if CUI_PLATFORM_WINDOWS
+        uint32_t wake_count = cui_min_uint32(count, _cui_atomic_read(&queue->sleeping_count));
+
+        if (wake_count)
+        {
+            ReleaseSemaphore(queue->semaphore, wake_count, 0);
         }
+#else
+        pthread_mutex_lock(&queue->semaphore_mutex);
 
-        if (texture_op)
+        uint32_t wake_count = cui_min_uint32(count, queue->sleeping_count);
+
+        if (wake_count >= (queue->deque_count - 1))
         {
-            texture_op->payload.rect = cui_rect_get_union(texture_op->payload.rect, result);
+            pthread_cond_broadcast(&queue->semaphore_cond);
         }
         else
         {
-            texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
-
-            texture_op->type = CUI_TEXTURE_OPERATION_UPDATE;
-            texture_op->texture_id = cache->texture_id;
-            texture_op->payload.rect = result;
+            for (uint32_t index = 0; index < wake_count; index += 1)
+            {
+                pthread_cond_signal(&queue->semaphore_cond);
+            }
         }
+
+        pthread_mutex_unlock(&queue->semaphore_mutex);
+#endif
+    }
+}
+
+static inline void
+_cui_add_worker_thread_queue_entry(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group, void *data)
+{
+    _cui_add_worker_thread_queue_entries(queue, task_group, data, 0, 1);
+}
+
+// Helps with the remaining work of the group. Once there is nothing left to take, this spins
+// for a short while and then sleeps until the last task of the group has finished.
+static void
+_cui_complete_worker_thread_task_group(CuiWorkerThreadQueue *queue, CuiWorkerThreadTaskGroup *task_group)
+{
+    uint64_t wait_start = 0;
+    uint32_t spin_count = 0;
+
+    while (_cui_atomic_read(&task_group->completion_count) != task_group->completion_goal)
+    {
+        if (_cui_do_next_worker_thread_task_group_entry(queue, task_group))
+        {
+            if (!wait_start)
+            {
+                wait_start = cui_platform_get_performance_counter();
+            }
+
+            if (spin_count < _CUI_WORKER_THREAD_SPIN_COUNT)
+            {
+                spin_count += 1;
+                _cui_cpu_relax();
+            }
+            else
+            {
+                _cui_park_worker_thread_task_group(queue, task_group);
+            }
+        }
+        else if (wait_start)
+        {
+            task_group->wait_time += cui_platform_get_performance_counter() - wait_start;
+            wait_start = 0;
+            spin_count = 0;
+        }
+    }
+
+    if (wait_start)
+    {
+        task_group->wait_time += cui_platform_get_performance_counter() - wait_start;
+    }
+}
+
+static void
+_cui_command_buffer_allocate(CuiCommandBuffer *command_buffer)
+{
+    command_buffer->push_buffer_size = 0;
+    command_buffer->max_push_buffer_size = _CUI_INITIAL_PUSH_BUFFER_SIZE;
+    command_buffer->push_buffer = (uint8_t *) cui_platform_allocate(command_buffer->max_push_buffer_size);
+
+    command_buffer->first_block = 0;
+    command_buffer->current_block = 0;
+
+    command_buffer->index_buffer_count = 0;
+    command_buffer->max_index_buffer_count = _CUI_INITIAL_INDEX_BUFFER_COUNT;
+    command_buffer->index_buffer = (uint32_t *) cui_platform_allocate(command_buffer->max_index_buffer_count * sizeof(uint32_t));
+
+    command_buffer->texture_operation_count = 0;
+    command_buffer->max_texture_operation_count = _CUI_INITIAL_TEXTURE_OPERATION_COUNT;
+    command_buffer->texture_operations = (CuiTextureOperation *) cui_platform_allocate(command_buffer->max_texture_operation_count *
+                                                                                      sizeof(CuiTextureOperation));
+
+    command_buffer->push_buffer_high_water_mark = 0;
+    command_buffer->index_buffer_high_water_mark = 0;
+    command_buffer->texture_operation_high_water_mark = 0;
+}
+
+static void
+_cui_command_buffer_free_blocks(CuiCommandBuffer *command_buffer)
+{
+    CuiCommandBufferBlock *block = command_buffer->first_block;
+
+    while (block)
+    {
+        CuiCommandBufferBlock *next = block->next;
+        cui_platform_deallocate(block, CuiAlign(sizeof(CuiCommandBufferBlock), 16) + block->capacity);
+        block = next;
+    }
+
+    command_buffer->first_block = 0;
+    command_buffer->current_block = 0;
+}
+
+static void
+_cui_command_buffer_deallocate(CuiCommandBuffer *command_buffer)
+{
+    _cui_command_buffer_free_blocks(command_buffer);
+
+    cui_platform_deallocate(command_buffer->push_buffer, command_buffer->max_push_buffer_size);
+    cui_platform_deallocate(command_buffer->index_buffer, command_buffer->max_index_buffer_count * sizeof(uint32_t));
+    cui_platform_deallocate(command_buffer->texture_operations, command_buffer->max_texture_operation_count *
+                                                                sizeof(CuiTextureOperation));
+}
+
+static inline uint8_t *
+_cui_command_buffer_get_block_data(CuiCommandBufferBlock *block)
+{
+    return (uint8_t *) block + CuiAlign(sizeof(CuiCommandBufferBlock), 16);
+}
+
+// Merges the chained blocks into one push buffer. Offsets stay the same, but pointers
+// into the push buffer are invalid afterwards. Called by _cui_renderer_render().
+static void
+_cui_command_buffer_finish(CuiCommandBuffer *command_buffer)
+{
+    if (command_buffer->first_block)
+    {
+        uint32_t max_push_buffer_size = CuiAlign(command_buffer->push_buffer_size, CuiKiB(64));
+        uint8_t *push_buffer = (uint8_t *) cui_platform_allocate(max_push_buffer_size);
+
+        cui_copy_memory(push_buffer, command_buffer->push_buffer, command_buffer->first_block->offset);
+
+        for (CuiCommandBufferBlock *block = command_buffer->first_block; block; block = block->next)
+        {
+            uint32_t end = block->next ? block->next->offset : command_buffer->push_buffer_size;
+            cui_copy_memory(push_buffer + block->offset, _cui_command_buffer_get_block_data(block), end - block->offset);
+        }
+
+        _cui_command_buffer_free_blocks(command_buffer);
+
+        cui_platform_deallocate(command_buffer->push_buffer, command_buffer->max_push_buffer_size);
+
+        command_buffer->max_push_buffer_size = max_push_buffer_size;
+        command_buffer->push_buffer = push_buffer;
+    }
+
+    command_buffer->unmerged_index_buffer_count = command_buffer->index_buffer_count;
+
+    command_buffer->push_buffer_high_water_mark = cui_max_uint32(command_buffer->push_buffer_high_water_mark,
+                                                                 command_buffer->push_buffer_size);
+    command_buffer->index_buffer_high_water_mark = cui_max_uint32(command_buffer->index_buffer_high_water_mark,
+                                                                  command_buffer->index_buffer_count);
+    command_buffer->texture_operation_high_water_mark = cui_max_uint32(command_buffer->texture_operation_high_water_mark,
+                                                                       command_buffer->texture_operation_count);
+}
+
+#if CUI_PRIMITIVE_MERGING_ENABLED
+
+static const uint32_t _CUI_PRIMITIVE_MERGE_DISTANCE = 8;
+
+static inline bool
+_cui_textured_rects_overlap(CuiTexturedRect *a, CuiTexturedRect *b)
+{
+    return (a->x0 < b->x1) && (b->x0 < a->x1) && (a->y0 < b->y1) && (b->y0 < a->y1);
+}
+
+// Two texture coordinate ranges can be joined if they sample the same texels after joining.
+// That is the case if both are mapped 1:1 and continue each other, or if both are the same
+// range of at most one texel, which is stretched over the whole rect.
+static inline bool
+_cui_texture_ranges_can_join(int16_t a_min, int16_t a_max, int16_t a_t0, int16_t a_t1,
+                             int16_t b_min, int16_t b_max, int16_t b_t0, int16_t b_t1)
+{
+    if ((a_t0 == b_t0) && (a_t1 == b_t1) && ((a_t1 - a_t0) >= -1) && ((a_t1 - a_t0) <= 1))
+    {
+        return true;
+    }
+
+    return ((a_t1 - a_t0) == (a_max - a_min)) && ((b_t1 - b_t0) == (b_max - b_min)) && (a_t1 == b_t0);
+}
+
+static bool
+_cui_textured_rect_merge(CuiTexturedRect *a, CuiTexturedRect *b)
+{
+    if ((a->texture_id != b->texture_id) || (a->clip_rect != b->clip_rect) ||
+        (a->color.r != b->color.r) || (a->color.g != b->color.g) ||
+        (a->color.b != b->color.b) || (a->color.a != b->color.a))
+    {
+        return false;
+    }
+
+    if ((a->y0 == b->y0) && (a->y1 == b->y1) && (a->v0 == b->v0) && (a->v1 == b->v1))
+    {
+        if ((a->x1 == b->x0) && _cui_texture_ranges_can_join(a->x0, a->x1, a->u0, a->u1, b->x0, b->x1, b->u0, b->u1))
+        {
+            a->x1 = b->x1;
+            a->u1 = b->u1;
+            return true;
+        }
+
+        if ((b->x1 == a->x0) && _cui_texture_ranges_can_join(b->x0, b->x1, b->u0, b->u1, a->x0, a->x1, a->u0, a->u1))
+        {
+            a->x0 = b->x0;
+            a->u0 = b->u0;
+            return true;
+        }
+    }
+    else if ((a->x0 == b->x0) && (a->x1 == b->x1) && (a->u0 == b->u0) && (a->u1 == b->u1))
+    {
+        if ((a->y1 == b->y0) && _cui_texture_ranges_can_join(a->y0, a->y1, a->v0, a->v1, b->y0, b->y1, b->v0, b->v1))
+        {
+            a->y1 = b->y1;
+            a->v1 = b->v1;
+            return true;
+        }
+
+        if ((b->y1 == a->y0) && _cui_texture_ranges_can_join(b->y0, b->y1, b->v0, b->v1, a->y0, a->y1, a->v0, a->v1))
+        {
+            a->y0 = b->y0;
+            a->v0 = b->v0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Drops primitives that can't produce any pixels and merges primitives into one of the last
+// few primitives if they form a larger rectangle. A primitive is only moved in front of the
+// primitives it doesn't overlap with, so the result stays exactly the same.
+static void
+_cui_command_buffer_merge_primitives(CuiCommandBuffer *command_buffer)
+{
+    CuiAssert(!command_buffer->first_block);
+
+    uint8_t *push_buffer = command_buffer->push_buffer;
+    uint32_t *index_buffer = command_buffer->index_buffer;
+
+    uint32_t index_buffer_count = 0;
+
+    for (uint32_t index = 0; index < command_buffer->index_buffer_count; index += 1)
+    {
+        uint32_t offset = index_buffer[index];
+        CuiTexturedRect *textured_rect = (CuiTexturedRect *) (push_buffer + offset);
+
+        if ((textured_rect->x0 >= textured_rect->x1) || (textured_rect->y0 >= textured_rect->y1))
+        {
+            continue;
+        }
+
+        // NOTE: The colors are premultiplied, so this doesn't change the destination.
+        if ((textured_rect->color.r == 0.0f) && (textured_rect->color.g == 0.0f) &&
+            (textured_rect->color.b == 0.0f) && (textured_rect->color.a == 0.0f))
+        {
+            continue;
+        }
+
+        if (textured_rect->clip_rect)
+        {
+            CuiClipRect *clip_rect = (CuiClipRect *) (push_buffer + textured_rect->clip_rect - 1);
+
+            if ((textured_rect->x0 >= clip_rect->x_max) || (textured_rect->x1 <= clip_rect->x_min) ||
+                (textured_rect->y0 >= clip_rect->y_max) || (textured_rect->y1 <= clip_rect->y_min))
+            {
+                continue;
+            }
+        }
+
+        bool merged = false;
+
+        uint32_t min_index = (index_buffer_count > _CUI_PRIMITIVE_MERGE_DISTANCE) ? (index_buffer_count - _CUI_PRIMITIVE_MERGE_DISTANCE) : 0;
+
+        for (uint32_t prev_index = index_buffer_count; prev_index > min_index; prev_index -= 1)
+        {
+            CuiTexturedRect *prev_rect = (CuiTexturedRect *) (push_buffer + index_buffer[prev_index - 1]);
+
+            if (_cui_textured_rect_merge(prev_rect, textured_rect))
+            {
+                merged = true;
+                break;
+            }
+
+            if (_cui_textured_rects_overlap(prev_rect, textured_rect))
+            {
+                break;
+            }
+        }
+
+        if (!merged)
+        {
+            index_buffer[index_buffer_count] = offset;
+            index_buffer_count += 1;
+        }
+    }
+
+    command_buffer->index_buffer_count = index_buffer_count;
+}
+
+#endif
+
+static void
+_cui_command_buffer_reset(CuiCommandBuffer *command_buffer)
+{
+    // NOTE: This only happens if a frame was started but never rendered.
+    if (command_buffer->first_block)
+    {
+        _cui_command_buffer_finish(command_buffer);
+    }
+
+    command_buffer->push_buffer_size = 0;
+    command_buffer->index_buffer_count = 0;
+    command_buffer->texture_operation_count = 0;
+}
+
+static void *
+_cui_command_buffer_grow_push_buffer(CuiCommandBuffer *command_buffer, uint32_t size)
+{
+    CuiAssert(((uint64_t) command_buffer->push_buffer_size + (uint64_t) size) <= UINT32_MAX);
+
+    // Every block at least doubles the capacity.
+    uint32_t capacity = CuiAlign(cui_max_uint32(size, command_buffer->push_buffer_size), CuiKiB(64));
+
+    CuiCommandBufferBlock *block =
+        (CuiCommandBufferBlock *) cui_platform_allocate(CuiAlign(sizeof(CuiCommandBufferBlock), 16) + capacity);
+
+    block->next = 0;
+    block->offset = command_buffer->push_buffer_size;
+    block->capacity = capacity;
+
+    if (command_buffer->current_block)
+    {
+        command_buffer->current_block->next = block;
+    }
+    else
+    {
+        command_buffer->first_block = block;
+    }
+
+    command_buffer->current_block = block;
+
+    return _cui_command_buffer_get_block_data(block);
+}
+
+static CuiTextureOperation *
+_cui_command_buffer_add_texture_operation(CuiCommandBuffer *command_buffer)
+{
+    if (command_buffer->texture_operation_count == command_buffer->max_texture_operation_count)
+    {
+        uint32_t max_texture_operation_count = 2 * command_buffer->max_texture_operation_count;
+        CuiTextureOperation *texture_operations =
+            (CuiTextureOperation *) cui_platform_allocate(max_texture_operation_count * sizeof(CuiTextureOperation));
+
+        cui_copy_memory(texture_operations, command_buffer->texture_operations,
+                        command_buffer->texture_operation_count * sizeof(CuiTextureOperation));
+        cui_platform_deallocate(command_buffer->texture_operations, command_buffer->max_texture_operation_count *
+                                                                    sizeof(CuiTextureOperation));
+
+        command_buffer->max_texture_operation_count = max_texture_operation_count;
+        command_buffer->texture_operations = texture_operations;
+    }
+
+    CuiTextureOperation *texture_op = command_buffer->texture_operations +
+                                      command_buffer->texture_operation_count;
+    command_buffer->texture_operation_count += 1;
+
+    CuiClearStruct(*texture_op);
+
+    return texture_op;
+}
+
+static inline int64_t
+_cui_texture_update_get_area(CuiRect rect)
+{
+    return (int64_t) cui_rect_get_width(rect) * (int64_t) cui_rect_get_height(rect);
+}
+
+static void
+_cui_texture_update_add_rect(CuiTextureUpdate *update, CuiRect rect)
+{
+    for (;;)
+    {
+        int64_t rect_area = _cui_texture_update_get_area(rect);
+        int32_t merge_index = -1;
+
+        for (uint32_t index = 0; index < update->rect_count; index += 1)
+        {
+            CuiRect other = update->rects[index];
+            CuiRect intersection = cui_rect_get_intersection(rect, other);
+
+            // NOTE: Merging is cheaper than a separate upload as long as the bounding
+            // rect doesn't add more than a quarter of the area that changed.
+            int64_t separate_area = rect_area + _cui_texture_update_get_area(other);
+            int64_t union_area = _cui_texture_update_get_area(cui_rect_get_union(rect, other));
+
+            if (cui_rect_has_area(intersection) || ((4 * union_area) <= (5 * separate_area)))
+            {
+                merge_index = (int32_t) index;
+                break;
+            }
+        }
+
+        if (merge_index < 0)
+        {
+            if (update->rect_count < CuiArrayCount(update->rects))
+            {
+                update->rects[update->rect_count] = rect;
+                update->rect_count += 1;
+                return;
+            }
+
+            int64_t min_growth = INT64_MAX;
+
+            for (uint32_t index = 0; index < update->rect_count; index += 1)
+            {
+                CuiRect other = update->rects[index];
+                int64_t growth = _cui_texture_update_get_area(cui_rect_get_union(rect, other)) -
+                                 _cui_texture_update_get_area(other);
+
+                if (growth < min_growth)
+                {
+                    min_growth = growth;
+                    merge_index = (int32_t) index;
+                }
+            }
+        }
+
+        // The merged rect can overlap others, so it gets added again.
+        rect = cui_rect_get_union(rect, update->rects[merge_index]);
+
+        update->rect_count -= 1;
+        update->rects[merge_index] = update->rects[update->rect_count];
+    }
+}
+
+// Adds 'rect' to the pending update of 'texture_id', if there is one.
+static void
+_cui_command_buffer_update_texture(CuiCommandBuffer *command_buffer, uint32_t texture_id, CuiRect rect)
+{
+    CuiTextureOperation *texture_op = 0;
+
+    for (int32_t index = (int32_t) command_buffer->texture_operation_count - 1; index >= 0; index -= 1)
+    {
+        CuiTextureOperation *op = command_buffer->texture_operations + index;
+
+        // NOTE: An update must not move in front of an allocation of the same texture.
+        if (op->texture_id == texture_id)
+        {
+            if (op->type == CUI_TEXTURE_OPERATION_UPDATE)
+            {
+                texture_op = op;
+            }
+
+            break;
+        }
+    }
+
+    if (!texture_op)
+    {
+        texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+
+        texture_op->type = CUI_TEXTURE_OPERATION_UPDATE;
+        texture_op->texture_id = texture_id;
+        texture_op->payload.update.rect_count = 0;
+    }
+
+    _cui_texture_update_add_rect(&texture_op->payload.update, rect);
+}
+
+static inline void *
+_cui_command_buffer_push_primitive(CuiCommandBuffer *command_buffer, uint32_t size)
+{
+    void *result;
+
+    CuiCommandBufferBlock *block = command_buffer->current_block;
+
+    if (!block && ((command_buffer->push_buffer_size + size) <= command_buffer->max_push_buffer_size))
+    {
+        result = command_buffer->push_buffer + command_buffer->push_buffer_size;
+    }
+    else if (block && ((command_buffer->push_buffer_size + size) <= (block->offset + block->capacity)))
+    {
+        result = _cui_command_buffer_get_block_data(block) + (command_buffer->push_buffer_size - block->offset);
+    }
+    else
+    {
+        result = _cui_command_buffer_grow_push_buffer(command_buffer, size);
+    }
+
+    command_buffer->push_buffer_size += size;
+
+    return result;
+}
+
+static void
+_cui_command_buffer_grow_index_buffer(CuiCommandBuffer *command_buffer)
+{
+    uint32_t max_index_buffer_count = 2 * command_buffer->max_index_buffer_count;
+    uint32_t *index_buffer = (uint32_t *) cui_platform_allocate(max_index_buffer_count * sizeof(uint32_t));
+
+    cui_copy_memory(index_buffer, command_buffer->index_buffer, command_buffer->index_buffer_count * sizeof(uint32_t));
+    cui_platform_deallocate(command_buffer->index_buffer, command_buffer->max_index_buffer_count * sizeof(uint32_t));
+
+    command_buffer->max_index_buffer_count = max_index_buffer_count;
+    command_buffer->index_buffer = index_buffer;
+}
+
+static inline void
+_cui_command_buffer_push_index(CuiCommandBuffer *command_buffer, uint32_t offset)
+{
+    if (command_buffer->index_buffer_count == command_buffer->max_index_buffer_count)
+    {
+        _cui_command_buffer_grow_index_buffer(command_buffer);
+    }
+
+    command_buffer->index_buffer[command_buffer->index_buffer_count++] = offset;
+}
+
+static void
+_cui_command_buffer_read_push_buffer(CuiCommandBuffer *command_buffer, void *buffer, uint32_t offset, uint32_t size)
+{
+    CuiAssert(((uint64_t) offset + (uint64_t) size) <= command_buffer->push_buffer_size);
+
+    uint8_t *dst = (uint8_t *) buffer;
+    uint32_t end = offset + size;
+
+    uint32_t base_end = command_buffer->first_block ? command_buffer->first_block->offset : command_buffer->push_buffer_size;
+
+    if (offset < base_end)
+    {
+        uint32_t count = cui_min_uint32(end, base_end) - offset;
+        cui_copy_memory(dst, command_buffer->push_buffer + offset, count);
+
+        dst += count;
+        offset += count;
+    }
+
+    for (CuiCommandBufferBlock *block = command_buffer->first_block; block && (offset < end); block = block->next)
+    {
+        uint32_t block_end = block->next ? block->next->offset : command_buffer->push_buffer_size;
+
+        if (offset < block_end)
+        {
+            uint32_t count = cui_min_uint32(end, block_end) - offset;
+            cui_copy_memory(dst, _cui_command_buffer_get_block_data(block) + (offset - block->offset), count);
+
+            dst += count;
+            offset += count;
+        }
+    }
+}
+
+static CuiTexture *
+_cui_texture_table_allocate(CuiTextureTable *table, uint32_t texture_id, CuiTextureFormat format, CuiBitmap bitmap, uint64_t memory_size)
+{
+    uint32_t index = _cui_texture_id_get_index(texture_id);
+
+    if (index >= table->allocated)
+    {
+        uint32_t allocated = cui_max_uint32(2 * table->allocated, CUI_MAX_TEXTURE_COUNT);
+
+        while (allocated <= index)
+        {
+            allocated *= 2;
+        }
+
+        CuiTexture *textures = (CuiTexture *) cui_platform_allocate(allocated * sizeof(CuiTexture));
+
+        if (table->textures)
+        {
+            cui_copy_memory(textures, table->textures, table->allocated * sizeof(CuiTexture));
+            cui_platform_deallocate(table->textures, table->allocated * sizeof(CuiTexture));
+        }
+
+        table->allocated = allocated;
+        table->textures = textures;
+    }
+
+    CuiTexture *texture = table->textures + index;
+
+    CuiAssert(!texture->texture_id);
+
+    texture->texture_id = texture_id;
+    texture->backend_texture = 0;
+    texture->memory_size = memory_size;
+    texture->format = format;
+    texture->bitmap = bitmap;
+
+    table->texture_count += 1;
+    table->memory_size += memory_size;
+
+    if (table->memory_size > table->max_memory_size)
+    {
+        table->max_memory_size = table->memory_size;
+    }
+
+    return texture;
+}
+
+// Using an id after the texture was deallocated is a bug in the application.
+static inline CuiTexture *
+_cui_texture_table_get(CuiTextureTable *table, uint32_t texture_id)
+{
+    uint32_t index = _cui_texture_id_get_index(texture_id);
+
+    CuiAssert(index < table->allocated);
+    CuiAssert(table->textures[index].texture_id == texture_id);
+
+    return table->textures + index;
+}
+
+static void
+_cui_texture_table_deallocate(CuiTextureTable *table, uint32_t texture_id)
+{
+    CuiTexture *texture = _cui_texture_table_get(table, texture_id);
+
+    table->texture_count -= 1;
+    table->memory_size -= texture->memory_size;
+
+    CuiClearStruct(*texture);
+}
+
+static void
+_cui_texture_table_destroy(CuiTextureTable *table)
+{
+    if (table->textures)
+    {
+        cui_platform_deallocate(table->textures, table->allocated * sizeof(CuiTexture));
+    }
+
+    CuiClearStruct(*table);
+}
+
+#if CUI_RENDERER_METAL_ENABLED || CUI_RENDERER_DIRECT3D11_ENABLED
+
+// Expands the coverage of 'rect' in the A8 bitmap 'src' to premultiplied white, for renderers
+// that only sample BGRA textures. The rect is written tightly packed to 'dst'.
+static void
+_cui_texture_expand_a8_to_bgra(uint32_t *dst, CuiBitmap src, CuiRect rect)
+{
+    uint8_t *row = (uint8_t *) src.pixels + (rect.min.y * src.stride) + rect.min.x;
+
+    for (int32_t y = rect.min.y; y < rect.max.y; y += 1)
+    {
+        for (int32_t x = 0; x < cui_rect_get_width(rect); x += 1)
+        {
+            *dst++ = 0x01010101 * (uint32_t) row[x];
+        }
+
+        row += src.stride;
+    }
+}
+
+#endif
+
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+
+// Returns the texture in slot 'index' after the texture operations of 'command_buffer'
+// were applied to 'texture_table', which holds the textures of the previous frame.
+static CuiTexture
+_cui_command_buffer_get_capture_texture(CuiCommandBuffer *command_buffer, CuiTextureTable *texture_table, uint32_t index)
+{
+    CuiTexture texture = { 0 };
+
+    if (index < texture_table->allocated)
+    {
+        texture = texture_table->textures[index];
+    }
+
+    for (uint32_t op_index = 0; op_index < command_buffer->texture_operation_count; op_index += 1)
+    {
+        CuiTextureOperation *texture_op = command_buffer->texture_operations + op_index;
+
+        if (_cui_texture_id_get_index(texture_op->texture_id) == index)
+        {
+            switch (texture_op->type)
+            {
+                case CUI_TEXTURE_OPERATION_ALLOCATE:
+                {
+                    texture.texture_id = texture_op->texture_id;
+                    texture.format = (CuiTextureFormat) texture_op->format;
+                    texture.bitmap = texture_op->payload.bitmap;
+                } break;
+
+                case CUI_TEXTURE_OPERATION_DEALLOCATE:
+                {
+                    CuiClearStruct(texture);
+                } break;
+
+                case CUI_TEXTURE_OPERATION_UPDATE:
+                {
+                } break;
+            }
+        }
+    }
+
+    return texture;
+}
+
+static uint32_t
+_cui_command_buffer_get_capture_texture_slot_count(CuiCommandBuffer *command_buffer, CuiTextureTable *texture_table)
+{
+    uint32_t slot_count = texture_table->allocated;
+
+    for (uint32_t index = 0; index < command_buffer->texture_operation_count; index += 1)
+    {
+        slot_count = cui_max_uint32(slot_count, _cui_texture_id_get_index(command_buffer->texture_operations[index].texture_id) + 1);
+    }
+
+    return slot_count;
+}
+
+static uint64_t
+_cui_command_buffer_get_capture_size(CuiCommandBuffer *command_buffer, CuiTextureTable *texture_table)
+{
+    uint64_t size = sizeof(CuiCommandBufferCaptureHeader) + command_buffer->push_buffer_size +
+                    command_buffer->index_buffer_count * sizeof(uint32_t) +
+                    command_buffer->texture_operation_count * sizeof(CuiCommandBufferCaptureTextureOperation);
+
+    uint32_t slot_count = _cui_command_buffer_get_capture_texture_slot_count(command_buffer, texture_table);
+
+    for (uint32_t index = 0; index < slot_count; index += 1)
+    {
+        CuiTexture texture = _cui_command_buffer_get_capture_texture(command_buffer, texture_table, index);
+
+        if (texture.texture_id)
+        {
+            size += sizeof(CuiCommandBufferCaptureTexture) + (uint64_t) _cui_texture_format_get_bytes_per_pixel(texture.format) *
+                                                             (uint64_t) texture.bitmap.width * (uint64_t) texture.bitmap.height;
+        }
+    }
+
+    return size;
+}
+
+// Serializes the command buffer and every texture it can reference, so that the frame
+// can be rendered again without the application. See CuiCommandBufferCaptureHeader.
+static CuiString
+_cui_command_buffer_encode_capture(CuiCommandBuffer *command_buffer, CuiTextureTable *texture_table, int32_t width, int32_t height,
+                                   CuiColor clear_color, CuiArena *arena)
+{
+    CuiString result = { 0 };
+
+    uint64_t size = _cui_command_buffer_get_capture_size(command_buffer, texture_table);
+    uint8_t *data = (uint8_t *) cui_alloc(arena, size, CuiDefaultAllocationParams());
+
+    if (!data)
+    {
+        return result;
+    }
+
+    result.count = size;
+    result.data = data;
+
+    CuiCommandBufferCaptureHeader *header = (CuiCommandBufferCaptureHeader *) data;
+    data += sizeof(CuiCommandBufferCaptureHeader);
+
+    header->magic = CUI_COMMAND_BUFFER_CAPTURE_MAGIC;
+    header->version = CUI_COMMAND_BUFFER_CAPTURE_VERSION;
+    header->width = width;
+    header->height = height;
+    header->clear_color = clear_color;
+    header->push_buffer_size = command_buffer->push_buffer_size;
+    header->index_buffer_count = command_buffer->index_buffer_count;
+    header->texture_operation_count = command_buffer->texture_operation_count;
+    header->texture_count = 0;
+
+    _cui_command_buffer_read_push_buffer(command_buffer, data, 0, command_buffer->push_buffer_size);
+    data += command_buffer->push_buffer_size;
+
+    cui_copy_memory(data, command_buffer->index_buffer, command_buffer->index_buffer_count * sizeof(uint32_t));
+    data += command_buffer->index_buffer_count * sizeof(uint32_t);
+
+    for (uint32_t index = 0; index < command_buffer->texture_operation_count; index += 1)
+    {
+        CuiTextureOperation *texture_op = command_buffer->texture_operations + index;
+        CuiCommandBufferCaptureTextureOperation *capture_op = (CuiCommandBufferCaptureTextureOperation *) data;
+        data += sizeof(CuiCommandBufferCaptureTextureOperation);
+
+        CuiClearStruct(*capture_op);
+
+        capture_op->type = texture_op->type;
+        capture_op->texture_id = texture_op->texture_id;
+
+        if (texture_op->type == CUI_TEXTURE_OPERATION_UPDATE)
+        {
+            capture_op->rect_count = (uint16_t) texture_op->payload.update.rect_count;
+
+            for (uint32_t rect_index = 0; rect_index < texture_op->payload.update.rect_count; rect_index += 1)
+            {
+                capture_op->rects[rect_index] = texture_op->payload.update.rects[rect_index];
+            }
+        }
+    }
+
+    uint32_t slot_count = _cui_command_buffer_get_capture_texture_slot_count(command_buffer, texture_table);
+
+    for (uint32_t index = 0; index < slot_count; index += 1)
+    {
+        CuiTexture texture = _cui_command_buffer_get_capture_texture(command_buffer, texture_table, index);
+
+        if (texture.texture_id)
+        {
+            CuiCommandBufferCaptureTexture *capture_texture = (CuiCommandBufferCaptureTexture *) data;
+            data += sizeof(CuiCommandBufferCaptureTexture);
+
+            capture_texture->texture_id = texture.texture_id;
+            capture_texture->format = texture.format;
+            capture_texture->width = texture.bitmap.width;
+            capture_texture->height = texture.bitmap.height;
+
+            uint8_t *row = (uint8_t *) texture.bitmap.pixels;
+            int32_t row_size = _cui_texture_format_get_bytes_per_pixel(texture.format) * texture.bitmap.width;
+
+            for (int32_t y = 0; y < texture.bitmap.height; y += 1)
+            {
+                cui_copy_memory(data, row, row_size);
+                data += row_size;
+                row += texture.bitmap.stride;
+            }
+
+            header->texture_count += 1;
+        }
+    }
+
+    CuiAssert(data == (result.data + result.count));
+
+    return result;
+}
+
+#endif
+
+static inline uint32_t
+_cui_command_buffer_push_clip_rect(CuiCommandBuffer *command_buffer, CuiRect rect)
+{
+    uint32_t offset = command_buffer->push_buffer_size + 1;
+
+    CuiAssert((rect.min.x >= INT16_MIN) && (rect.min.x <= INT16_MAX));
+    CuiAssert((rect.min.y >= INT16_MIN) && (rect.min.y <= INT16_MAX));
+    CuiAssert((rect.max.x >= INT16_MIN) && (rect.max.x <= INT16_MAX));
+    CuiAssert((rect.max.y >= INT16_MIN) && (rect.max.y <= INT16_MAX));
+
+    CuiClipRect *clip_rect = (CuiClipRect *) _cui_command_buffer_push_primitive(command_buffer, sizeof(CuiClipRect));
+
+    clip_rect->x_min = (int16_t) rect.min.x;
+    clip_rect->y_min = (int16_t) rect.min.y;
+    clip_rect->x_max = (int16_t) rect.max.x;
+    clip_rect->y_max = (int16_t) rect.max.y;
+
+    return offset;
+}
+
+static inline uint32_t
+_cui_float_get_bits(float value)
+{
+    uint32_t bits;
+    cui_copy_memory(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// The hash is stored next to every entry and compared before the keys, so it must never be 0,
+// because that marks an empty bucket. Adding 0.0f maps -0.0f to 0.0f, they compare equal.
+static inline uint32_t
+_cui_glyph_key_hash(CuiGlyphKey *key)
+{
+    uint64_t hash = _cui_hash_mix_u64(0, ((uint64_t) key->id << 32) | key->codepoint);
+    hash = _cui_hash_mix_u64(hash, ((uint64_t) _cui_float_get_bits(key->scale + 0.0f) << 32) | _cui_float_get_bits(key->offset_x + 0.0f));
+    hash = _cui_hash_mix_u64(hash, ((uint64_t) key->coverage_mode << 32) | _cui_float_get_bits(key->offset_y + 0.0f));
+
+    uint32_t result = (uint32_t) (hash >> 32);
+
+    return result ? result : 1;
+}
+
+// Returns the area of the plot that lies below its skyline.
+static inline int32_t
+_cui_glyph_plot_get_used_area(CuiGlyphPlot *plot)
+{
+    int32_t used_area = 0;
+
+    for (uint32_t index = 0; index < plot->node_count; index += 1)
+    {
+        used_area += (int32_t) plot->nodes[index].width * (int32_t) plot->nodes[index].y;
+    }
+
+    return used_area;
+}
+
+static inline int64_t
+_cui_glyph_cache_get_used_area(CuiGlyphCache *cache)
+{
+    int64_t used_area = 0;
+
+    for (uint32_t index = 0; index < cache->plot_count; index += 1)
+    {
+        used_area += _cui_glyph_plot_get_used_area(cache->plots + index);
+    }
+
+    return used_area;
+}
+
+static inline bool
+_cui_glyph_cache_is_filled(CuiGlyphCache *cache, float max_hash_map_fill_rate, float max_texture_fill_rate)
+{
+    float hash_map_fill_rate = (float) cache->count / (float) cache->allocated;
+    float texture_fill_rate = (float) _cui_glyph_cache_get_used_area(cache) /
+                              ((float) cache->texture.width * (float) cache->texture.height);
+
+    return (hash_map_fill_rate > max_hash_map_fill_rate) || (texture_fill_rate > max_texture_fill_rate);
+}
+
+// Returns the index of the plot that contains 'position'.
+static inline uint32_t
+_cui_glyph_cache_get_plot_index(CuiGlyphCache *cache, CuiPoint position)
+{
+    return (uint32_t) (((position.y / cache->plot_height) * cache->plot_count_x) + (position.x / cache->plot_width));
+}
+
+// Returns the row at which a rect of 'width' x 'height' fits on top of
+// the skyline, if it starts at the node 'node_index', or -1 if it doesn't fit.
+static int32_t
+_cui_glyph_plot_fit(CuiGlyphCache *cache, CuiGlyphPlot *plot, uint32_t node_index, int32_t width, int32_t height)
+{
+    if ((plot->nodes[node_index].x + width) > cache->plot_width)
+    {
+        return -1;
+    }
+
+    int32_t y = 0;
+    int32_t remaining_width = width;
+
+    while (remaining_width > 0)
+    {
+        CuiAssert(node_index < plot->node_count);
+
+        CuiGlyphSkylineNode *node = plot->nodes + node_index;
+
+        y = cui_max_int32(y, node->y);
+
+        if ((y + height) > cache->plot_height)
+        {
+            return -1;
+        }
+
+        remaining_width -= node->width;
+        node_index += 1;
+    }
+
+    return y;
+}
+
+// Places the rect where its top edge ends up the lowest, ties are broken by
+// the narrower node. The position is relative to the top left of the plot.
+static bool
+_cui_glyph_plot_allocate(CuiGlyphCache *cache, CuiGlyphPlot *plot, int32_t width, int32_t height, CuiPoint *position)
+{
+    uint32_t best_index = plot->node_count;
+    int32_t best_y = 0;
+
+    for (uint32_t index = 0; index < plot->node_count; index += 1)
+    {
+        int32_t y = _cui_glyph_plot_fit(cache, plot, index, width, height);
+
+        if ((y >= 0) &&
+            ((best_index == plot->node_count) || (y < best_y) ||
+             ((y == best_y) && (plot->nodes[index].width < plot->nodes[best_index].width))))
+        {
+            best_index = index;
+            best_y = y;
+        }
+    }
+
+    if (best_index == plot->node_count)
+    {
+        return false;
+    }
+
+    CuiGlyphSkylineNode *nodes = plot->nodes;
+
+    int32_t x = nodes[best_index].x;
+    int32_t end_x = x + width;
+
+    // The nodes that are covered by the new one are removed, a partially covered node is shortened.
+    uint32_t next_index = best_index;
+
+    while ((next_index < plot->node_count) && ((nodes[next_index].x + nodes[next_index].width) <= end_x))
+    {
+        next_index += 1;
+    }
+
+    if ((next_index < plot->node_count) && (nodes[next_index].x < end_x))
+    {
+        nodes[next_index].width = (int16_t) (nodes[next_index].x + nodes[next_index].width - end_x);
+        nodes[next_index].x = (int16_t) end_x;
+    }
+
+    uint32_t removed_count = next_index - best_index;
+
+    if (removed_count == 0)
+    {
+        for (uint32_t index = plot->node_count; index > best_index; index -= 1)
+        {
+            nodes[index] = nodes[index - 1];
+        }
+
+        plot->node_count += 1;
+    }
+    else if (removed_count > 1)
+    {
+        for (uint32_t index = next_index; index < plot->node_count; index += 1)
+        {
+            nodes[index - removed_count + 1] = nodes[index];
+        }
+
+        plot->node_count -= removed_count - 1;
+    }
+
+    nodes[best_index].x = (int16_t) x;
+    nodes[best_index].y = (int16_t) (best_y + height);
+    nodes[best_index].width = (int16_t) width;
+
+    // Neighbouring nodes at the same height are merged.
+    uint32_t node_count = 1;
+
+    for (uint32_t index = 1; index < plot->node_count; index += 1)
+    {
+        if (nodes[index].y == nodes[node_count - 1].y)
+        {
+            nodes[node_count - 1].width += nodes[index].width;
+        }
+        else
+        {
+            nodes[node_count] = nodes[index];
+            node_count += 1;
+        }
+    }
+
+    plot->node_count = node_count;
+
+    position->x = x;
+    position->y = best_y;
+
+    return true;
+}
+
+static void
+_cui_glyph_cache_reset_plot(CuiGlyphCache *cache, CuiGlyphPlot *plot)
+{
+    if (plot->span_x || plot->span_y)
+    {
+        for (int32_t y = 0; y < plot->span_y; y += 1)
+        {
+            for (int32_t x = 0; x < plot->span_x; x += 1)
+            {
+                CuiGlyphPlot *covered_plot = plot + (y * cache->plot_count_x) + x;
+
+                if (covered_plot != plot)
+                {
+                    _cui_glyph_cache_reset_plot(cache, covered_plot);
+                }
+            }
+        }
+
+        plot->span_x = 0;
+        plot->span_y = 0;
+    }
+
+    plot->node_count = 1;
+    plot->last_replayed_frame = 0;
+    plot->nodes[0].x = 0;
+    plot->nodes[0].y = 0;
+    plot->nodes[0].width = (int16_t) cache->plot_width;
+
+    int32_t bytes_per_pixel = _cui_texture_format_get_bytes_per_pixel(cache->texture_format);
+
+    // NOTE: The plot is cleared as if it had 4 byte pixels, that works for every format.
+    CuiBitmap bitmap = cache->texture;
+    bitmap.width = (cache->plot_width * bytes_per_pixel) / 4;
+    bitmap.height = cache->plot_height;
+    bitmap.pixels = (uint8_t *) cache->texture.pixels + (plot->y * cache->texture.stride) + (plot->x * bytes_per_pixel);
+
+    cui_bitmap_clear(&bitmap, cui_make_color(0.0f, 0.0f, 0.0f, 0.0f));
+
+    // NOTE: The white pixel at (0, 0) is used for untextured rects.
+    if (!plot->x && !plot->y)
+    {
+        CuiPoint position;
+
+        _cui_glyph_plot_allocate(cache, plot, 1, 1, &position);
+        CuiAssert(!position.x && !position.y);
+
+        if (cache->texture_format == CUI_TEXTURE_FORMAT_A8)
+        {
+            *(uint8_t *) cache->texture.pixels = 0xFF;
+        }
+        else
+        {
+            *(uint32_t *) cache->texture.pixels = 0xFFFFFFFF;
+        }
+    }
+}
+
+// Adds 'rect' to the update of the bound texture. The other window textures get it with their next frame.
+static void
+_cui_glyph_cache_update_texture(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer, CuiRect rect)
+{
+    _cui_command_buffer_update_texture(command_buffer, (uint32_t) cache->texture_id, rect);
+
+    for (uint32_t index = 0; index < cache->window_texture_count; index += 1)
+    {
+        CuiGlyphCacheTexture *texture = cache->window_textures[index];
+
+        if ((texture != cache->bound_texture) && texture->is_allocated)
+        {
+            _cui_texture_update_add_rect(&texture->update, rect);
+        }
+    }
+}
+
+static void
+_cui_glyph_cache_reset(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer)
+{
+    cache->count = 0;
+    cache->insertion_failure_count = 0;
+    cache->generation += 1;
+
+    for (uint32_t index = 0; index < cache->allocated; index++)
+    {
+        cache->hashes[index] = 0;
+    }
+
+    for (uint32_t index = 0; index < cache->plot_count; index += 1)
+    {
+        _cui_glyph_cache_reset_plot(cache, cache->plots + index);
+    }
+
+    // TODO: remove all texture updates from the command buffer
+
+    _cui_glyph_cache_update_texture(cache, command_buffer, cui_make_rect(0, 0, 1, 1));
+}
+
+static void
+_cui_glyph_cache_put_entry(CuiGlyphCache *cache, uint32_t hash, CuiGlyphKey key, CuiRect rect, uint32_t last_used_frame)
+{
+    CuiAssert((cache->allocated > 0) && !((cache->allocated - 1) & cache->allocated));
+
+    uint32_t mask = cache->allocated - 1;
+    uint32_t bucket = hash & mask;
+
+    // NOTE: Triangular probing visits every bucket of a power of two sized table.
+    uint32_t probe_increment = 1;
+
+    cache->count += 1;
+
+    for (;;)
+    {
+        if (!cache->hashes[bucket])
+        {
+            cache->hashes[bucket] = hash;
+            cache->keys[bucket] = key;
+            cache->rects[bucket] = rect;
+            cache->last_used_frames[bucket] = last_used_frame;
+            return;
+        }
+
+        bucket = (bucket + probe_increment) & mask;
+        probe_increment += 1;
+    }
+}
+
+// Marks the plots that 'textured_rect' samples from as used by a replayed retained drawing.
+static inline void
+_cui_glyph_cache_mark_replayed(CuiGlyphCache *cache, CuiTexturedRect *textured_rect)
+{
+    if (cache->plots && (textured_rect->texture_id == (uint32_t) cache->texture_id))
+    {
+        int32_t u_min = cui_min_int32(textured_rect->u0, textured_rect->u1);
+        int32_t v_min = cui_min_int32(textured_rect->v0, textured_rect->v1);
+        int32_t u_max = cui_max_int32(textured_rect->u0, textured_rect->u1);
+        int32_t v_max = cui_max_int32(textured_rect->v0, textured_rect->v1);
+
+        u_max = cui_max_int32(u_min, cui_min_int32(u_max, cache->texture.width) - 1);
+        v_max = cui_max_int32(v_min, cui_min_int32(v_max, cache->texture.height) - 1);
+
+        for (int32_t y = v_min / cache->plot_height; y <= (v_max / cache->plot_height); y += 1)
+        {
+            for (int32_t x = u_min / cache->plot_width; x <= (u_max / cache->plot_width); x += 1)
+            {
+                uint32_t plot_index = (uint32_t) ((y * cache->plot_count_x) + x);
+
+                if ((x < cache->plot_count_x) && (plot_index < cache->plot_count))
+                {
+                    cache->plots[plot_index].last_replayed_frame = cache->frame;
+                }
+            }
+        }
+    }
+}
+
+// Evicts the least recently used plots, once the hash map or the texture are getting full.
+// Plots with the fewest glyphs that were used during the last frames go first, the time of
+// their last use breaks ties. That way a frame with a lot of new text doesn't have to rasterize
+// everything that is visible again. Only if nothing can be evicted, the whole cache is reset.
+static void
+_cui_glyph_cache_maybe_evict(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer)
+{
+    cache->frame += 1;
+
+#if CUI_GLYPH_CACHE_STATISTICS_ENABLED
+    if (!(cache->frame % 300) && cache->lookup_count)
+    {
+        printf("glyph cache:  entries=%u/%u  lookups=%llu  hit rate=%f\n", cache->count, cache->allocated,
+               (unsigned long long) cache->lookup_count, (double) cache->hit_count / (double) cache->lookup_count);
+        printf("glyph cache probes:  avg=%f  max=%u  key compares per lookup=%f\n",
+               (double) cache->probe_count / (double) cache->lookup_count, cache->max_probe_length,
+               (double) cache->key_compare_count / (double) cache->lookup_count);
+
+        cache->lookup_count = 0;
+        cache->hit_count = 0;
+        cache->probe_count = 0;
+        cache->key_compare_count = 0;
+        cache->max_probe_length = 0;
+    }
+#endif
+
+    if (!cache->insertion_failure_count && !_cui_glyph_cache_is_filled(cache, 0.75f, 0.8f))
+    {
+        return;
+    }
+
+    for (uint32_t index = 0; index < cache->plot_count; index += 1)
+    {
+        cache->plots[index].last_used_frame = 0;
+        cache->plots[index].entry_count = 0;
+        cache->plots[index].recent_entry_count = 0;
+    }
+
+    for (uint32_t index = 0; index < cache->allocated; index += 1)
+    {
+        if (cache->hashes[index] && cui_rect_has_area(cache->rects[index]))
+        {
+            CuiGlyphPlot *plot = cache->plots + _cui_glyph_cache_get_plot_index(cache, cache->rects[index].min);
+
+            plot->last_used_frame = cui_max_uint32(plot->last_used_frame, cache->last_used_frames[index]);
+            plot->entry_count += 1;
+
+            if ((cache->last_used_frames[index] + CUI_GLYPH_CACHE_RECENT_FRAME_COUNT) >= cache->frame)
+            {
+                plot->recent_entry_count += 1;
+            }
+        }
+    }
+
+    // NOTE: Replayed retained drawings don't look up their glyphs, so it is unknown which glyphs
+    // of such a plot are still visible. All of them count as recently used in that case.
+    for (uint32_t index = 0; index < cache->plot_count; index += 1)
+    {
+        CuiGlyphPlot *plot = cache->plots + index;
+
+        if (plot->last_replayed_frame && ((plot->last_replayed_frame + CUI_GLYPH_CACHE_RECENT_FRAME_COUNT) >= cache->frame))
+        {
+            plot->last_used_frame = cui_max_uint32(plot->last_used_frame, plot->last_replayed_frame);
+            plot->recent_entry_count = plot->entry_count;
+        }
+    }
+
+    uint32_t count = cache->count;
+    int64_t used_area = _cui_glyph_cache_get_used_area(cache);
+
+    int64_t max_used_area = (int64_t) (0.65f * (float) cache->texture.width * (float) cache->texture.height);
+    uint32_t max_count = (uint32_t) (0.6f * (float) cache->allocated);
+
+    uint32_t evicted_plot_count = 0;
+
+    while ((count > max_count) || (used_area > max_used_area) || cache->insertion_failure_count)
+    {
+        CuiGlyphPlot *evicted_plot = 0;
+
+        for (uint32_t index = 0; index < cache->plot_count; index += 1)
+        {
+            CuiGlyphPlot *plot = cache->plots + index;
+
+            if ((plot->entry_count > 0) &&
+                (!evicted_plot || (plot->recent_entry_count < evicted_plot->recent_entry_count) ||
+                 ((plot->recent_entry_count == evicted_plot->recent_entry_count) &&
+                  (plot->last_used_frame < evicted_plot->last_used_frame))))
+            {
+                evicted_plot = plot;
+            }
+        }
+
+        if (!evicted_plot)
+        {
+            break;
+        }
+
+        count -= evicted_plot->entry_count;
+
+        // NOTE: This also frees the plots that are covered by a large allocation of the evicted plot.
+        _cui_glyph_cache_reset_plot(cache, evicted_plot);
+
+        used_area = _cui_glyph_cache_get_used_area(cache);
+
+        evicted_plot->entry_count = 0;
+
+        evicted_plot_count += 1;
+
+        // NOTE: One plot is enough to retry failed insertions in the next frame.
+        cache->insertion_failure_count = 0;
+    }
+
+    if (!evicted_plot_count)
+    {
+        _cui_glyph_cache_reset(cache, command_buffer);
+        return;
+    }
+
+    // The hash map is rebuilt with the glyphs of the remaining plots. Glyphs without an
+    // area are dropped as well, because failed insertions are stored that way.
+    uint64_t entry_size = sizeof(uint32_t) + sizeof(CuiGlyphKey) + sizeof(CuiRect) + sizeof(uint32_t);
+    uint64_t scratch_size = cui_max_uint32(count, 1) * entry_size;
+    uint8_t *scratch = (uint8_t *) cui_platform_allocate(scratch_size);
+
+    uint32_t *hashes = (uint32_t *) scratch;
+    CuiGlyphKey *keys = (CuiGlyphKey *) (hashes + count);
+    CuiRect *rects = (CuiRect *) (keys + count);
+    uint32_t *last_used_frames = (uint32_t *) (rects + count);
+
+    uint32_t kept_count = 0;
+
+    for (uint32_t index = 0; index < cache->allocated; index += 1)
+    {
+        if (cache->hashes[index])
+        {
+            CuiRect rect = cache->rects[index];
+
+            if (cui_rect_has_area(rect) && cache->plots[_cui_glyph_cache_get_plot_index(cache, rect.min)].entry_count)
+            {
+                CuiAssert(kept_count < count);
+
+                hashes[kept_count] = cache->hashes[index];
+                keys[kept_count] = cache->keys[index];
+                rects[kept_count] = rect;
+                last_used_frames[kept_count] = cache->last_used_frames[index];
+                kept_count += 1;
+            }
+
+            cache->hashes[index] = 0;
+        }
+    }
+
+    cache->count = 0;
+
+    for (uint32_t index = 0; index < kept_count; index += 1)
+    {
+        _cui_glyph_cache_put_entry(cache, hashes[index], keys[index], rects[index], last_used_frames[index]);
+    }
+
+    cui_platform_deallocate(scratch, scratch_size);
+
+    cache->generation += 1;
+
+    if (_cui_glyph_cache_is_filled(cache, 0.75f, 0.8f))
+    {
+        _cui_glyph_cache_reset(cache, command_buffer);
+    }
+}
+
+static void
+_cui_glyph_cache_initialize(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer, int32_t texture_id,
+                            CuiTextureFormat texture_format, int32_t texture_size)
+{
+    cache->texture_id = texture_id;
+    cache->texture_format = texture_format;
+
+    // One entry for every 32x32 pixels of the texture.
+    cache->allocated = (uint32_t) ((texture_size / 32) * (texture_size / 32));
+
+    cache->texture.width  = cui_min_int32(texture_size, command_buffer->max_texture_width);
+    cache->texture.height = cui_min_int32(texture_size, command_buffer->max_texture_height);
+    cache->texture.stride = CuiAlign(cache->texture.width * _cui_texture_format_get_bytes_per_pixel(texture_format), 16);
+
+    // NOTE: Plots start at a multiple of 16 pixels, so that they can be cleared with aligned stores.
+    int32_t plot_count_y = cui_max_int32(1, cache->texture.height / CUI_GLYPH_CACHE_PLOT_SIZE);
+
+    cache->plot_count_x = cui_max_int32(1, cache->texture.width / CUI_GLYPH_CACHE_PLOT_SIZE);
+    cache->plot_count = (uint32_t) (cache->plot_count_x * plot_count_y);
+    cache->plot_width = (cache->texture.width / cache->plot_count_x) & ~15;
+    cache->plot_height = cache->texture.height / plot_count_y;
+
+    // Every skyline node is at least one pixel wide, one more is needed while inserting.
+    uint32_t max_node_count = (uint32_t) cache->plot_width + 1;
+
+    uint64_t hashes_size  = CuiAlign(cache->allocated * sizeof(uint32_t), 16);
+    uint64_t keys_size    = CuiAlign(cache->allocated * sizeof(CuiGlyphKey), 16);
+    uint64_t rects_size   = CuiAlign(cache->allocated * sizeof(CuiRect), 16);
+    uint64_t frames_size  = CuiAlign(cache->allocated * sizeof(uint32_t), 16);
+    uint64_t plots_size   = CuiAlign(cache->plot_count * sizeof(CuiGlyphPlot), 16);
+    uint64_t nodes_size   = CuiAlign(cache->plot_count * max_node_count * sizeof(CuiGlyphSkylineNode), 16);
+    uint64_t pixels_size  = (uint64_t) cache->texture.stride * (uint64_t) cache->texture.height;
+
+    cache->allocation_size = hashes_size + keys_size + rects_size + frames_size + plots_size + nodes_size + pixels_size;
+
+    uint8_t *allocation = (uint8_t *) cui_platform_allocate(cache->allocation_size);
+
+    cache->hashes = (uint32_t *) allocation;
+    allocation += hashes_size;
+
+    cache->keys = (CuiGlyphKey *) allocation;
+    allocation += keys_size;
+
+    cache->rects = (CuiRect *) allocation;
+    allocation += rects_size;
+
+    cache->last_used_frames = (uint32_t *) allocation;
+    allocation += frames_size;
+
+    cache->plots = (CuiGlyphPlot *) allocation;
+    allocation += plots_size;
+
+    CuiGlyphSkylineNode *nodes = (CuiGlyphSkylineNode *) allocation;
+    allocation += nodes_size;
+
+    cache->texture.pixels = allocation;
+
+    for (uint32_t index = 0; index < cache->plot_count; index += 1)
+    {
+        CuiGlyphPlot *plot = cache->plots + index;
+
+        plot->x = ((int32_t) index % cache->plot_count_x) * cache->plot_width;
+        plot->y = ((int32_t) index / cache->plot_count_x) * cache->plot_height;
+        plot->nodes = nodes + (index * max_node_count);
+    }
+
+    CuiTextureOperation *texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+
+    texture_op->type = CUI_TEXTURE_OPERATION_ALLOCATE;
+    texture_op->format = (uint16_t) cache->texture_format;
+    texture_op->texture_id = cache->texture_id;
+    texture_op->payload.bitmap = cache->texture;
+
+    if (cache->bound_texture)
+    {
+        cache->bound_texture->is_allocated = true;
+    }
+
+    // NOTE: Parts of the texture that are not covered by a plot are never written.
+    CuiBitmap bitmap = cache->texture;
+    bitmap.width = bitmap.stride / 4;
+
+    cui_bitmap_clear(&bitmap, cui_make_color(0.0f, 0.0f, 0.0f, 0.0f));
+
+    _cui_glyph_cache_reset(cache, command_buffer);
+}
+
+static void
+_cui_glyph_cache_deallocate(CuiGlyphCache *cache)
+{
+    CuiAssert(!cache->window_texture_count);
+
+    if (cache->allocated)
+    {
+        cui_platform_deallocate(cache->hashes, cache->allocation_size);
+    }
+
+    CuiClearStruct(*cache);
+}
+
+static void
+_cui_glyph_cache_add_window_texture(CuiGlyphCache *cache, CuiGlyphCacheTexture *texture)
+{
+    CuiAssert(cache->window_texture_count < CuiArrayCount(cache->window_textures));
+
+    cache->window_textures[cache->window_texture_count] = texture;
+    cache->window_texture_count += 1;
+}
+
+static void
+_cui_glyph_cache_remove_window_texture(CuiGlyphCache *cache, CuiGlyphCacheTexture *texture)
+{
+    for (uint32_t index = 0; index < cache->window_texture_count; index += 1)
+    {
+        if (cache->window_textures[index] == texture)
+        {
+            cache->window_texture_count -= 1;
+            cache->window_textures[index] = cache->window_textures[cache->window_texture_count];
+            break;
+        }
+    }
+
+    if (cache->bound_texture == texture)
+    {
+        cache->bound_texture = 0;
+    }
+}
+
+// Lets the window of 'texture' draw with the glyph cache. A texture that missed the allocation,
+// because another window initialized the glyph cache, gets allocated with the current content.
+static void
+_cui_glyph_cache_bind_texture(CuiGlyphCache *cache, CuiGlyphCacheTexture *texture, CuiCommandBuffer *command_buffer)
+{
+    cache->texture_id = texture->texture_id;
+    cache->bound_texture = texture;
+
+    if (cache->allocated)
+    {
+        if (texture->is_allocated)
+        {
+            for (uint32_t index = 0; index < texture->update.rect_count; index += 1)
+            {
+                _cui_command_buffer_update_texture(command_buffer, (uint32_t) texture->texture_id, texture->update.rects[index]);
+            }
+        }
+        else
+        {
+            CuiTextureOperation *texture_op = _cui_command_buffer_add_texture_operation(command_buffer);
+
+            texture_op->type = CUI_TEXTURE_OPERATION_ALLOCATE;
+            texture_op->format = (uint16_t) cache->texture_format;
+            texture_op->texture_id = texture->texture_id;
+            texture_op->payload.bitmap = cache->texture;
+
+            // NOTE: Only the software renderer takes the pixels from the allocation, the other
+            // renderers create an empty texture. The glyphs that are already in the cache are uploaded.
+            _cui_command_buffer_update_texture(command_buffer, (uint32_t) texture->texture_id,
+                                               cui_make_rect(0, 0, cache->texture.width, cache->texture.height));
+
+            texture->is_allocated = true;
+        }
+
+        texture->update.rect_count = 0;
+    }
+}
+
+static bool
+_cui_glyph_cache_find_key(CuiGlyphCache *cache, CuiGlyphKey *key, CuiRect *rect)
+{
+    CuiAssert((cache->allocated > 0) && !((cache->allocated - 1) & cache->allocated));
+
+    uint32_t mask = cache->allocated - 1;
+
+    uint32_t hash = _cui_glyph_key_hash(key);
+    uint32_t bucket = hash & mask;
+
+    uint32_t probe_increment = 1;
+
+    bool found = false;
+
+    while (cache->hashes[bucket])
+    {
+        if (cache->hashes[bucket] == hash)
+        {
+#if CUI_GLYPH_CACHE_STATISTICS_ENABLED
+            cache->key_compare_count += 1;
+#endif
+
+            if ((cache->keys[bucket].id == key->id) &&
+                (cache->keys[bucket].codepoint == key->codepoint) &&
+                (cache->keys[bucket].scale == key->scale) &&
+                (cache->keys[bucket].offset_x == key->offset_x) &&
+                (cache->keys[bucket].offset_y == key->offset_y) &&
+                (cache->keys[bucket].coverage_mode == key->coverage_mode))
+            {
+                cache->last_used_frames[bucket] = cache->frame;
+                *rect = cache->rects[bucket];
+                found = true;
+                break;
+            }
+        }
+
+        bucket = (bucket + probe_increment) & mask;
+        probe_increment += 1;
+    }
+
+#if CUI_GLYPH_CACHE_STATISTICS_ENABLED
+    cache->lookup_count += 1;
+    cache->hit_count += found ? 1 : 0;
+    cache->probe_count += probe_increment;
+    cache->max_probe_length = cui_max_uint32(cache->max_probe_length, probe_increment);
+#endif
+
+    return found;
+}
+
+static void
+_cui_glyph_cache_put_key(CuiGlyphCache *cache, CuiGlyphKey *key, CuiRect rect)
+{
+    // NOTE: Entries are only evicted between frames. A single frame with a lot of new glyphs
+    // must not fill the table completely, probing would never find an empty bucket then.
+    // The glyph is still drawn, it is just not found again until the next eviction.
+    if ((8 * (cache->count + 1)) > (7 * cache->allocated))
+    {
+        cache->insertion_failure_count += 1;
+        return;
+    }
+
+    _cui_glyph_cache_put_entry(cache, _cui_glyph_key_hash(key), *key, rect, cache->frame);
+}
+
+static inline CuiGlyphKey
+_cui_make_glyph_key(uint32_t id, uint32_t codepoint, float scale, float offset_x, float offset_y, CuiCoverageMode coverage_mode)
+{
+    CuiGlyphKey key;
+    key.id = id;
+    key.codepoint = codepoint;
+    key.scale = scale;
+    key.offset_x = offset_x;
+    key.offset_y = offset_y;
+    key.coverage_mode = coverage_mode;
+    return key;
+}
+
+// Shapes are looked up with these, they are always rasterized with CUI_COVERAGE_MODE_SAMPLED.
+static inline bool
+_cui_glyph_cache_find(CuiGlyphCache *cache, uint32_t id, uint32_t codepoint, float scale, float offset_x, float offset_y, CuiRect *rect)
+{
+    CuiGlyphKey key = _cui_make_glyph_key(id, codepoint, scale, offset_x, offset_y, CUI_COVERAGE_MODE_SAMPLED);
+    return _cui_glyph_cache_find_key(cache, &key, rect);
+}
+
+static inline void
+_cui_glyph_cache_put(CuiGlyphCache *cache, uint32_t id, uint32_t codepoint, float scale, float offset_x, float offset_y, CuiRect rect)
+{
+    CuiGlyphKey key = _cui_make_glyph_key(id, codepoint, scale, offset_x, offset_y, CUI_COVERAGE_MODE_SAMPLED);
+    _cui_glyph_cache_put_key(cache, &key, rect);
+}
+
+// Returns the part of the texture that is covered by 'rect'.
+static inline CuiBitmap
+_cui_glyph_cache_get_bitmap(CuiGlyphCache *cache, CuiRect rect)
+{
+    CuiBitmap bitmap;
+    bitmap.width  = cui_rect_get_width(rect);
+    bitmap.height = cui_rect_get_height(rect);
+    bitmap.stride = cache->texture.stride;
+    bitmap.pixels = (uint8_t *) cache->texture.pixels + (rect.min.y * bitmap.stride) +
+                    (rect.min.x * _cui_texture_format_get_bytes_per_pixel(cache->texture_format));
+
+    return bitmap;
+}
+
+static inline bool
+_cui_glyph_plot_is_empty(CuiGlyphPlot *plot)
+{
+    return (plot->node_count == 1) && !plot->nodes[0].y;
+}
+
+// Allocations that are larger than a plot get a block of empty plots for themselves. The search
+// starts with the last plots, because the glyphs fill up the first plots.
+static CuiRect
+_cui_glyph_cache_allocate_plots(CuiGlyphCache *cache, int32_t width, int32_t height, CuiCommandBuffer *command_buffer)
+{
+    CuiRect result = cui_make_rect(0, 0, 0, 0);
+
+    int32_t plot_count_y = (int32_t) cache->plot_count / cache->plot_count_x;
+
+    int32_t span_x = (width + cache->plot_width - 1) / cache->plot_width;
+    int32_t span_y = (height + cache->plot_height - 1) / cache->plot_height;
+
+    for (int32_t plot_y = plot_count_y - span_y; plot_y >= 0; plot_y -= 1)
+    {
+        for (int32_t plot_x = cache->plot_count_x - span_x; plot_x >= 0; plot_x -= 1)
+        {
+            CuiGlyphPlot *first_plot = cache->plots + (plot_y * cache->plot_count_x) + plot_x;
+
+            bool is_free = true;
+
+            for (int32_t y = 0; is_free && (y < span_y); y += 1)
+            {
+                for (int32_t x = 0; is_free && (x < span_x); x += 1)
+                {
+                    is_free = _cui_glyph_plot_is_empty(first_plot + (y * cache->plot_count_x) + x);
+                }
+            }
+
+            if (is_free)
+            {
+                for (int32_t y = 0; y < span_y; y += 1)
+                {
+                    for (int32_t x = 0; x < span_x; x += 1)
+                    {
+                        CuiGlyphPlot *plot = first_plot + (y * cache->plot_count_x) + x;
+
+                        plot->nodes[0].y = (int16_t) cache->plot_height;
+                    }
+                }
+
+                first_plot->span_x = span_x;
+                first_plot->span_y = span_y;
+
+                result = cui_make_rect(first_plot->x, first_plot->y, first_plot->x + width, first_plot->y + height);
+
+                _cui_glyph_cache_update_texture(cache, command_buffer, result);
+
+                return result;
+            }
+        }
+    }
+
+    cache->insertion_failure_count += 1;
+
+    return result;
+}
+
+// Glyphs go into the first plot that has room for them, so that
+// the other plots stay free until the texture is getting full.
+static CuiRect
+_cui_glyph_cache_allocate_texture(CuiGlyphCache *cache, int32_t width, int32_t height, CuiCommandBuffer *command_buffer)
+{
+    CuiRect result = cui_make_rect(0, 0, 0, 0);
+
+    // NOTE: Allocations that are larger than all plots together can never be stored,
+    // so they don't count as a failed insertion that triggers an eviction.
+    if ((width <= 0) || (height <= 0) ||
+        (width > (cache->plot_count_x * cache->plot_width)) ||
+        (height > (((int32_t) cache->plot_count / cache->plot_count_x) * cache->plot_height)))
+    {
+        return result;
+    }
+
+    if ((width > cache->plot_width) || (height > cache->plot_height))
+    {
+        return _cui_glyph_cache_allocate_plots(cache, width, height, command_buffer);
+    }
+
+    for (uint32_t index = 0; index < cache->plot_count; index += 1)
+    {
+        CuiGlyphPlot *plot = cache->plots + index;
+        CuiPoint position;
+
+        if (_cui_glyph_plot_allocate(cache, plot, width, height, &position))
+        {
+            result = cui_make_rect(plot->x + position.x, plot->y + position.y,
+                                   plot->x + position.x + width, plot->y + position.y + height);
+
+            _cui_glyph_cache_update_texture(cache, command_buffer, result);
+
+            return result;
+        }
+    }
+
+    cache->insertion_failure_count += 1;
+
+    return result;
+}
+
+static inline CuiString
+_cui_glyph_cache_get_file_directory(CuiArena *temporary_memory)
+{
+    CuiString data_directory = cui_platform_get_data_directory(temporary_memory, temporary_memory);
+    return cui_path_concat(temporary_memory, data_directory, CuiStringLiteral("cui"));
+}
+
+// Seeds the glyph cache with the glyphs stored by a previous run. Only glyphs of font files that
+// are loaded right now are used, and only half of the cache is filled to leave room for the frame.
+static void
+_cui_glyph_cache_load(CuiGlyphCache *cache, CuiFontFileManager *font_file_manager, CuiCommandBuffer *command_buffer, CuiArena *temporary_memory)
+{
+    CuiAssert(cache->texture_format == CUI_TEXTURE_FORMAT_A8);
+
+    CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
+
+    CuiString filename = cui_path_concat(temporary_memory, _cui_glyph_cache_get_file_directory(temporary_memory), CuiStringLiteral("glyph_cache"));
+    CuiFile *file = cui_platform_file_open(temporary_memory, filename, CUI_FILE_MODE_READ);
+
+    if (file)
+    {
+        uint64_t file_size = cui_platform_file_get_size(file);
+
+        if (file_size >= sizeof(CuiGlyphCacheFileHeader))
+        {
+            uint8_t *contents = (uint8_t *) cui_platform_allocate(file_size);
+
+            if (contents)
+            {
+                uint64_t bytes_read = cui_platform_file_read(file, contents, 0, file_size);
+
+                CuiGlyphCacheFileHeader *header = (CuiGlyphCacheFileHeader *) contents;
+
+                uint64_t entries_size = (uint64_t) header->entry_count * sizeof(CuiGlyphCacheFileEntry);
+                uint64_t contents_size = file_size - sizeof(CuiGlyphCacheFileHeader);
+
+                // NOTE: The sizes are compared one by one, their sum could wrap around.
+                if ((bytes_read == file_size) &&
+                    (header->magic == CUI_GLYPH_CACHE_FILE_MAGIC) && (header->version == CUI_GLYPH_CACHE_FILE_VERSION) &&
+                    (entries_size <= contents_size) && (header->pixels_size == (contents_size - entries_size)))
+                {
+                    CuiGlyphCacheFileEntry *entries = (CuiGlyphCacheFileEntry *) (contents + sizeof(CuiGlyphCacheFileHeader));
+                    uint8_t *pixels = contents + sizeof(CuiGlyphCacheFileHeader) + entries_size;
+
+                    uint64_t font_identity = 0;
+                    uint32_t font_file_id = 0;
+
+                    for (uint32_t index = 0; index < header->entry_count; index += 1)
+                    {
+                        CuiGlyphCacheFileEntry *entry = entries + index;
+
+                        if (_cui_glyph_cache_is_filled(cache, 0.5f, 0.5f))
+                        {
+                            break;
+                        }
+
+                        if (entry->font_identity != font_identity)
+                        {
+                            font_identity = entry->font_identity;
+                            font_file_id = 0;
+
+                            for (int32_t i = 0; i < cui_array_count(font_file_manager->font_files); i += 1)
+                            {
+                                if (font_file_manager->font_files[i].identity == font_identity)
+                                {
+                                    font_file_id = (uint32_t) (i + 1);
+                                    break;
+                                }
+                            }
+                        }
+
+                        uint64_t entry_pixels_size = (uint64_t) entry->width * (uint64_t) entry->height;
+
+                        if (!font_file_id || (entry->coverage_mode > CUI_COVERAGE_MODE_ANALYTIC) ||
+                            (entry->pixels_offset > header->pixels_size) ||
+                            (entry_pixels_size > (header->pixels_size - entry->pixels_offset)))
+                        {
+                            continue;
+                        }
+
+                        CuiGlyphKey key = _cui_make_glyph_key(font_file_id, entry->codepoint, entry->scale, entry->offset_x,
+                                                              entry->offset_y, (CuiCoverageMode) entry->coverage_mode);
+
+                        CuiRect rect;
+
+                        if (_cui_glyph_cache_find_key(cache, &key, &rect))
+                        {
+                            continue;
+                        }
+
+                        rect = _cui_glyph_cache_allocate_texture(cache, entry->width, entry->height, command_buffer);
+
+                        if (!cui_rect_has_area(rect))
+                        {
+                            continue;
+                        }
+
+                        CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(cache, rect);
+
+                        uint8_t *src_row = pixels + entry->pixels_offset;
+                        uint8_t *dst_row = (uint8_t *) bitmap.pixels;
+
+                        for (int32_t y = 0; y < bitmap.height; y += 1)
+                        {
+                            cui_copy_memory(dst_row, src_row, bitmap.width);
+                            src_row += bitmap.width;
+                            dst_row += bitmap.stride;
+                        }
+
+                        _cui_glyph_cache_put_key(cache, &key, rect);
+                    }
+
+                    // NOTE: Glyphs that didn't fit must not trigger an eviction with the first frame.
+                    cache->insertion_failure_count = 0;
+                }
+
+                cui_platform_deallocate(contents, file_size);
+            }
+        }
+
+        cui_platform_file_close(file);
     }
-    else
+
+    cui_end_temporary_memory(temp_memory);
+}
+
+// Stores the glyphs of the glyph cache for the next run. Shapes are cheap to
+// rasterize and are left out, as are glyphs that didn't fit into the texture.
+static void
+_cui_glyph_cache_store(CuiGlyphCache *cache, CuiFontFileManager *font_file_manager, CuiArena *temporary_memory)
+{
+    CuiAssert(cache->texture_format == CUI_TEXTURE_FORMAT_A8);
+
+    uint32_t entry_count = 0;
+    uint64_t pixels_size = 0;
+
+    for (uint32_t index = 0; index < cache->allocated; index += 1)
     {
-        cache->insertion_failure_count += 1;
+        if (cache->hashes[index] && cache->keys[index].id && cui_rect_has_area(cache->rects[index]))
+        {
+            entry_count += 1;
+            pixels_size += (uint64_t) cui_rect_get_width(cache->rects[index]) * (uint64_t) cui_rect_get_height(cache->rects[index]);
+        }
     }
 
-    return result;
+    if (!entry_count)
+    {
+        return;
+    }
+
+    uint64_t entries_size = (uint64_t) entry_count * sizeof(CuiGlyphCacheFileEntry);
+    uint64_t file_size = sizeof(CuiGlyphCacheFileHeader) + entries_size + pixels_size;
+
+    uint8_t *contents = (uint8_t *) cui_platform_allocate(file_size);
+
+    if (!contents)
+    {
+        return;
+    }
+
+    CuiGlyphCacheFileHeader *header = (CuiGlyphCacheFileHeader *) contents;
+
+    header->magic = CUI_GLYPH_CACHE_FILE_MAGIC;
+    header->version = CUI_GLYPH_CACHE_FILE_VERSION;
+    header->entry_count = entry_count;
+    header->reserved = 0;
+    header->pixels_size = pixels_size;
+
+    CuiGlyphCacheFileEntry *entry = (CuiGlyphCacheFileEntry *) (contents + sizeof(CuiGlyphCacheFileHeader));
+    uint8_t *pixels = contents + sizeof(CuiGlyphCacheFileHeader) + entries_size;
+
+    uint32_t pixels_offset = 0;
+
+    for (uint32_t index = 0; index < cache->allocated; index += 1)
+    {
+        CuiGlyphKey *key = cache->keys + index;
+
+        if (cache->hashes[index] && key->id && cui_rect_has_area(cache->rects[index]))
+        {
+            CuiFontFileId font_file_id = { .value = (uint16_t) key->id };
+            CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(cache, cache->rects[index]);
+
+            entry->font_identity = _cui_font_file_manager_get_font_file_from_id(font_file_manager, font_file_id)->identity;
+            entry->codepoint = key->codepoint;
+            entry->scale = key->scale;
+            entry->offset_x = key->offset_x;
+            entry->offset_y = key->offset_y;
+            entry->width = (uint16_t) bitmap.width;
+            entry->height = (uint16_t) bitmap.height;
+            entry->pixels_offset = pixels_offset;
+            entry->coverage_mode = (uint32_t) key->coverage_mode;
+            entry->reserved = 0;
+
+            uint8_t *src_row = (uint8_t *) bitmap.pixels;
+
+            for (int32_t y = 0; y < bitmap.height; y += 1)
+            {
+                cui_copy_memory(pixels + pixels_offset, src_row, bitmap.width);
+                pixels_offset += bitmap.width;
+                src_row += bitmap.stride;
+            }
+
+            entry += 1;
+        }
+    }
+
+    CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
+
+    CuiString directory = _cui_glyph_cache_get_file_directory(temporary_memory);
+
+    if (cui_platform_directory_create(temporary_memory, directory))
+    {
+        CuiFile *file = cui_platform_file_create(temporary_memory, cui_path_concat(temporary_memory, directory, CuiStringLiteral("glyph_cache")));
+
+        if (file)
+        {
+            cui_platform_file_write(file, contents, 0, file_size);
+            cui_platform_file_close(file);
+        }
+    }
+
+    cui_end_temporary_memory(temp_memory);
+
+    cui_platform_deallocate(contents, file_size);
+}
+
+// NOTE: 'dst' and 'src' must not overlap and 'size' has to be a multiple of 4.
+static inline void
+_cui_retained_drawing_copy(void *dst, void *src, uint32_t size)
+{
+    CuiAssert(!(size & 3));
+
+    uint32_t *dst_words = (uint32_t *) dst;
+    uint32_t *src_words = (uint32_t *) src;
+
+    for (uint32_t index = 0; index < (size / 4); index += 1)
+    {
+        dst_words[index] = src_words[index];
+    }
+}
+
+static void
+_cui_retained_drawing_cache_clear(CuiRetainedDrawingCache *cache)
+{
+    cache->count = 0;
+    cache->push_buffer_size = 0;
+    cache->index_count = 0;
+
+    for (uint32_t index = 0; index < cache->allocated; index += 1)
+    {
+        cache->drawings[index].widget = 0;
+    }
+}
+
+static void
+_cui_retained_drawing_cache_deallocate(CuiRetainedDrawingCache *cache)
+{
+    if (cache->drawings)
+    {
+        cui_platform_deallocate(cache->drawings, cache->allocated * sizeof(CuiRetainedDrawing));
+    }
+
+    if (cache->push_buffer)
+    {
+        cui_platform_deallocate(cache->push_buffer, cache->max_push_buffer_size);
+    }
+
+    if (cache->indices)
+    {
+        cui_platform_deallocate(cache->indices, cache->max_index_count * sizeof(uint32_t));
+    }
+
+    CuiClearStruct(*cache);
+}
+
+static inline uint32_t
+_cui_retained_drawing_hash(CuiWidget *widget)
+{
+    uint64_t hash = (uint64_t) (uintptr_t) widget * 0x9E3779B97F4A7C15ull;
+    return (uint32_t) (hash >> 32);
+}
+
+static CuiRetainedDrawing *
+_cui_retained_drawing_cache_find(CuiRetainedDrawingCache *cache, CuiWidget *widget)
+{
+    if (!cache->count)
+    {
+        return 0;
+    }
+
+    uint32_t mask = cache->allocated - 1;
+    uint32_t bucket = _cui_retained_drawing_hash(widget) & mask;
+
+    while (cache->drawings[bucket].widget)
+    {
+        if (cache->drawings[bucket].widget == widget)
+        {
+            return cache->drawings + bucket;
+        }
+
+        bucket = (bucket + 1) & mask;
+    }
+
+    return 0;
+}
+
+static CuiRetainedDrawing *
+_cui_retained_drawing_cache_insert(CuiRetainedDrawingCache *cache, CuiWidget *widget)
+{
+    if (((cache->count + 1) * 4) > (cache->allocated * 3))
+    {
+        uint32_t allocated = cache->allocated ? (2 * cache->allocated) : 256;
+        CuiRetainedDrawing *drawings = (CuiRetainedDrawing *) cui_platform_allocate(allocated * sizeof(CuiRetainedDrawing));
+
+        uint32_t mask = allocated - 1;
+
+        for (uint32_t index = 0; index < cache->allocated; index += 1)
+        {
+            CuiRetainedDrawing *drawing = cache->drawings + index;
+
+            if (drawing->widget)
+            {
+                uint32_t bucket = _cui_retained_drawing_hash(drawing->widget) & mask;
+
+                while (drawings[bucket].widget)
+                {
+                    bucket = (bucket + 1) & mask;
+                }
+
+                drawings[bucket] = *drawing;
+            }
+        }
+
+        if (cache->drawings)
+        {
+            cui_platform_deallocate(cache->drawings, cache->allocated * sizeof(CuiRetainedDrawing));
+        }
+
+        cache->allocated = allocated;
+        cache->drawings = drawings;
+    }
+
+    uint32_t mask = cache->allocated - 1;
+    uint32_t bucket = _cui_retained_drawing_hash(widget) & mask;
+
+    while (cache->drawings[bucket].widget && (cache->drawings[bucket].widget != widget))
+    {
+        bucket = (bucket + 1) & mask;
+    }
+
+    CuiRetainedDrawing *drawing = cache->drawings + bucket;
+
+    if (!drawing->widget)
+    {
+        cache->count += 1;
+    }
+
+    return drawing;
+}
+
+// Adds a drawing with the key of 'key' and reserves space for its primitives and indices.
+static CuiRetainedDrawing *
+_cui_retained_drawing_cache_add(CuiRetainedDrawingCache *cache, CuiRetainedDrawing *key,
+                                uint32_t push_buffer_size, uint32_t index_count)
+{
+    uint32_t push_buffer_offset = CuiAlign(cache->push_buffer_size, 16);
+
+    if ((push_buffer_offset + push_buffer_size) > cache->max_push_buffer_size)
+    {
+        uint32_t max_push_buffer_size = CuiAlign(cui_max_uint32(2 * cache->max_push_buffer_size,
+                                                                push_buffer_offset + push_buffer_size), CuiKiB(64));
+        uint8_t *push_buffer = (uint8_t *) cui_platform_allocate(max_push_buffer_size);
+
+        if (cache->push_buffer)
+        {
+            _cui_retained_drawing_copy(push_buffer, cache->push_buffer, cache->push_buffer_size);
+            cui_platform_deallocate(cache->push_buffer, cache->max_push_buffer_size);
+        }
+
+        cache->max_push_buffer_size = max_push_buffer_size;
+        cache->push_buffer = push_buffer;
+    }
+
+    if ((cache->index_count + index_count) > cache->max_index_count)
+    {
+        uint32_t max_index_count = cui_max_uint32(2 * cache->max_index_count,
+                                                  cui_max_uint32(cache->index_count + index_count, 1024));
+        uint32_t *indices = (uint32_t *) cui_platform_allocate(max_index_count * sizeof(uint32_t));
+
+        if (cache->indices)
+        {
+            _cui_retained_drawing_copy(indices, cache->indices, cache->index_count * sizeof(uint32_t));
+            cui_platform_deallocate(cache->indices, cache->max_index_count * sizeof(uint32_t));
+        }
+
+        cache->max_index_count = max_index_count;
+        cache->indices = indices;
+    }
+
+    CuiRetainedDrawing *drawing = _cui_retained_drawing_cache_insert(cache, key->widget);
+
+    *drawing = *key;
+    drawing->push_buffer_offset = push_buffer_offset;
+    drawing->push_buffer_size = push_buffer_size;
+    drawing->first_index = cache->index_count;
+    drawing->index_count = index_count;
+    drawing->end_clip_rect_offset = 0;
+
+    cache->push_buffer_size = push_buffer_offset + push_buffer_size;
+    cache->index_count += index_count;
+
+    return drawing;
+}
+
+static inline bool
+_cui_retained_drawing_matches(CuiRetainedDrawing *drawing, CuiRetainedDrawing *key)
+{
+    return (drawing->version == key->version) && (drawing->state == key->state) &&
+           (drawing->value == key->value) && (drawing->flags == key->flags) &&
+           (drawing->ui_scale == key->ui_scale) && (drawing->color_theme == key->color_theme) &&
+           cui_rect_equals(drawing->rect, key->rect) && cui_rect_equals(drawing->clip_rect, key->clip_rect);
+}
+
+// Copies the drawing of the previous frame into the command buffer, if its key didn't change.
+static bool
+_cui_retained_drawing_replay(CuiGraphicsContext *ctx, CuiRetainedDrawing *key)
+{
+    CuiRetainedDrawingCache *prev_cache = ctx->prev_retained_drawing_cache;
+    CuiRetainedDrawing *prev_drawing = _cui_retained_drawing_cache_find(prev_cache, key->widget);
+
+    if (!prev_drawing || !_cui_retained_drawing_matches(prev_drawing, key))
+    {
+        return false;
+    }
+
+    uint8_t *src_push_buffer = prev_cache->push_buffer + prev_drawing->push_buffer_offset;
+    uint32_t *src_indices = prev_cache->indices + prev_drawing->first_index;
+
+    CuiRetainedDrawingCache *cache = ctx->retained_drawing_cache;
+    CuiRetainedDrawing *drawing = _cui_retained_drawing_cache_add(cache, key, prev_drawing->push_buffer_size,
+                                                                  prev_drawing->index_count);
+
+    drawing->end_clip_rect_offset = prev_drawing->end_clip_rect_offset;
+
+    _cui_retained_drawing_copy(cache->push_buffer + drawing->push_buffer_offset, src_push_buffer, drawing->push_buffer_size);
+    _cui_retained_drawing_copy(cache->indices + drawing->first_index, src_indices, drawing->index_count * sizeof(uint32_t));
+
+    CuiCommandBuffer *command_buffer = ctx->command_buffer;
+
+    uint32_t base_offset = command_buffer->push_buffer_size;
+    uint8_t *push_buffer = (uint8_t *) _cui_command_buffer_push_primitive(command_buffer, drawing->push_buffer_size);
+
+    _cui_retained_drawing_copy(push_buffer, src_push_buffer, drawing->push_buffer_size);
+
+    for (uint32_t index = 0; index < drawing->index_count; index += 1)
+    {
+        uint32_t offset = src_indices[index];
+        CuiTexturedRect *textured_rect = (CuiTexturedRect *) (push_buffer + offset);
+
+        textured_rect->clip_rect = textured_rect->clip_rect ? (base_offset + textured_rect->clip_rect) : ctx->clip_rect_offset;
+
+        _cui_glyph_cache_mark_replayed(ctx->glyph_cache, textured_rect);
+        _cui_glyph_cache_mark_replayed(ctx->color_glyph_cache, textured_rect);
+
+        _cui_command_buffer_push_index(command_buffer, base_offset + offset);
+    }
+
+    if (drawing->end_clip_rect_offset)
+    {
+        ctx->clip_rect_offset = base_offset + drawing->end_clip_rect_offset;
+    }
+
+    return true;
+}
+
+// Stores everything that was pushed since 'push_buffer_offset' and 'first_index' for the next frame.
+static void
+_cui_retained_drawing_record(CuiGraphicsContext *ctx, CuiRetainedDrawing *key, uint32_t push_buffer_offset, uint32_t first_index)
+{
+    CuiCommandBuffer *command_buffer = ctx->command_buffer;
+    CuiRetainedDrawingCache *cache = ctx->retained_drawing_cache;
+
+    CuiRetainedDrawing *drawing = _cui_retained_drawing_cache_add(cache, key, command_buffer->push_buffer_size - push_buffer_offset,
+                                                                  command_buffer->index_buffer_count - first_index);
+
+    uint8_t *push_buffer = cache->push_buffer + drawing->push_buffer_offset;
+    uint32_t *indices = cache->indices + drawing->first_index;
+
+    _cui_command_buffer_read_push_buffer(command_buffer, push_buffer, push_buffer_offset, drawing->push_buffer_size);
+
+    // NOTE: Clip rect offsets are stored incremented by one, so every clip rect
+    // that was pushed during the recording has an offset above 'push_buffer_offset'.
+    for (uint32_t index = 0; index < drawing->index_count; index += 1)
+    {
+        uint32_t offset = command_buffer->index_buffer[first_index + index] - push_buffer_offset;
+        CuiTexturedRect *textured_rect = (CuiTexturedRect *) (push_buffer + offset);
+
+        textured_rect->clip_rect = (textured_rect->clip_rect > push_buffer_offset) ? (textured_rect->clip_rect - push_buffer_offset) : 0;
+
+        indices[index] = offset;
+    }
+
+    if (ctx->clip_rect_offset > push_buffer_offset)
+    {
+        drawing->end_clip_rect_offset = ctx->clip_rect_offset - push_buffer_offset;
+    }
 }
 
 static bool
@@ -923,6 +3279,94 @@ _cui_remove_window(CuiWindow *window)
     }
 }
 
+// NOTE: CuiTaskGroup is the public storage of a CuiParallelFor.
+typedef char _cui_parallel_for_fits_into_task_group[(sizeof(CuiParallelFor) <= sizeof(CuiTaskGroup)) ? 1 : -1];
+
+static void
+_cui_parallel_for_task(void *data)
+{
+    CuiParallelFor *parallel_for = (CuiParallelFor *) data;
+
+    for (;;)
+    {
+        uint32_t chunk_index = _cui_atomic_increment(&parallel_for->next_chunk_index) - 1;
+
+        if (chunk_index >= parallel_for->chunk_count)
+        {
+            break;
+        }
+
+        int64_t begin = (int64_t) chunk_index * parallel_for->grain;
+        int64_t end = cui_min_int64(begin + parallel_for->grain, parallel_for->count);
+
+        parallel_for->func(parallel_for->data, begin, end);
+    }
+}
+
+void
+cui_parallel_for(int64_t count, int64_t grain, void (*func)(void *data, int64_t begin, int64_t end), void *data)
+{
+    CuiTaskGroup task_group;
+
+    cui_task_group_parallel_for(&task_group, count, grain, func, data);
+    cui_task_group_wait(&task_group);
+}
+
+void
+cui_task_group_parallel_for(CuiTaskGroup *task_group, int64_t count, int64_t grain,
+                            void (*func)(void *data, int64_t begin, int64_t end), void *data)
+{
+    CuiWorkerThreadQueue *queue = &_cui_context.common.worker_thread_queue;
+    CuiParallelFor *parallel_for = (CuiParallelFor *) task_group;
+
+    parallel_for->task_group = _cui_begin_worker_thread_task_group(_cui_parallel_for_task);
+    parallel_for->func = func;
+    parallel_for->data = data;
+    parallel_for->count = cui_max_int64(count, 0);
+    parallel_for->next_chunk_index = 0;
+
+    uint32_t thread_count = cui_max_uint32(queue->deque_count, 1);
+
+    if (grain <= 0)
+    {
+        // A few chunks per thread, so that uneven chunks still balance out.
+        grain = (parallel_for->count + (4 * thread_count) - 1) / (4 * thread_count);
+    }
+
+    // The chunk index is 32 bit.
+    grain = cui_max_int64(grain, (parallel_for->count + INT32_MAX - 1) / INT32_MAX);
+    grain = cui_max_int64(grain, 1);
+
+    parallel_for->grain = grain;
+    parallel_for->chunk_count = (uint32_t) ((parallel_for->count + grain - 1) / grain);
+
+    if ((parallel_for->chunk_count > 1) && (queue->deque_count > 1))
+    {
+        // Every entry keeps taking chunks until there are none left,
+        // so there is no need to add more entries than there are threads.
+        uint32_t entry_count = cui_min_uint32(parallel_for->chunk_count, queue->deque_count);
+        _cui_add_worker_thread_queue_entries(queue, &parallel_for->task_group, parallel_for, 0, entry_count);
+    }
+    else
+    {
+        _cui_parallel_for_task(parallel_for);
+    }
+}
+
+void
+cui_task_group_wait(CuiTaskGroup *task_group)
+{
+    CuiParallelFor *parallel_for = (CuiParallelFor *) task_group;
+
+    if (parallel_for->task_group.completion_goal)
+    {
+        _cui_complete_worker_thread_task_group(&_cui_context.common.worker_thread_queue, &parallel_for->task_group);
+
+        parallel_for->task_group.completion_goal = 0;
+        parallel_for->task_group.completion_count = 0;
+    }
+}
+
 bool
 cui_background_task_start(CuiBackgroundTask *task, void (*task_func)(CuiBackgroundTask *, void *), void *data, bool is_interactive)
 {
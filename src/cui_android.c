@@ -101,7 +101,7 @@ _cui_window_create_renderer(CuiWindow *window)
                 if (window->base.renderer)
                 {
                     CuiRendererOpengles2 *renderer_opengles2 = CuiContainerOf(window->base.renderer, CuiRendererOpengles2, base);
-                    _cui_renderer_opengles2_restore_textures(renderer_opengles2, window->texture_state_count, window->texture_states);
+                    _cui_renderer_opengles2_restore_textures(renderer_opengles2, &window->stored_textures);
                 }
                 else
                 {
@@ -131,7 +131,7 @@ static inline void
 _cui_window_destroy_renderer(CuiWindow *window)
 {
     CuiRendererOpengles2 *renderer_opengles2 = CuiContainerOf(window->base.renderer, CuiRendererOpengles2, base);
-    window->texture_state_count = _cui_renderer_opengles2_store_textures(renderer_opengles2, window->max_texture_state_count, window->texture_states);
+    _cui_renderer_opengles2_store_textures(renderer_opengles2, &window->stored_textures);
 
     _cui_renderer_opengles2_destroy(renderer_opengles2);
     window->base.renderer = 0;
@@ -157,6 +157,13 @@ _cui_window_destroy_renderer(CuiWindow *window)
 static void
 _cui_window_destroy(CuiWindow *window)
 {
+    _cui_window_store_glyph_cache(window);
+    _cui_window_deallocate_retained_drawings(window);
+    _cui_window_deallocate_glyph_rasterizations(window);
+    _cui_window_deallocate_glyph_caches(window);
+    _cui_window_deallocate_texture_slots(window);
+    _cui_texture_table_destroy(&window->stored_textures);
+
     _cui_context.window = 0;
     cui_arena_deallocate(&window->arena);
     _cui_remove_window(window);
@@ -489,7 +496,12 @@ cui_init(int argument_count, char **arguments)
 
     int32_t worker_thread_count = cui_platform_get_performance_core_count() - 1;
 
-    worker_thread_count = cui_max_int32(1, cui_min_int32(worker_thread_count, 15));
+    worker_thread_count = cui_max_int32(1, worker_thread_count);
+
+    if (!_cui_init_worker_thread_queue(&_cui_context.common.worker_thread_queue, worker_thread_count))
+    {
+        return false;
+    }
 
     pthread_cond_init(&_cui_context.common.worker_thread_queue.semaphore_cond, 0);
     pthread_mutex_init(&_cui_context.common.worker_thread_queue.semaphore_mutex, 0);
@@ -505,7 +517,7 @@ cui_init(int argument_count, char **arguments)
          worker_thread_index += 1)
     {
         pthread_t worker_thread;
-        pthread_create(&worker_thread, 0, _cui_worker_thread_proc, 0);
+        pthread_create(&worker_thread, 0, _cui_worker_thread_proc, (void *) (uintptr_t) (worker_thread_index + 1));
     }
 
     pthread_t interactive_background_thread;
@@ -580,9 +592,7 @@ cui_window_create(uint32_t creation_flags)
 
         cui_arena_allocate(&window->arena, CuiKiB(8));
 
-        window->texture_state_count = 0;
-        window->max_texture_state_count = _CUI_MAX_TEXTURE_OPERATION_COUNT;
-        window->texture_states = cui_alloc_array(&window->arena, CuiTextureState, window->max_texture_state_count, CuiDefaultAllocationParams());
+        CuiClearStruct(window->stored_textures);
 
         {
             window->north_split = cui_alloc_type(&window->arena, CuiWidget, CuiDefaultAllocationParams());
@@ -47,9 +47,8 @@ struct CuiWindow
     CuiWidget *east_split;
     CuiWidget *east_box;
 
-    uint32_t texture_state_count;
-    uint32_t max_texture_state_count;
-    CuiTextureState *texture_states;
+    // The textures while there is no renderer.
+    CuiTextureTable stored_textures;
 
     CuiFramebuffer framebuffer;
 
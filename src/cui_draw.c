@@ -30,8 +30,7 @@ _cui_get_1d_blur_kernel(CuiArena *arena, int32_t blur_radius)
 static inline void
 _cui_push_textured_rect(CuiCommandBuffer *command_buffer, CuiRect rect, CuiRect uv, CuiColor color, int32_t texture_id, uint32_t clip_rect_offset)
 {
-    CuiAssert((texture_id >= 0) && (texture_id < CUI_MAX_TEXTURE_COUNT));
-    CuiAssert(command_buffer->index_buffer_count < command_buffer->max_index_buffer_count);
+    CuiAssert(texture_id > 0);
 
     CuiAssert((rect.min.x >= INT16_MIN) && (rect.min.x <= INT16_MAX));
     CuiAssert((rect.min.y >= INT16_MIN) && (rect.min.y <= INT16_MAX));
@@ -62,7 +61,145 @@ _cui_push_textured_rect(CuiCommandBuffer *command_buffer, CuiRect rect, CuiRect
     textured_rect->texture_id = texture_id;
     textured_rect->clip_rect = clip_rect_offset;
 
-    command_buffer->index_buffer[command_buffer->index_buffer_count++] = offset;
+    _cui_command_buffer_push_index(command_buffer, offset);
+}
+
+// Colored glyphs go into their own BGRA cache, the texture is only allocated for the first one.
+static inline CuiGlyphCache *
+_cui_draw_get_color_glyph_cache(CuiGraphicsContext *ctx)
+{
+    CuiGlyphCache *cache = ctx->color_glyph_cache;
+
+    if (!cache->allocated)
+    {
+        _cui_glyph_cache_initialize(cache, ctx->command_buffer, cache->texture_id,
+                                    CUI_TEXTURE_FORMAT_BGRA8, CUI_COLOR_GLYPH_CACHE_TEXTURE_SIZE);
+    }
+
+    return cache;
+}
+
+static inline CuiCoverageMode
+_cui_draw_get_glyph_coverage_mode(CuiGraphicsContext *ctx, int32_t glyph_height)
+{
+    if ((float) glyph_height >= ctx->glyph_coverage_min_height)
+    {
+        return ctx->glyph_coverage_mode;
+    }
+
+    return CUI_COVERAGE_MODE_SAMPLED;
+}
+
+static CuiGlyphRasterization *
+_cui_glyph_rasterization_queue_push(CuiGlyphRasterizationQueue *queue)
+{
+    if (queue->count == queue->allocated)
+    {
+        uint32_t allocated = queue->allocated ? (2 * queue->allocated) : 256;
+        CuiGlyphRasterization *entries = (CuiGlyphRasterization *) cui_platform_allocate(allocated * sizeof(CuiGlyphRasterization));
+
+        if (queue->entries)
+        {
+            cui_copy_memory(entries, queue->entries, queue->count * sizeof(CuiGlyphRasterization));
+            cui_platform_deallocate(queue->entries, queue->allocated * sizeof(CuiGlyphRasterization));
+        }
+
+        queue->allocated = allocated;
+        queue->entries = entries;
+    }
+
+    CuiGlyphRasterization *rasterization = queue->entries + queue->count;
+    queue->count += 1;
+
+    return rasterization;
+}
+
+static void
+_cui_glyph_rasterization_queue_deallocate(CuiGlyphRasterizationQueue *queue)
+{
+    if (queue->entries)
+    {
+        cui_platform_deallocate(queue->entries, queue->allocated * sizeof(CuiGlyphRasterization));
+    }
+
+    CuiClearStruct(*queue);
+}
+
+// Fills all layers of the glyph into its (cleared) place in the glyph cache texture.
+static void
+_cui_glyph_rasterization_fill(CuiGlyphRasterization *rasterization, CuiArena *temporary_memory)
+{
+    CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
+
+    CuiColoredGlyphLayer *layers = 0;
+    cui_array_init(layers, 16, temporary_memory);
+
+    if (!_cui_font_file_get_glyph_colored_layers(rasterization->font_file, &layers, rasterization->glyph_index))
+    {
+        CuiColoredGlyphLayer *layer = cui_array_append(layers);
+
+        layer->glyph_index = rasterization->glyph_index;
+        layer->color = cui_make_color(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+
+    for (int32_t layer_index = 0; layer_index < cui_array_count(layers); layer_index += 1)
+    {
+        CuiColoredGlyphLayer *layer = layers + layer_index;
+
+        CuiTemporaryMemory draw_temp_memory = cui_begin_temporary_memory(temporary_memory);
+
+        CuiPathCommand *outline = 0;
+        cui_array_init(outline, 16, temporary_memory);
+
+        _cui_font_file_get_glyph_outline(rasterization->font_file, &outline, layer->glyph_index, rasterization->transform, temporary_memory);
+
+        CuiEdge *edge_list = 0;
+        cui_array_init(edge_list, 16, temporary_memory);
+
+        _cui_path_to_edge_list(outline, &edge_list);
+
+        if (rasterization->coverage_mode == CUI_COVERAGE_MODE_ANALYTIC)
+        {
+            _cui_edge_list_fill_analytic(temporary_memory, &rasterization->bitmap, rasterization->format, edge_list, layer->color);
+        }
+        else
+        {
+            _cui_edge_list_fill(temporary_memory, &rasterization->bitmap, rasterization->format, edge_list, layer->color);
+        }
+
+        cui_end_temporary_memory(draw_temp_memory);
+    }
+
+    cui_end_temporary_memory(temp_memory);
+}
+
+static void
+_cui_glyph_rasterization_task(void *data, int64_t begin, int64_t end)
+{
+    CuiGlyphRasterizationQueue *queue = (CuiGlyphRasterizationQueue *) data;
+    CuiArena *arena = &_cui_glyph_rasterization_arena;
+
+    if (!arena->base)
+    {
+        cui_arena_allocate(arena, CuiMiB(2));
+    }
+
+    for (int64_t index = begin; index < end; index += 1)
+    {
+        _cui_glyph_rasterization_fill(queue->entries + index, arena);
+    }
+}
+
+// Rasterizes all glyphs that were queued during drawing on the worker threads. This has
+// to happen before the frame is rendered, their places in the texture are already referenced.
+static void
+_cui_glyph_rasterization_queue_flush(CuiGlyphRasterizationQueue *queue)
+{
+    if (queue->count)
+    {
+        cui_parallel_for(queue->count, 0, _cui_glyph_rasterization_task, queue);
+        queue->count = 0;
+    }
 }
 
 static inline void
@@ -87,48 +224,51 @@ _cui_draw_fill_rounded_corner(CuiGraphicsContext *ctx, int32_t x_min, int32_t y_
 
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (cui_rect_has_area(uv))
+            {
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-            CuiPathCommand *path = 0;
-            cui_array_init(path, 16, ctx->temporary_memory);
+                CuiPathCommand *path = 0;
+                cui_array_init(path, 16, ctx->temporary_memory);
 
-            float c = 0.552f;
+                float c = 0.552f;
 
-            cui_path_move_to(&path, radius_x, 0.0f);
-            cui_path_line_to(&path, 0.0f, 0.0f);
-            cui_path_line_to(&path, 0.0f, radius_y);
-            cui_path_cubic_curve_to(&path, radius_x * c, radius_y, radius_x, radius_y * c, radius_x, 0.0f);
+                cui_path_move_to(&path, radius_x, 0.0f);
+                cui_path_line_to(&path, 0.0f, 0.0f);
+                cui_path_line_to(&path, 0.0f, radius_y);
+                cui_path_cubic_curve_to(&path, radius_x * c, radius_y, radius_x, radius_y * c, radius_x, 0.0f);
 
-            CuiEdge *edge_list = 0;
-            cui_array_init(edge_list, 16, ctx->temporary_memory);
+                CuiEdge *edge_list = 0;
+                cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-            _cui_path_to_edge_list(path, &edge_list);
-            _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                _cui_path_to_edge_list(path, &edge_list);
+                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+            }
 
             _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_ROUNDED_CORNER, 0.0f, radius_x, radius_y, uv);
 
             cui_end_temporary_memory(temp_memory);
         }
 
-        if (flip_x)
+        // NOTE: If there was no room in the glyph cache, the corner is left out.
+        if (cui_rect_has_area(uv))
         {
-            int32_t temp = uv.min.x;
-            uv.min.x = uv.max.x;
-            uv.max.x = temp;
-        }
+            if (flip_x)
+            {
+                int32_t temp = uv.min.x;
+                uv.min.x = uv.max.x;
+                uv.max.x = temp;
+            }
 
-        if (flip_y)
-        {
-            int32_t temp = uv.min.y;
-            uv.min.y = uv.max.y;
-            uv.max.y = temp;
-        }
+            if (flip_y)
+            {
+                int32_t temp = uv.min.y;
+                uv.min.y = uv.max.y;
+                uv.max.y = temp;
+            }
 
-        _cui_push_textured_rect(ctx->command_buffer, rect, uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, rect, uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+        }
     }
 }
 
@@ -166,31 +306,7 @@ cui_draw_allocate_texture(CuiGraphicsContext *ctx, int32_t texture_id, CuiBitmap
 void
 cui_draw_update_texture(CuiGraphicsContext *ctx, int32_t texture_id, CuiRect update_rect)
 {
-    CuiTextureOperation *texture_op = 0;
-
-    for (int32_t index = ctx->command_buffer->texture_operation_count - 1; index > 0; index -= 1)
-    {
-        CuiTextureOperation *op = ctx->command_buffer->texture_operations + index;
-
-        if ((op->type == CUI_TEXTURE_OPERATION_UPDATE) && (op->texture_id == texture_id))
-        {
-            texture_op = op;
-            break;
-        }
-    }
-
-    if (texture_op)
-    {
-        texture_op->payload.rect = cui_rect_get_union(texture_op->payload.rect, update_rect);
-    }
-    else
-    {
-        texture_op = _cui_command_buffer_add_texture_operation(ctx->command_buffer);
-
-        texture_op->type = CUI_TEXTURE_OPERATION_UPDATE;
-        texture_op->texture_id = texture_id;
-        texture_op->payload.rect = update_rect;
-    }
+    _cui_command_buffer_update_texture(ctx->command_buffer, (uint32_t) texture_id, update_rect);
 }
 
 void
@@ -239,56 +355,59 @@ cui_draw_fill_rounded_rect_1(CuiGraphicsContext *ctx, CuiRect rect, float radius
 
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (cui_rect_has_area(uv))
+            {
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-            CuiPathCommand *path = 0;
-            cui_array_init(path, 16, ctx->temporary_memory);
+                CuiPathCommand *path = 0;
+                cui_array_init(path, 16, ctx->temporary_memory);
 
-            float c = 0.552f;
+                float c = 0.552f;
 
-            cui_path_move_to(&path, radius, 0.0f);
-            cui_path_line_to(&path, 0.0f, 0.0f);
-            cui_path_line_to(&path, 0.0f, radius);
-            cui_path_cubic_curve_to(&path, radius * c, radius, radius, radius * c, radius, 0.0f);
+                cui_path_move_to(&path, radius, 0.0f);
+                cui_path_line_to(&path, 0.0f, 0.0f);
+                cui_path_line_to(&path, 0.0f, radius);
+                cui_path_cubic_curve_to(&path, radius * c, radius, radius, radius * c, radius, 0.0f);
 
-            CuiEdge *edge_list = 0;
-            cui_array_init(edge_list, 16, ctx->temporary_memory);
+                CuiEdge *edge_list = 0;
+                cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-            _cui_path_to_edge_list(path, &edge_list);
-            _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                _cui_path_to_edge_list(path, &edge_list);
+                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+            }
 
             _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_ROUNDED_CORNER, 0.0f, radius, radius, uv);
 
             cui_end_temporary_memory(temp_memory);
         }
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.max.y - offset, rect.max.x, rect.max.y),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+        // NOTE: If there was no room in the glyph cache, the corners are left out.
+        if (cui_rect_has_area(uv))
+        {
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.max.y - offset, rect.max.x, rect.max.y),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
 
-        int32_t temp = uv.min.x;
-        uv.min.x = uv.max.x;
-        uv.max.x = temp;
+            int32_t temp = uv.min.x;
+            uv.min.x = uv.max.x;
+            uv.max.x = temp;
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.max.y - offset, rect.min.x + offset, rect.max.y),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.max.y - offset, rect.min.x + offset, rect.max.y),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
 
-        temp = uv.min.y;
-        uv.min.y = uv.max.y;
-        uv.max.y = temp;
+            temp = uv.min.y;
+            uv.min.y = uv.max.y;
+            uv.max.y = temp;
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.min.y, rect.min.x + offset, rect.min.y + offset),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.min.y, rect.min.x + offset, rect.min.y + offset),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
 
-        temp = uv.min.x;
-        uv.min.x = uv.max.x;
-        uv.max.x = temp;
+            temp = uv.min.x;
+            uv.min.x = uv.max.x;
+            uv.max.x = temp;
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.min.y, rect.max.x, rect.min.y + offset),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.min.y, rect.max.x, rect.min.y + offset),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+        }
 
         _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x + offset, rect.min.y, rect.max.x - offset, rect.min.y + offset),
                                 cui_make_rect(0, 0, 0, 0), color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
@@ -598,56 +717,59 @@ cui_draw_fill_inverted_rounded_rect_1(CuiGraphicsContext *ctx, CuiRect rect, flo
 
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (cui_rect_has_area(uv))
+            {
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-            CuiPathCommand *path = 0;
-            cui_array_init(path, 16, ctx->temporary_memory);
+                CuiPathCommand *path = 0;
+                cui_array_init(path, 16, ctx->temporary_memory);
 
-            float c = 0.552f;
+                float c = 0.552f;
 
-            cui_path_move_to(&path, radius, radius);
-            cui_path_line_to(&path, radius, 0.0f);
-            cui_path_cubic_curve_to(&path, radius, radius * c, radius * c, radius, 0.0f, radius);
-            cui_path_close(&path);
+                cui_path_move_to(&path, radius, radius);
+                cui_path_line_to(&path, radius, 0.0f);
+                cui_path_cubic_curve_to(&path, radius, radius * c, radius * c, radius, 0.0f, radius);
+                cui_path_close(&path);
 
-            CuiEdge *edge_list = 0;
-            cui_array_init(edge_list, 16, ctx->temporary_memory);
+                CuiEdge *edge_list = 0;
+                cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-            _cui_path_to_edge_list(path, &edge_list);
-            _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                _cui_path_to_edge_list(path, &edge_list);
+                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+            }
 
             _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_INVERTED_ROUNDED_CORNER, 0.0f, radius, radius, uv);
 
             cui_end_temporary_memory(temp_memory);
         }
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.max.y - offset, rect.max.x, rect.max.y),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+        // NOTE: If there was no room in the glyph cache, the corners are left out.
+        if (cui_rect_has_area(uv))
+        {
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.max.y - offset, rect.max.x, rect.max.y),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
 
-        int32_t temp = uv.min.x;
-        uv.min.x = uv.max.x;
-        uv.max.x = temp;
+            int32_t temp = uv.min.x;
+            uv.min.x = uv.max.x;
+            uv.max.x = temp;
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.max.y - offset, rect.min.x + offset, rect.max.y),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.max.y - offset, rect.min.x + offset, rect.max.y),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
 
-        temp = uv.min.y;
-        uv.min.y = uv.max.y;
-        uv.max.y = temp;
+            temp = uv.min.y;
+            uv.min.y = uv.max.y;
+            uv.max.y = temp;
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.min.y, rect.min.x + offset, rect.min.y + offset),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.min.x, rect.min.y, rect.min.x + offset, rect.min.y + offset),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
 
-        temp = uv.min.x;
-        uv.min.x = uv.max.x;
-        uv.max.x = temp;
+            temp = uv.min.x;
+            uv.min.x = uv.max.x;
+            uv.max.x = temp;
 
-        _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.min.y, rect.max.x, rect.min.y + offset),
-                                uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, cui_make_rect(rect.max.x - offset, rect.min.y, rect.max.x, rect.min.y + offset),
+                                    uv, color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+        }
     }
 }
 
@@ -666,25 +788,23 @@ cui_draw_fill_shadow(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32_t max,
 
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, span, 1, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (cui_rect_has_area(uv))
+            {
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-            CuiKernel blur_kernel = _cui_get_1d_blur_kernel(ctx->temporary_memory, blur_radius);
+                CuiKernel blur_kernel = _cui_get_1d_blur_kernel(ctx->temporary_memory, blur_radius);
 
-            uint32_t *pixel = (uint32_t *) bitmap.pixels;
-            float sum = (float) blur_kernel.weights[0];
+                uint8_t *pixel = (uint8_t *) bitmap.pixels;
+                float sum = (float) blur_kernel.weights[0];
 
-            for (int32_t i = 0; i < span; i += 1)
-            {
-                float value = sum * blur_kernel.factor;
-                uint8_t val = (uint8_t) ((value * 255.0f) + 0.5f);
-                *pixel = 0x01010101 * (uint32_t) val;
+                for (int32_t i = 0; i < span; i += 1)
+                {
+                    float value = sum * blur_kernel.factor;
+                    *pixel = (uint8_t) ((value * 255.0f) + 0.5f);
 
-                pixel += 1;
-                sum += (float) blur_kernel.weights[i + 1];
+                    pixel += 1;
+                    sum += (float) blur_kernel.weights[i + 1];
+                }
             }
 
             cui_end_temporary_memory(temp_memory);
@@ -702,25 +822,23 @@ cui_draw_fill_shadow(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32_t max,
 
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, 1, span, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (cui_rect_has_area(uv))
+            {
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-            CuiKernel blur_kernel = _cui_get_1d_blur_kernel(ctx->temporary_memory, blur_radius);
+                CuiKernel blur_kernel = _cui_get_1d_blur_kernel(ctx->temporary_memory, blur_radius);
 
-            uint8_t *row = (uint8_t *) bitmap.pixels;
-            float sum = (float) blur_kernel.weights[0];
+                uint8_t *row = (uint8_t *) bitmap.pixels;
+                float sum = (float) blur_kernel.weights[0];
 
-            for (int32_t i = 0; i < span; i += 1)
-            {
-                float value = sum * blur_kernel.factor;
-                uint8_t val = (uint8_t) ((value * 255.0f) + 0.5f);
-                *(uint32_t *) row = 0x01010101 * (uint32_t) val;
+                for (int32_t i = 0; i < span; i += 1)
+                {
+                    float value = sum * blur_kernel.factor;
+                    *row = (uint8_t) ((value * 255.0f) + 0.5f);
 
-                row += bitmap.stride;
-                sum += (float) blur_kernel.weights[i + 1];
+                    row += bitmap.stride;
+                    sum += (float) blur_kernel.weights[i + 1];
+                }
             }
 
             cui_end_temporary_memory(temp_memory);
@@ -729,6 +847,12 @@ cui_draw_fill_shadow(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32_t max,
         }
     }
 
+    // NOTE: If there was no room in the glyph cache, the shadow is left out.
+    if (!cui_rect_has_area(uv))
+    {
+        return;
+    }
+
     CuiRect draw_rect;
 
     switch (direction)
@@ -778,111 +902,96 @@ cui_draw_fill_shadow_corner(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32
 
         uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, size, size, ctx->command_buffer);
 
-        CuiBitmap bitmap;
-        bitmap.width  = cui_rect_get_width(uv);
-        bitmap.height = cui_rect_get_height(uv);
-        bitmap.stride = ctx->glyph_cache->texture.stride;
-        bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+        if (cui_rect_has_area(uv))
+        {
+            CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-        CuiBitmap backbuffer1;
-        backbuffer1.width  = bitmap.width;
-        backbuffer1.height = bitmap.height;
-        backbuffer1.stride = backbuffer1.width * 4;
-        backbuffer1.pixels = cui_alloc(ctx->temporary_memory, backbuffer1.stride * backbuffer1.height, cui_make_allocation_params(true, 8));
+            CuiBitmap backbuffer1;
+            backbuffer1.width  = bitmap.width;
+            backbuffer1.height = bitmap.height;
+            backbuffer1.stride = backbuffer1.width;
+            backbuffer1.pixels = cui_alloc(ctx->temporary_memory, backbuffer1.stride * backbuffer1.height, cui_make_allocation_params(true, 8));
 
-        CuiTemporaryMemory temp_memory2 = cui_begin_temporary_memory(ctx->temporary_memory);
+            CuiTemporaryMemory temp_memory2 = cui_begin_temporary_memory(ctx->temporary_memory);
 
-        CuiPathCommand *path = 0;
-        cui_array_init(path, 16, ctx->temporary_memory);
+            CuiPathCommand *path = 0;
+            cui_array_init(path, 16, ctx->temporary_memory);
 
-        float c = 0.552f;
+            float c = 0.552f;
 
-        cui_path_move_to(&path, (float) distance_from_corner, (float) blur_radius);
-        cui_path_line_to(&path, (float) distance_from_corner, 0.0f);
-        cui_path_line_to(&path, 0.0f, 0.0f);
-        cui_path_line_to(&path, 0.0f, (float) distance_from_corner);
-        cui_path_line_to(&path, (float) blur_radius, (float) distance_from_corner);
-        cui_path_cubic_curve_to(&path, (float) blur_radius + ((float) radius * c), (float) distance_from_corner,
-                                (float) distance_from_corner, (float) blur_radius + ((float) radius * c), (float) distance_from_corner, (float) blur_radius);
+            cui_path_move_to(&path, (float) distance_from_corner, (float) blur_radius);
+            cui_path_line_to(&path, (float) distance_from_corner, 0.0f);
+            cui_path_line_to(&path, 0.0f, 0.0f);
+            cui_path_line_to(&path, 0.0f, (float) distance_from_corner);
+            cui_path_line_to(&path, (float) blur_radius, (float) distance_from_corner);
+            cui_path_cubic_curve_to(&path, (float) blur_radius + ((float) radius * c), (float) distance_from_corner,
+                                    (float) distance_from_corner, (float) blur_radius + ((float) radius * c), (float) distance_from_corner, (float) blur_radius);
 
-        CuiEdge *edge_list = 0;
-        cui_array_init(edge_list, 16, ctx->temporary_memory);
+            CuiEdge *edge_list = 0;
+            cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-        _cui_path_to_edge_list(path, &edge_list);
-        _cui_edge_list_fill(ctx->temporary_memory, &backbuffer1, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+            _cui_path_to_edge_list(path, &edge_list);
+            _cui_edge_list_fill(ctx->temporary_memory, &backbuffer1, CUI_TEXTURE_FORMAT_A8, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
 
-        cui_end_temporary_memory(temp_memory2);
+            cui_end_temporary_memory(temp_memory2);
 
-        CuiBitmap backbuffer2;
-        backbuffer2.width  = bitmap.width;
-        backbuffer2.height = bitmap.height;
-        backbuffer2.stride = backbuffer2.width * 4;
-        backbuffer2.pixels = cui_alloc(ctx->temporary_memory, backbuffer2.stride * backbuffer2.height, CuiDefaultAllocationParams());
+            CuiBitmap backbuffer2;
+            backbuffer2.width  = bitmap.width;
+            backbuffer2.height = bitmap.height;
+            backbuffer2.stride = backbuffer2.width;
+            backbuffer2.pixels = cui_alloc(ctx->temporary_memory, backbuffer2.stride * backbuffer2.height, CuiDefaultAllocationParams());
 
-        CuiKernel blur_kernel = _cui_get_1d_blur_kernel(ctx->temporary_memory, blur_radius);
+            CuiKernel blur_kernel = _cui_get_1d_blur_kernel(ctx->temporary_memory, blur_radius);
 
-        uint8_t *row = (uint8_t *) backbuffer2.pixels;
-        for (int32_t y = 0; y < backbuffer2.height; y += 1)
-        {
-            uint32_t *pixel = (uint32_t *) row;
-            for (int32_t x = 0; x < backbuffer2.width; x += 1)
+            uint8_t *row = (uint8_t *) backbuffer2.pixels;
+            for (int32_t y = 0; y < backbuffer2.height; y += 1)
             {
-                CuiColor color = cui_make_color(0.0f, 0.0f, 0.0f, 0.0f);
-
-                for (int32_t offset = -blur_radius; offset <= blur_radius; offset += 1)
+                uint8_t *pixel = row;
+                for (int32_t x = 0; x < backbuffer2.width; x += 1)
                 {
-                    float weight = blur_kernel.weights[offset + blur_radius];
-                    int32_t x_coord = cui_max_int32(0, cui_min_int32(x + offset, backbuffer1.width - 1));
-                    uint32_t packed_pixel = *(uint32_t *) ((uint8_t *) backbuffer1.pixels + (y * backbuffer1.stride) + (x_coord * 4));
-                    CuiColor pixel = cui_color_unpack_bgra(packed_pixel);
-
-                    color.r += weight * pixel.r;
-                    color.g += weight * pixel.g;
-                    color.b += weight * pixel.b;
-                    color.a += weight * pixel.a;
-                }
+                    float value = 0.0f;
+
+                    for (int32_t offset = -blur_radius; offset <= blur_radius; offset += 1)
+                    {
+                        float weight = blur_kernel.weights[offset + blur_radius];
+                        int32_t x_coord = cui_max_int32(0, cui_min_int32(x + offset, backbuffer1.width - 1));
+                        uint8_t coverage = *((uint8_t *) backbuffer1.pixels + (y * backbuffer1.stride) + x_coord);
 
-                color.r *= blur_kernel.factor;
-                color.g *= blur_kernel.factor;
-                color.b *= blur_kernel.factor;
-                color.a *= blur_kernel.factor;
+                        value += weight * ((float) coverage / 255.0f);
+                    }
 
-                *pixel = cui_color_pack_bgra(color);
-                pixel += 1;
+                    value *= blur_kernel.factor;
+
+                    *pixel = (uint8_t) ((value * 255.0f) + 0.5f);
+                    pixel += 1;
+                }
+                row += backbuffer2.stride;
             }
-            row += backbuffer2.stride;
-        }
 
-        row = (uint8_t *) bitmap.pixels;
-        for (int32_t y = 0; y < bitmap.height; y += 1)
-        {
-            uint32_t *pixel = (uint32_t *) row;
-            for (int32_t x = 0; x < bitmap.width; x += 1)
+            row = (uint8_t *) bitmap.pixels;
+            for (int32_t y = 0; y < bitmap.height; y += 1)
             {
-                CuiColor color = cui_make_color(0.0f, 0.0f, 0.0f, 0.0f);
-
-                for (int32_t offset = -blur_radius; offset <= blur_radius; offset += 1)
+                uint8_t *pixel = row;
+                for (int32_t x = 0; x < bitmap.width; x += 1)
                 {
-                    float weight = blur_kernel.weights[offset + blur_radius];
-                    int32_t y_coord = cui_max_int32(0, cui_min_int32(y + offset, backbuffer2.height - 1));
-                    uint32_t packed_pixel = *(uint32_t *) ((uint8_t *) backbuffer2.pixels + (y_coord * backbuffer2.stride) + (x * 4));
-                    CuiColor pixel = cui_color_unpack_bgra(packed_pixel);
-
-                    color.r += weight * pixel.r;
-                    color.g += weight * pixel.g;
-                    color.b += weight * pixel.b;
-                    color.a += weight * pixel.a;
-                }
+                    float value = 0.0f;
 
-                color.r *= blur_kernel.factor;
-                color.g *= blur_kernel.factor;
-                color.b *= blur_kernel.factor;
-                color.a *= blur_kernel.factor;
+                    for (int32_t offset = -blur_radius; offset <= blur_radius; offset += 1)
+                    {
+                        float weight = blur_kernel.weights[offset + blur_radius];
+                        int32_t y_coord = cui_max_int32(0, cui_min_int32(y + offset, backbuffer2.height - 1));
+                        uint8_t coverage = *((uint8_t *) backbuffer2.pixels + (y_coord * backbuffer2.stride) + x);
+
+                        value += weight * ((float) coverage / 255.0f);
+                    }
 
-                *pixel = cui_color_pack_bgra(color);
-                pixel += 1;
+                    value *= blur_kernel.factor;
+
+                    *pixel = (uint8_t) ((value * 255.0f) + 0.5f);
+                    pixel += 1;
+                }
+                row += bitmap.stride;
             }
-            row += bitmap.stride;
         }
 
         cui_end_temporary_memory(temp_memory1);
@@ -890,6 +999,12 @@ cui_draw_fill_shadow_corner(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32
         _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_SHADOW_CORNER, (float) blur_radius, (float) radius, 0.0f, uv);
     }
 
+    // NOTE: If there was no room in the glyph cache, the shadow is left out.
+    if (!cui_rect_has_area(uv))
+    {
+        return;
+    }
+
     CuiRect draw_rect;
 
     if (direction_x == CUI_DIRECTION_EAST)
@@ -944,39 +1059,44 @@ cui_draw_stroke_dashed_line(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32
         {
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, span, scale, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
-
-            uint8_t *row = (uint8_t *) bitmap.pixels;
-
-            for (int32_t y = 0; y < scale; y += 1)
+            if (cui_rect_has_area(uv))
             {
-                uint32_t *pixel = (uint32_t *) row;
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-                for (int32_t r = 0; r < repeats; r += 1)
+                uint8_t *row = (uint8_t *) bitmap.pixels;
+
+                for (int32_t y = 0; y < scale; y += 1)
                 {
-                    for (int32_t x = 0; x < (scale * solid_count); x += 1)
-                    {
-                        *pixel = 0xFFFFFFFF;
-                        pixel += 1;
-                    }
+                    uint8_t *pixel = row;
 
-                    for (int32_t x = 0; x < (scale * empty_count); x += 1)
+                    for (int32_t r = 0; r < repeats; r += 1)
                     {
-                        *pixel = 0x00000000;
-                        pixel += 1;
+                        for (int32_t x = 0; x < (scale * solid_count); x += 1)
+                        {
+                            *pixel = 0xFF;
+                            pixel += 1;
+                        }
+
+                        for (int32_t x = 0; x < (scale * empty_count); x += 1)
+                        {
+                            *pixel = 0x00;
+                            pixel += 1;
+                        }
                     }
-                }
 
-                row += bitmap.stride;
+                    row += bitmap.stride;
+                }
             }
 
             _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_DASHED_LINE_HORIZONTAL, (float) scale, (float) solid_count, (float) empty_count, uv);
         }
 
+        // NOTE: If there was no room in the glyph cache, the line is left out.
+        if (!cui_rect_has_area(uv))
+        {
+            return;
+        }
+
         CuiRect draw_rect = cui_make_rect(x, y, x + span, y + scale);
 
         while (draw_rect.max.x <= ctx->clip_rect.min.x)
@@ -1003,46 +1123,51 @@ cui_draw_stroke_dashed_line(CuiGraphicsContext *ctx, int32_t x, int32_t y, int32
         {
             uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, scale, span, ctx->command_buffer);
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (cui_rect_has_area(uv))
+            {
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-            uint8_t *row = (uint8_t *) bitmap.pixels;
+                uint8_t *row = (uint8_t *) bitmap.pixels;
 
-            for (int32_t r = 0; r < repeats; r += 1)
-            {
-                for (int32_t y = 0; y < (scale * solid_count); y += 1)
+                for (int32_t r = 0; r < repeats; r += 1)
                 {
-                    uint32_t *pixel = (uint32_t *) row;
-
-                    for (int32_t x = 0; x < scale; x += 1)
+                    for (int32_t y = 0; y < (scale * solid_count); y += 1)
                     {
-                        *pixel = 0xFFFFFFFF;
-                        pixel += 1;
-                    }
+                        uint8_t *pixel = row;
 
-                    row += bitmap.stride;
-                }
+                        for (int32_t x = 0; x < scale; x += 1)
+                        {
+                            *pixel = 0xFF;
+                            pixel += 1;
+                        }
 
-                for (int32_t y = 0; y < (scale * empty_count); y += 1)
-                {
-                    uint32_t *pixel = (uint32_t *) row;
+                        row += bitmap.stride;
+                    }
 
-                    for (int32_t x = 0; x < scale; x += 1)
+                    for (int32_t y = 0; y < (scale * empty_count); y += 1)
                     {
-                        *pixel = 0x00000000;
-                        pixel += 1;
-                    }
+                        uint8_t *pixel = row;
 
-                    row += bitmap.stride;
+                        for (int32_t x = 0; x < scale; x += 1)
+                        {
+                            *pixel = 0x00;
+                            pixel += 1;
+                        }
+
+                        row += bitmap.stride;
+                    }
                 }
             }
 
             _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_DASHED_LINE_VERTICAL, (float) scale, (float) solid_count, (float) empty_count, uv);
         }
 
+        // NOTE: If there was no room in the glyph cache, the line is left out.
+        if (!cui_rect_has_area(uv))
+        {
+            return;
+        }
+
         CuiRect draw_rect = cui_make_rect(x, y, x + scale, y + span);
 
         while (draw_rect.max.y <= ctx->clip_rect.min.y)
@@ -1093,6 +1218,7 @@ cui_draw_fill_codepoint(CuiGraphicsContext *ctx, CuiFontId font_id, float x, flo
 
     CuiRect bounding_box;
     CuiColor glyph_color = color;
+    CuiGlyphCache *glyph_cache = ctx->glyph_cache;
 
     CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(ctx->temporary_memory);
 
@@ -1101,6 +1227,8 @@ cui_draw_fill_codepoint(CuiGraphicsContext *ctx, CuiFontId font_id, float x, flo
 
     if (_cui_font_file_get_glyph_colored_layers(used_font_file, &layers, glyph_index))
     {
+        glyph_cache = _cui_draw_get_color_glyph_cache(ctx);
+
         glyph_color.r = 1.0f;
         glyph_color.g = 1.0f;
         glyph_color.b = 1.0f;
@@ -1146,48 +1274,38 @@ cui_draw_fill_codepoint(CuiGraphicsContext *ctx, CuiFontId font_id, float x, flo
         offset_x = 0.125f * roundf(offset_x * 8.0f);
         offset_y = 0.125f * roundf(offset_y * 8.0f);
 
-        CuiRect uv;
+        int32_t width  = (int32_t) ceilf(x + bound.max.x) - (int32_t) bitmap_x;
+        int32_t height = (int32_t) ceilf(y - bound.min.y) - (int32_t) bitmap_y;
 
-        if (!_cui_glyph_cache_find(ctx->glyph_cache, used_font->file_id.value, codepoint, used_font->font_scale, offset_x, offset_y, &uv))
-        {
-            int32_t width  = (int32_t) ceilf(x + bound.max.x) - (int32_t) bitmap_x;
-            int32_t height = (int32_t) ceilf(y - bound.min.y) - (int32_t) bitmap_y;
+        CuiGlyphKey key = _cui_make_glyph_key(used_font->file_id.value, codepoint, used_font->font_scale, offset_x, offset_y,
+                                              _cui_draw_get_glyph_coverage_mode(ctx, height));
 
-            uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
+        CuiRect uv;
 
-            CuiBitmap bitmap;
-            bitmap.width  = cui_rect_get_width(uv);
-            bitmap.height = cui_rect_get_height(uv);
-            bitmap.stride = ctx->glyph_cache->texture.stride;
-            bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+        if (!_cui_glyph_cache_find_key(glyph_cache, &key, &uv))
+        {
+            uv = _cui_glyph_cache_allocate_texture(glyph_cache, width, height, ctx->command_buffer);
 
-            for (int32_t layer_index = 0; layer_index < cui_array_count(layers); layer_index += 1)
+            // NOTE: The place in the texture is reserved now, the glyph is rasterized with all
+            // other glyphs of the frame by _cui_glyph_rasterization_queue_flush.
+            if (cui_rect_has_area(uv))
             {
-                CuiColoredGlyphLayer *layer = layers + layer_index;
-
-                CuiTemporaryMemory draw_temp_memory = cui_begin_temporary_memory(ctx->temporary_memory);
-
-                CuiPathCommand *outline = 0;
-                cui_array_init(outline, 16, ctx->temporary_memory);
-
-                CuiTransform transform = { 0 };
-                transform.m[0] = used_font->font_scale;
-                transform.m[3] = -used_font->font_scale;
-                transform.m[4] = offset_x - bound.min.x;
-                transform.m[5] = offset_y + bound.max.y;
-
-                _cui_font_file_get_glyph_outline(used_font_file, &outline, layer->glyph_index, transform, ctx->temporary_memory);
-
-                CuiEdge *edge_list = 0;
-                cui_array_init(edge_list, 16, ctx->temporary_memory);
-
-                _cui_path_to_edge_list(outline, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, layer->color);
-
-                cui_end_temporary_memory(draw_temp_memory);
+                CuiGlyphRasterization *rasterization = _cui_glyph_rasterization_queue_push(ctx->glyph_rasterization_queue);
+
+                rasterization->font_file = used_font_file;
+                rasterization->glyph_index = glyph_index;
+                rasterization->format = glyph_cache->texture_format;
+                rasterization->coverage_mode = key.coverage_mode;
+                rasterization->bitmap = _cui_glyph_cache_get_bitmap(glyph_cache, uv);
+
+                CuiClearStruct(rasterization->transform);
+                rasterization->transform.m[0] = used_font->font_scale;
+                rasterization->transform.m[3] = -used_font->font_scale;
+                rasterization->transform.m[4] = offset_x - bound.min.x;
+                rasterization->transform.m[5] = offset_y + bound.max.y;
             }
 
-            _cui_glyph_cache_put(ctx->glyph_cache, used_font->file_id.value, codepoint, used_font->font_scale, offset_x, offset_y, uv);
+            _cui_glyph_cache_put_key(glyph_cache, &key, uv);
         }
 
         CuiRect draw_rect;
@@ -1196,7 +1314,7 @@ cui_draw_fill_codepoint(CuiGraphicsContext *ctx, CuiFontId font_id, float x, flo
 
         if (cui_rect_overlap(ctx->clip_rect, draw_rect))
         {
-            _cui_push_textured_rect(ctx->command_buffer, draw_rect, uv, glyph_color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+            _cui_push_textured_rect(ctx->command_buffer, draw_rect, uv, glyph_color, glyph_cache->texture_id, ctx->clip_rect_offset);
         }
     }
 
@@ -1252,6 +1370,7 @@ cui_draw_fill_string(CuiGraphicsContext *ctx, CuiFontId font_id, float x, float
 
         CuiRect bounding_box;
         CuiColor glyph_color = color;
+        CuiGlyphCache *glyph_cache = ctx->glyph_cache;
 
         CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(ctx->temporary_memory);
 
@@ -1260,6 +1379,8 @@ cui_draw_fill_string(CuiGraphicsContext *ctx, CuiFontId font_id, float x, float
 
         if (_cui_font_file_get_glyph_colored_layers(used_font_file, &layers, glyph_index))
         {
+            glyph_cache = _cui_draw_get_color_glyph_cache(ctx);
+
             glyph_color.r = 1.0f;
             glyph_color.g = 1.0f;
             glyph_color.b = 1.0f;
@@ -1305,48 +1426,38 @@ cui_draw_fill_string(CuiGraphicsContext *ctx, CuiFontId font_id, float x, float
             offset_x = 0.125f * roundf(offset_x * 8.0f);
             offset_y = 0.125f * roundf(offset_y * 8.0f);
 
-            CuiRect uv;
+            int32_t width  = (int32_t) ceilf(x + bound.max.x) - (int32_t) bitmap_x;
+            int32_t height = (int32_t) ceilf(y - bound.min.y) - (int32_t) bitmap_y;
 
-            if (!_cui_glyph_cache_find(ctx->glyph_cache, used_font->file_id.value, utf8.codepoint, used_font->font_scale, offset_x, offset_y, &uv))
-            {
-                int32_t width  = (int32_t) ceilf(x + bound.max.x) - (int32_t) bitmap_x;
-                int32_t height = (int32_t) ceilf(y - bound.min.y) - (int32_t) bitmap_y;
+            CuiGlyphKey key = _cui_make_glyph_key(used_font->file_id.value, utf8.codepoint, used_font->font_scale, offset_x, offset_y,
+                                                  _cui_draw_get_glyph_coverage_mode(ctx, height));
 
-                uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
+            CuiRect uv;
 
-                CuiBitmap bitmap;
-                bitmap.width  = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+            if (!_cui_glyph_cache_find_key(glyph_cache, &key, &uv))
+            {
+                uv = _cui_glyph_cache_allocate_texture(glyph_cache, width, height, ctx->command_buffer);
 
-                for (int32_t layer_index = 0; layer_index < cui_array_count(layers); layer_index += 1)
+                // NOTE: The place in the texture is reserved now, the glyph is rasterized with all
+                // other glyphs of the frame by _cui_glyph_rasterization_queue_flush.
+                if (cui_rect_has_area(uv))
                 {
-                    CuiColoredGlyphLayer *layer = layers + layer_index;
-
-                    CuiTemporaryMemory draw_temp_memory = cui_begin_temporary_memory(ctx->temporary_memory);
-
-                    CuiPathCommand *outline = 0;
-                    cui_array_init(outline, 16, ctx->temporary_memory);
-
-                    CuiTransform transform = { 0 };
-                    transform.m[0] = used_font->font_scale;
-                    transform.m[3] = -used_font->font_scale;
-                    transform.m[4] = offset_x - bound.min.x;
-                    transform.m[5] = offset_y + bound.max.y;
-
-                    _cui_font_file_get_glyph_outline(used_font_file, &outline, layer->glyph_index, transform, ctx->temporary_memory);
-
-                    CuiEdge *edge_list = 0;
-                    cui_array_init(edge_list, 16, ctx->temporary_memory);
-
-                    _cui_path_to_edge_list(outline, &edge_list);
-                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, layer->color);
-
-                    cui_end_temporary_memory(draw_temp_memory);
+                    CuiGlyphRasterization *rasterization = _cui_glyph_rasterization_queue_push(ctx->glyph_rasterization_queue);
+
+                    rasterization->font_file = used_font_file;
+                    rasterization->glyph_index = glyph_index;
+                    rasterization->format = glyph_cache->texture_format;
+                    rasterization->coverage_mode = key.coverage_mode;
+                    rasterization->bitmap = _cui_glyph_cache_get_bitmap(glyph_cache, uv);
+
+                    CuiClearStruct(rasterization->transform);
+                    rasterization->transform.m[0] = used_font->font_scale;
+                    rasterization->transform.m[3] = -used_font->font_scale;
+                    rasterization->transform.m[4] = offset_x - bound.min.x;
+                    rasterization->transform.m[5] = offset_y + bound.max.y;
                 }
 
-                _cui_glyph_cache_put(ctx->glyph_cache, used_font->file_id.value, utf8.codepoint, used_font->font_scale, offset_x, offset_y, uv);
+                _cui_glyph_cache_put_key(glyph_cache, &key, uv);
             }
 
             CuiRect draw_rect;
@@ -1355,7 +1466,7 @@ cui_draw_fill_string(CuiGraphicsContext *ctx, CuiFontId font_id, float x, float
 
             if (cui_rect_overlap(ctx->clip_rect, draw_rect))
             {
-                _cui_push_textured_rect(ctx->command_buffer, draw_rect, uv, glyph_color, ctx->glyph_cache->texture_id, ctx->clip_rect_offset);
+                _cui_push_textured_rect(ctx->command_buffer, draw_rect, uv, glyph_color, glyph_cache->texture_id, ctx->clip_rect_offset);
             }
         }
 
@@ -1405,32 +1516,31 @@ cui_draw_fill_icon(CuiGraphicsContext *ctx, float x, float y, float scale, CuiIc
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                if (cui_rect_has_area(uv))
+                {
+                    CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-                CuiPathCommand *path = 0;
-                cui_array_init(path, 16, ctx->temporary_memory);
+                    CuiPathCommand *path = 0;
+                    cui_array_init(path, 16, ctx->temporary_memory);
 
-                float x0 = roundf(scale * 1.0f);
-                float y0 = roundf(scale * 6.0f);
-                float x1 = x0 + roundf(scale * 10.0f);
-                float line_width = floorf(scale * 1.0f);
-                float y1 = y0 + line_width;
+                    float x0 = roundf(scale * 1.0f);
+                    float y0 = roundf(scale * 6.0f);
+                    float x1 = x0 + roundf(scale * 10.0f);
+                    float line_width = floorf(scale * 1.0f);
+                    float y1 = y0 + line_width;
 
-                cui_path_move_to(&path, x0, y0);
-                cui_path_line_to(&path, x1, y0);
-                cui_path_line_to(&path, x1, y1);
-                cui_path_line_to(&path, x0, y1);
-                cui_path_close(&path);
+                    cui_path_move_to(&path, x0, y0);
+                    cui_path_line_to(&path, x1, y0);
+                    cui_path_line_to(&path, x1, y1);
+                    cui_path_line_to(&path, x0, y1);
+                    cui_path_close(&path);
 
-                CuiEdge *edge_list = 0;
-                cui_array_init(edge_list, 16, ctx->temporary_memory);
+                    CuiEdge *edge_list = 0;
+                    cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-                _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                    _cui_path_to_edge_list(path, &edge_list);
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
 
                 _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_WINDOWS_MINIMIZE, scale, offset_x, offset_y, uv);
 
@@ -1474,44 +1584,43 @@ cui_draw_fill_icon(CuiGraphicsContext *ctx, float x, float y, float scale, CuiIc
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                if (cui_rect_has_area(uv))
+                {
+                    CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
-                CuiPathCommand *path = 0;
-                cui_array_init(path, 16, ctx->temporary_memory);
+                    CuiPathCommand *path = 0;
+                    cui_array_init(path, 16, ctx->temporary_memory);
 
-                float x0 = roundf(scale * 1.0f);
-                float y0 = x0;
-                float x1 = x0 + roundf(scale * 10.0f);
-                float y1 = x1;
+                    float x0 = roundf(scale * 1.0f);
+                    float y0 = x0;
+                    float x1 = x0 + roundf(scale * 10.0f);
+                    float y1 = x1;
 
-                cui_path_move_to(&path, x0, y0);
-                cui_path_line_to(&path, x1, y0);
-                cui_path_line_to(&path, x1, y1);
-                cui_path_line_to(&path, x0, y1);
-                cui_path_close(&path);
+                    cui_path_move_to(&path, x0, y0);
+                    cui_path_line_to(&path, x1, y0);
+                    cui_path_line_to(&path, x1, y1);
+                    cui_path_line_to(&path, x0, y1);
+                    cui_path_close(&path);
 
-                float line_width = floorf(scale * 1.0f);
+                    float line_width = floorf(scale * 1.0f);
 
-                x0 += line_width;
-                y0 += line_width;
-                x1 -= line_width;
-                y1 -= line_width;
+                    x0 += line_width;
+                    y0 += line_width;
+                    x1 -= line_width;
+                    y1 -= line_width;
 
-                cui_path_move_to(&path, x0, y0);
-                cui_path_line_to(&path, x0, y1);
-                cui_path_line_to(&path, x1, y1);
-                cui_path_line_to(&path, x1, y0);
-                cui_path_close(&path);
+                    cui_path_move_to(&path, x0, y0);
+                    cui_path_line_to(&path, x0, y1);
+                    cui_path_line_to(&path, x1, y1);
+                    cui_path_line_to(&path, x1, y0);
+                    cui_path_close(&path);
 
-                CuiEdge *edge_list = 0;
-                cui_array_init(edge_list, 16, ctx->temporary_memory);
+                    CuiEdge *edge_list = 0;
+                    cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-                _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                    _cui_path_to_edge_list(path, &edge_list);
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
 
                 _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_WINDOWS_MAXIMIZE, scale, offset_x, offset_y, uv);
 
@@ -1555,48 +1664,47 @@ cui_draw_fill_icon(CuiGraphicsContext *ctx, float x, float y, float scale, CuiIc
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
-
-                CuiPathCommand *path = 0;
-                cui_array_init(path, 16, ctx->temporary_memory);
-
-                float x0 = roundf(scale * 1.0f);
-                float y0 = x0;
-                float x1 = x0 + roundf(scale * 10.0f);
-                float y1 = x1;
-                float cx = 0.5f * (x0 + x1);
-                float cy = cx;
-
-                float line_width = floorf(scale * 1.0f);
-                float offset = sqrtf(0.5f * (line_width * line_width));
-
-                cui_path_move_to(&path, x0, y0);
-                cui_path_line_to(&path, x0 + offset, y0);
-                cui_path_line_to(&path, cx, cy - offset);
-                cui_path_line_to(&path, x1 - offset, y0);
-                cui_path_line_to(&path, x1, y0);
-                cui_path_line_to(&path, x1, y0 + offset);
-                cui_path_line_to(&path, cx + offset, cy);
-                cui_path_line_to(&path, x1, y1 - offset);
-                cui_path_line_to(&path, x1, y1);
-                cui_path_line_to(&path, x1 - offset, y1);
-                cui_path_line_to(&path, cx, cy + offset);
-                cui_path_line_to(&path, x0 + offset, y1);
-                cui_path_line_to(&path, x0, y1);
-                cui_path_line_to(&path, x0, y1 - offset);
-                cui_path_line_to(&path, cx - offset, cy);
-                cui_path_line_to(&path, x0, y0 + offset);
-                cui_path_close(&path);
+                if (cui_rect_has_area(uv))
+                {
+                    CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
+
+                    CuiPathCommand *path = 0;
+                    cui_array_init(path, 16, ctx->temporary_memory);
+
+                    float x0 = roundf(scale * 1.0f);
+                    float y0 = x0;
+                    float x1 = x0 + roundf(scale * 10.0f);
+                    float y1 = x1;
+                    float cx = 0.5f * (x0 + x1);
+                    float cy = cx;
+
+                    float line_width = floorf(scale * 1.0f);
+                    float offset = sqrtf(0.5f * (line_width * line_width));
+
+                    cui_path_move_to(&path, x0, y0);
+                    cui_path_line_to(&path, x0 + offset, y0);
+                    cui_path_line_to(&path, cx, cy - offset);
+                    cui_path_line_to(&path, x1 - offset, y0);
+                    cui_path_line_to(&path, x1, y0);
+                    cui_path_line_to(&path, x1, y0 + offset);
+                    cui_path_line_to(&path, cx + offset, cy);
+                    cui_path_line_to(&path, x1, y1 - offset);
+                    cui_path_line_to(&path, x1, y1);
+                    cui_path_line_to(&path, x1 - offset, y1);
+                    cui_path_line_to(&path, cx, cy + offset);
+                    cui_path_line_to(&path, x0 + offset, y1);
+                    cui_path_line_to(&path, x0, y1);
+                    cui_path_line_to(&path, x0, y1 - offset);
+                    cui_path_line_to(&path, cx - offset, cy);
+                    cui_path_line_to(&path, x0, y0 + offset);
+                    cui_path_close(&path);
 
-                CuiEdge *edge_list = 0;
-                cui_array_init(edge_list, 16, ctx->temporary_memory);
+                    CuiEdge *edge_list = 0;
+                    cui_array_init(edge_list, 16, ctx->temporary_memory);
 
-                _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                    _cui_path_to_edge_list(path, &edge_list);
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
 
                 _cui_glyph_cache_put(ctx->glyph_cache, 0, CUI_SHAPE_WINDOWS_CLOSE, scale, offset_x, offset_y, uv);
 
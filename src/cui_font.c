@@ -365,7 +365,130 @@ _cui_path_to_edge_list(CuiPathCommand *path, CuiEdge **edge_list)
 }
 
 static void
-_cui_edge_list_fill(CuiArena *temporary_memory, CuiBitmap *buffer, CuiEdge *edges, CuiColor color)
+_cui_active_edge_table_init(CuiActiveEdgeTable *table, CuiArena *temporary_memory, CuiEdge *edges, int32_t height)
+{
+    int32_t edge_count = cui_array_count(edges);
+
+    int32_t *first_rows = cui_alloc_array(temporary_memory, int32_t, edge_count, CuiDefaultAllocationParams());
+
+    table->last_rows = cui_alloc_array(temporary_memory, int32_t, edge_count, CuiDefaultAllocationParams());
+    table->row_ends = cui_alloc_array(temporary_memory, int32_t, height + 1, CuiDefaultAllocationParams());
+    table->sorted_edges = cui_alloc_array(temporary_memory, int32_t, edge_count, CuiDefaultAllocationParams());
+    table->active_edges = cui_alloc_array(temporary_memory, int32_t, edge_count, CuiDefaultAllocationParams());
+    table->sorted_edge_index = 0;
+    table->active_edge_count = 0;
+
+    int32_t *last_rows = table->last_rows;
+    int32_t *row_ends = table->row_ends;
+
+    for (int32_t y = 0; y <= height; y += 1)
+    {
+        row_ends[y] = 0;
+    }
+
+    for (int32_t i = 0; i < edge_count; i += 1)
+    {
+        CuiEdge *edge = edges + i;
+
+        // NOTE: Row y covers the edges with (y1 >= y) and (y0 < y + 1).
+        first_rows[i] = 0;
+        last_rows[i] = -1;
+
+        if ((edge->y0 < (float) height) && (edge->y1 >= 0.0f))
+        {
+            first_rows[i] = (edge->y0 < 0.0f) ? 0 : (int32_t) floorf(edge->y0);
+            last_rows[i] = (edge->y1 >= (float) height) ? (height - 1) : (int32_t) floorf(edge->y1);
+        }
+
+        if (first_rows[i] <= last_rows[i])
+        {
+            row_ends[first_rows[i] + 1] += 1;
+        }
+    }
+
+    for (int32_t y = 0; y < height; y += 1)
+    {
+        row_ends[y + 1] += row_ends[y];
+    }
+
+    // NOTE: This moves the start of every bucket to its end.
+    for (int32_t i = 0; i < edge_count; i += 1)
+    {
+        if (first_rows[i] <= last_rows[i])
+        {
+            table->sorted_edges[row_ends[first_rows[i]]] = i;
+            row_ends[first_rows[i]] += 1;
+        }
+    }
+}
+
+static inline void
+_cui_active_edge_table_begin_row(CuiActiveEdgeTable *table, int32_t y)
+{
+    for (; table->sorted_edge_index < table->row_ends[y]; table->sorted_edge_index += 1)
+    {
+        table->active_edges[table->active_edge_count] = table->sorted_edges[table->sorted_edge_index];
+        table->active_edge_count += 1;
+    }
+}
+
+static inline void
+_cui_active_edge_table_end_row(CuiActiveEdgeTable *table, int32_t y)
+{
+    for (int32_t i = 0; i < table->active_edge_count;)
+    {
+        if (table->last_rows[table->active_edges[i]] == y)
+        {
+            table->active_edge_count -= 1;
+            table->active_edges[i] = table->active_edges[table->active_edge_count];
+        }
+        else
+        {
+            i += 1;
+        }
+    }
+}
+
+// 'color' has to be premultiplied.
+static inline void
+_cui_edge_list_blend_pixel(uint8_t *row, int32_t x, CuiTextureFormat format, CuiColor color, float coverage)
+{
+    CuiColor src;
+
+    src.a = color.a * coverage;
+    src.r = color.r * coverage;
+    src.g = color.g * coverage;
+    src.b = color.b * coverage;
+
+    if (format == CUI_TEXTURE_FORMAT_A8)
+    {
+        uint8_t *pixel = row + x;
+
+        float dst = (float) *pixel / 255.0f;
+
+        dst = src.a + dst * (1.0f - src.a);
+
+        *pixel = (uint8_t) ((dst * 255.0f) + 0.5f);
+    }
+    else
+    {
+        uint32_t *pixel = (uint32_t *) row + x;
+
+        CuiColor dst = cui_color_unpack_bgra(*pixel);
+
+        dst.a = src.a + dst.a * (1.0f - src.a);
+        dst.r = src.r + dst.r * (1.0f - src.a);
+        dst.g = src.g + dst.g * (1.0f - src.a);
+        dst.b = src.b + dst.b * (1.0f - src.a);
+
+        *pixel = cui_color_pack_bgra(dst);
+    }
+}
+
+// Fills the edges into 'buffer' blending over what is already there. For CUI_TEXTURE_FORMAT_A8
+// only the coverage is written, so only the alpha of 'color' is used.
+static void
+_cui_edge_list_fill(CuiArena *temporary_memory, CuiBitmap *buffer, CuiTextureFormat format, CuiEdge *edges, CuiColor color)
 {
     CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
 
@@ -394,103 +517,426 @@ _cui_edge_list_fill(CuiArena *temporary_memory, CuiBitmap *buffer, CuiEdge *edge
     color.g *= color.a;
     color.b *= color.a;
 
+    CuiActiveEdgeTable edge_table;
+    _cui_active_edge_table_init(&edge_table, temporary_memory, edges, buffer->height);
+
     uint32_t scanline_width = buffer->width + 1;
-    uint32_t array_count = 16 * scanline_width;
 
-    int8_t *scanline = cui_alloc_array(temporary_memory, int8_t, array_count, CuiDefaultAllocationParams());
+    int8_t *scanline = cui_alloc_array(temporary_memory, int8_t, 16 * scanline_width, CuiDefaultAllocationParams());
+    bool *touched_columns = cui_alloc_array(temporary_memory, bool, scanline_width, CuiDefaultAllocationParams());
     int8_t *moving_sample = cui_alloc_array(temporary_memory, int8_t, 16, CuiDefaultAllocationParams());
 
+    for (uint32_t i = 0; i < 16 * scanline_width; i += 1)
+    {
+        scanline[i] = 0;
+    }
+
+    for (uint32_t i = 0; i < scanline_width; i += 1)
+    {
+        touched_columns[i] = false;
+    }
+
     float y_min = 0.0f;
     float y_max = 1.0f;
 
     uint8_t *row = (uint8_t *) buffer->pixels;
     for (int32_t y = 0; y < buffer->height; y++)
     {
-        for (uint32_t i = 0; i < array_count; i += 1)
+        _cui_active_edge_table_begin_row(&edge_table, y);
+
+        int32_t touched_x_min = (int32_t) scanline_width;
+        int32_t touched_x_max = -1;
+
+        for (int32_t i = 0; i < edge_table.active_edge_count; i += 1)
         {
-            scanline[i] = 0;
+            CuiEdge edge = edges[edge_table.active_edges[i]];
+
+            float dx = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+
+            if (edge.y0 < y_min)
+            {
+                edge.x0 += (y_min - edge.y0) * dx;
+                edge.y0 = y_min;
+            }
+
+            if (edge.y1 >= y_max)
+            {
+                edge.x1 += (y_max - edge.y1) * dx;
+                edge.y1 = y_max;
+            }
+
+            dx *= inv_sample_count;
+
+            int32_t y0 = lroundf(16.0f * (edge.y0 - y_min));
+            int32_t y1 = lroundf(16.0f * (edge.y1 - y_min));
+
+            float x = edge.x0 + 0.5f * dx;
+            int8_t value = edge.positive ? -1 : 1;
+
+            for (int32_t current_y = y0; current_y < y1; current_y += 1)
+            {
+                int32_t x_index = cui_max_int32(0, cui_min_int32((int32_t) floorf(x + sample_offsets[current_y]), (int32_t) scanline_width - 1));
+
+                scanline[(16 * x_index) + current_y] += value;
+                touched_columns[x_index] = true;
+
+                touched_x_min = cui_min_int32(touched_x_min, x_index);
+                touched_x_max = cui_max_int32(touched_x_max, x_index);
+
+                x += dx;
+            }
         }
 
+        _cui_active_edge_table_end_row(&edge_table, y);
+
         for (uint32_t i = 0; i < 16; i += 1)
         {
             moving_sample[i] = 0;
         }
 
-        for (int32_t i = 0; i < cui_array_count(edges); i++)
-        {
-            CuiEdge edge = edges[i];
+        int32_t filled_sample_count = 0;
 
-            if ((edge.y1 >= y_min) && (edge.y0 < y_max))
+        // NOTE: The samples only change in touched columns. Pixels without
+        // any filled sample are left as they are, blending them changes nothing.
+        for (int32_t x = touched_x_min; x < buffer->width; x += 1)
+        {
+            if (touched_columns[x])
             {
-                float dx = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+                int8_t *column = scanline + (16 * x);
 
-                if (edge.y0 < y_min)
+                filled_sample_count = 0;
+
+                for (uint32_t i = 0; i < 16; i += 1)
                 {
-                    edge.x0 += (y_min - edge.y0) * dx;
-                    edge.y0 = y_min;
+                    moving_sample[i] += column[i];
+                    column[i] = 0;
+
+                    if (moving_sample[i])
+                    {
+                        filled_sample_count += 1;
+                    }
                 }
 
-                if (edge.y1 >= y_max)
+                touched_columns[x] = false;
+            }
+            else if (!filled_sample_count)
+            {
+                if (x > touched_x_max)
                 {
-                    edge.x1 += (y_max - edge.y1) * dx;
-                    edge.y1 = y_max;
+                    break;
                 }
 
-                dx *= inv_sample_count;
+                continue;
+            }
+
+            if (!filled_sample_count)
+            {
+                continue;
+            }
+
+            _cui_edge_list_blend_pixel(row, x, format, color, (float) filled_sample_count * inv_sample_count);
+        }
 
-                int32_t y0 = lroundf(16.0f * (edge.y0 - y_min));
-                int32_t y1 = lroundf(16.0f * (edge.y1 - y_min));
+        // NOTE: The last column is outside of the bitmap and never resolved.
+        if (touched_x_max == buffer->width)
+        {
+            int8_t *column = scanline + (16 * buffer->width);
 
-                float x = edge.x0 + 0.5f * dx;
-                int8_t value = edge.positive ? -1 : 1;
+            for (uint32_t i = 0; i < 16; i += 1)
+            {
+                column[i] = 0;
+            }
 
-                for (int32_t current_y = y0; current_y < y1; current_y += 1)
-                {
-                    int32_t x_index = cui_max_int32(0, cui_min_int32((int32_t) floorf(x + sample_offsets[current_y]), (int32_t) scanline_width - 1));
+            touched_columns[buffer->width] = false;
+        }
 
-                    scanline[(16 * x_index) + current_y] += value;
+        y_min += 1.0f;
+        y_max += 1.0f;
+        row += buffer->stride;
+    }
 
-                    x += dx;
-                }
+    cui_end_temporary_memory(temp_memory);
+}
+
+// Adds the area that a line covers right of it to 'accumulation'. The line has to lie within
+// one row, with 0 <= y0 <= y1 <= 1 relative to the row and x0, x1 within the bitmap.
+static inline void
+_cui_accumulate_line(float *accumulation, float x0, float y0, float x1, float y1, float direction)
+{
+    float d = direction * (y1 - y0);
+
+    float x_min = cui_min_float(x0, x1);
+    float x_max = cui_max_float(x0, x1);
+
+    int32_t x0_index = (int32_t) floorf(x_min);
+    int32_t x1_index = (int32_t) ceilf(x_max);
+
+    if (x1_index <= (x0_index + 1))
+    {
+        float x_mid = (0.5f * (x0 + x1)) - (float) x0_index;
+
+        accumulation[x0_index]     += d - (d * x_mid);
+        accumulation[x0_index + 1] += d * x_mid;
+    }
+    else
+    {
+        // NOTE: The line crosses several pixels. The first and the last pixel get a triangle,
+        // every pixel in between gets the same share of the height.
+        float s = 1.0f / (x_max - x_min);
+        float x0_fraction = x_min - (float) x0_index;
+        float x1_fraction = x_max - (float) x1_index + 1.0f;
+
+        float a0 = 0.5f * s * (1.0f - x0_fraction) * (1.0f - x0_fraction);
+        float am = 0.5f * s * x1_fraction * x1_fraction;
+
+        accumulation[x0_index] += d * a0;
+
+        if (x1_index == (x0_index + 2))
+        {
+            accumulation[x0_index + 1] += d * (1.0f - a0 - am);
+        }
+        else
+        {
+            float a1 = s * (1.5f - x0_fraction);
+
+            accumulation[x0_index + 1] += d * (a1 - a0);
+
+            for (int32_t x = x0_index + 2; x < (x1_index - 1); x += 1)
+            {
+                accumulation[x] += d * s;
+            }
+
+            float a2 = a1 + (float) (x1_index - x0_index - 3) * s;
+
+            accumulation[x1_index - 1] += d * (1.0f - a2 - am);
+        }
+
+        accumulation[x1_index] += d * am;
+    }
+}
+
+// Like _cui_accumulate_line, but x0 and x1 can be outside of [0, width]. The parts of the line
+// left of the bitmap cover the whole row, so they are moved onto the left border. The parts
+// right of the bitmap are moved onto the right border, which is never resolved.
+static void
+_cui_accumulate_clipped_line(float *accumulation, float width, float x0, float y0, float x1, float y1, float direction)
+{
+    if (((x0 < 0.0f) && (x1 > 0.0f)) || ((x0 > 0.0f) && (x1 < 0.0f)))
+    {
+        float y = y0 + ((0.0f - x0) / (x1 - x0)) * (y1 - y0);
+
+        _cui_accumulate_clipped_line(accumulation, width, x0, y0, 0.0f, y, direction);
+        _cui_accumulate_clipped_line(accumulation, width, 0.0f, y, x1, y1, direction);
+    }
+    else if (((x0 < width) && (x1 > width)) || ((x0 > width) && (x1 < width)))
+    {
+        float y = y0 + ((width - x0) / (x1 - x0)) * (y1 - y0);
+
+        _cui_accumulate_clipped_line(accumulation, width, x0, y0, width, y, direction);
+        _cui_accumulate_clipped_line(accumulation, width, width, y, x1, y1, direction);
+    }
+    else
+    {
+        x0 = cui_max_float(0.0f, cui_min_float(x0, width));
+        x1 = cui_max_float(0.0f, cui_min_float(x1, width));
+
+        _cui_accumulate_line(accumulation, x0, y0, x1, y1, direction);
+    }
+}
+
+// Same as _cui_edge_list_fill, but computes the exact area of every pixel that is covered by
+// the edges. Every row accumulates the signed area of its edges, the prefix sum of that is
+// the coverage. Overlapping outlines are combined like with the non-zero winding rule.
+static void
+_cui_edge_list_fill_analytic(CuiArena *temporary_memory, CuiBitmap *buffer, CuiTextureFormat format, CuiEdge *edges, CuiColor color)
+{
+    CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
+
+    color.r *= color.a;
+    color.g *= color.a;
+    color.b *= color.a;
+
+    CuiActiveEdgeTable edge_table;
+    _cui_active_edge_table_init(&edge_table, temporary_memory, edges, buffer->height);
+
+    // NOTE: Lines on the right border add to the two entries after the last pixel. The prefix
+    // sum works on groups of 4, so all of them are padded to that.
+    int32_t accumulation_count = (int32_t) CuiAlign(buffer->width + 2, 4);
+
+    float *accumulation = cui_alloc_array(temporary_memory, float, accumulation_count, CuiDefaultAllocationParams());
+    float *coverage = cui_alloc_array(temporary_memory, float, accumulation_count, CuiDefaultAllocationParams());
+
+    for (int32_t i = 0; i < accumulation_count; i += 1)
+    {
+        accumulation[i] = 0.0f;
+    }
+
+    float width = (float) buffer->width;
+
+    float y_min = 0.0f;
+    float y_max = 1.0f;
+
+    uint8_t *row = (uint8_t *) buffer->pixels;
+    for (int32_t y = 0; y < buffer->height; y++)
+    {
+        _cui_active_edge_table_begin_row(&edge_table, y);
+
+        float touched_x_min = width;
+        float touched_x_max = 0.0f;
+
+        for (int32_t i = 0; i < edge_table.active_edge_count; i += 1)
+        {
+            CuiEdge edge = edges[edge_table.active_edges[i]];
+
+            float dx = (edge.x1 - edge.x0) / (edge.y1 - edge.y0);
+
+            if (edge.y0 < y_min)
+            {
+                edge.x0 += (y_min - edge.y0) * dx;
+                edge.y0 = y_min;
+            }
+
+            if (edge.y1 >= y_max)
+            {
+                edge.x1 += (y_max - edge.y1) * dx;
+                edge.y1 = y_max;
+            }
+
+            if (edge.y1 > edge.y0)
+            {
+                _cui_accumulate_clipped_line(accumulation, width, edge.x0, edge.y0 - y_min, edge.x1, edge.y1 - y_min,
+                                             edge.positive ? -1.0f : 1.0f);
+
+                touched_x_min = cui_min_float(touched_x_min, cui_min_float(edge.x0, edge.x1));
+                touched_x_max = cui_max_float(touched_x_max, cui_max_float(edge.x0, edge.x1));
             }
         }
 
-        uint32_t *pixel = (uint32_t *) row;
+        _cui_active_edge_table_end_row(&edge_table, y);
 
-        for (int32_t x = 0; x < buffer->width; x += 1)
+        if (touched_x_min <= touched_x_max)
         {
-            for (uint32_t i = 0; i < 16; i += 1)
+            // NOTE: Everything left of the first edge is zero. Right of the last edge
+            // the area of a closed outline sums up to zero again.
+            touched_x_min = cui_max_float(0.0f, cui_min_float(touched_x_min, width));
+            touched_x_max = cui_max_float(0.0f, cui_min_float(touched_x_max, width));
+
+            int32_t x_start = (int32_t) floorf(touched_x_min) & ~3;
+            int32_t x_end = (int32_t) CuiAlign((int32_t) ceilf(touched_x_max) + 2, 4);
+
+#if CUI_ARCH_X86_64
+            __m128 sum = _mm_setzero_ps();
+            __m128 one = _mm_set1_ps(1.0f);
+            __m128 sign_mask = _mm_set1_ps(-0.0f);
+
+            for (int32_t x = x_start; x < x_end; x += 4)
             {
-                moving_sample[i] += scanline[(16 * x) + i];
+                __m128 value = _mm_loadu_ps(accumulation + x);
+
+                value = _mm_add_ps(value, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(value), 4)));
+                value = _mm_add_ps(value, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(value), 8)));
+                value = _mm_add_ps(value, sum);
+
+                sum = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+
+                _mm_storeu_ps(coverage + x, _mm_min_ps(_mm_andnot_ps(sign_mask, value), one));
+                _mm_storeu_ps(accumulation + x, _mm_setzero_ps());
             }
+#elif CUI_ARCH_ARM64
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            float32x4_t zero = vdupq_n_f32(0.0f);
+            float32x4_t one = vdupq_n_f32(1.0f);
 
-            int32_t filled_sample_count = 0;
+            for (int32_t x = x_start; x < x_end; x += 4)
+            {
+                float32x4_t value = vld1q_f32(accumulation + x);
 
-            for (uint32_t i = 0; i < 16; i += 1)
+                value = vaddq_f32(value, vextq_f32(zero, value, 3));
+                value = vaddq_f32(value, vextq_f32(zero, value, 2));
+                value = vaddq_f32(value, sum);
+
+                sum = vdupq_laneq_f32(value, 3);
+
+                vst1q_f32(coverage + x, vminq_f32(vabsq_f32(value), one));
+                vst1q_f32(accumulation + x, zero);
+            }
+#else
+            float sum = 0.0f;
+
+            for (int32_t x = x_start; x < x_end; x += 1)
+            {
+                sum += accumulation[x];
+
+                coverage[x] = cui_min_float(fabsf(sum), 1.0f);
+                accumulation[x] = 0.0f;
+            }
+#endif
+
+            x_end = cui_min_int32(x_end, buffer->width);
+
+            int32_t x = x_start;
+
+            // NOTE: This does the same as _cui_edge_list_blend_pixel for 4 pixels at once. A coverage
+            // of zero leaves the pixel as it is, so the pixels in between the edges are blended as well.
+            if (format == CUI_TEXTURE_FORMAT_A8)
             {
-                if (moving_sample[i])
+#if CUI_ARCH_X86_64
+                __m128i zero = _mm_setzero_si128();
+                __m128 alpha = _mm_set1_ps(color.a);
+                __m128 max_value = _mm_set1_ps(255.0f);
+                __m128 half = _mm_set1_ps(0.5f);
+
+                for (; (x + 4) <= x_end; x += 4)
                 {
-                    filled_sample_count += 1;
+                    __m128 src_a = _mm_mul_ps(alpha, _mm_loadu_ps(coverage + x));
+
+                    __m128 dst = _mm_cvtepi32_ps(_mm_setr_epi32(row[x], row[x + 1], row[x + 2], row[x + 3]));
+
+                    dst = _mm_div_ps(dst, max_value);
+                    dst = _mm_add_ps(src_a, _mm_mul_ps(dst, _mm_sub_ps(_mm_set1_ps(1.0f), src_a)));
+
+                    __m128i pixels = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(dst, max_value), half));
+                    pixels = _mm_packus_epi16(_mm_packs_epi32(pixels, zero), zero);
+
+                    uint32_t result = (uint32_t) _mm_cvtsi128_si32(pixels);
+
+                    row[x + 0] = (uint8_t) result;
+                    row[x + 1] = (uint8_t) (result >> 8);
+                    row[x + 2] = (uint8_t) (result >> 16);
+                    row[x + 3] = (uint8_t) (result >> 24);
                 }
-            }
+#elif CUI_ARCH_ARM64
+                float32x4_t alpha = vdupq_n_f32(color.a);
+                float32x4_t max_value = vdupq_n_f32(255.0f);
+                float32x4_t half = vdupq_n_f32(0.5f);
 
-            float coverage = (float) filled_sample_count * inv_sample_count;
+                for (; (x + 4) <= x_end; x += 4)
+                {
+                    float32x4_t src_a = vmulq_f32(alpha, vld1q_f32(coverage + x));
 
-            CuiColor src;
+                    uint32_t pixels[4] = { row[x], row[x + 1], row[x + 2], row[x + 3] };
+                    float32x4_t dst = vcvtq_f32_u32(vld1q_u32(pixels));
 
-            src.a = color.a * coverage;
-            src.r = color.r * coverage;
-            src.g = color.g * coverage;
-            src.b = color.b * coverage;
+                    dst = vdivq_f32(dst, max_value);
+                    dst = vaddq_f32(src_a, vmulq_f32(dst, vsubq_f32(vdupq_n_f32(1.0f), src_a)));
 
-            CuiColor dst = cui_color_unpack_bgra(*pixel);
+                    vst1q_u32(pixels, vcvtq_u32_f32(vaddq_f32(vmulq_f32(dst, max_value), half)));
 
-            dst.a = src.a + dst.a * (1.0f - src.a);
-            dst.r = src.r + dst.r * (1.0f - src.a);
-            dst.g = src.g + dst.g * (1.0f - src.a);
-            dst.b = src.b + dst.b * (1.0f - src.a);
+                    row[x + 0] = (uint8_t) pixels[0];
+                    row[x + 1] = (uint8_t) pixels[1];
+                    row[x + 2] = (uint8_t) pixels[2];
+                    row[x + 3] = (uint8_t) pixels[3];
+                }
+#endif
+            }
 
-            *pixel++ = cui_color_pack_bgra(dst);
+            for (; x < x_end; x += 1)
+            {
+                if (coverage[x] > 0.0f)
+                {
+                    _cui_edge_list_blend_pixel(row, x, format, color, coverage[x]);
+                }
+            }
         }
 
         y_min += 1.0f;
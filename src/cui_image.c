@@ -1,3 +1,6 @@
+// Number of mcu rows that are transformed together, see cui_image_decode_jpeg().
+#define CUI_JPEG_BAND_ROW_COUNT 8
+
 static const uint8_t _cui_jpeg_zigzag[64] = {
      0,  1,  8, 16,  9,  2,  3, 10,
     17, 24, 32, 25, 18, 11,  4,  5,
@@ -318,6 +321,77 @@ cui_image_encode_bmp(CuiBitmap bitmap, bool top_to_bottom, bool bgra, CuiArena *
     return result;
 }
 
+static void
+_cui_jpeg_transform_band(void *data, int64_t begin, int64_t end)
+{
+    CuiJpegBand *band = (CuiJpegBand *) data;
+    CuiBitmap *bitmap = band->bitmap;
+
+    int32_t max_block_size_x = 8 * band->max_factor_x;
+    int32_t max_block_size_y = 8 * band->max_factor_y;
+    int32_t block_size = max_block_size_x * max_block_size_y;
+
+    // TODO: align to 16 bytes
+    float output_block[64];
+
+    for (int64_t band_row_index = begin; band_row_index < end; band_row_index += 1)
+    {
+        float *mcu = band->mcu + (band_row_index * 3 * block_size);
+        float *input_block = band->coefficients + (band_row_index * band->block_count_x * band->blocks_per_mcu * 64);
+
+        int32_t block_y = band->first_block_y + (int32_t) band_row_index;
+
+        for (int32_t block_x = 0; block_x < band->block_count_x; block_x += 1)
+        {
+            CuiJpegComponent *comp = band->components;
+
+            for (int32_t component_index = 0; component_index < band->component_count; component_index += 1)
+            {
+                for (int32_t sub_block_y = 0; sub_block_y < comp->factor_y; sub_block_y += 1)
+                {
+                    for (int32_t sub_block_x = 0; sub_block_x < comp->factor_x; sub_block_x += 1)
+                    {
+                        _cui_jpeg_inverse_cosinus_transform(output_block, input_block);
+                        input_block += 64;
+
+                        uint32_t repeat_x = band->max_factor_x / comp->factor_x;
+                        uint32_t repeat_y = band->max_factor_y / comp->factor_y;
+                        float *dst = mcu + (component_index * block_size) +
+                                           (sub_block_y * repeat_y * 8 * max_block_size_x) +
+                                           (sub_block_x * repeat_x * 8);
+
+                        for (uint32_t y = 0; y < 8; y++)
+                        {
+                            for (uint32_t ry = 0; ry < repeat_y; ry++)
+                            {
+                                float *row = dst;
+                                for (uint32_t x = 0; x < 8; x++)
+                                {
+                                    float value = output_block[y * 8 + x];
+                                    value = (value < 0) ? 0 : ((value > 255) ? 255 : value);
+                                    for (uint32_t rx = 0; rx < repeat_x; rx++)
+                                    {
+                                        *row++ = value;
+                                    }
+                                }
+                                dst += max_block_size_x;
+                            }
+                        }
+                    }
+                }
+
+                comp += 1;
+            }
+
+            uint8_t *row = (uint8_t *) bitmap->pixels +
+                                       (block_y * max_block_size_y * bitmap->stride) +
+                                       (4 * block_x * max_block_size_x);
+
+            _cui_jpeg_convert_color(mcu, row, max_block_size_x, max_block_size_y, bitmap->stride);
+        }
+    }
+}
+
 bool
 cui_image_decode_jpeg(CuiArena *temporary_memory, CuiBitmap *bitmap, CuiString data, CuiArena *arena,
                       CuiImageMetaData **meta_data, CuiArena *meta_data_arena)
@@ -669,13 +743,45 @@ cui_image_decode_jpeg(CuiArena *temporary_memory, CuiBitmap *bitmap, CuiString d
                     bitmap->pixels = cui_alloc(bitmap_arena, bitmap->stride * block_count_y * max_block_size_y,
                                                cui_make_allocation_params(false, 16));
 
+                    int32_t blocks_per_mcu = 0;
+
+                    for (int32_t component_index = 0; component_index < component_count; component_index += 1)
+                    {
+                        blocks_per_mcu += components[component_index].factor_x * components[component_index].factor_y;
+                    }
+
+                    // The entropy decoding is sequential, but the inverse cosinus transform and
+                    // the color conversion of a band of mcu rows can run in parallel to the decoding
+                    // of the next band. So there are two bands that are used alternately.
+                    int32_t band_row_count = cui_min_int32(block_count_y, CUI_JPEG_BAND_ROW_COUNT);
+                    int32_t band_coefficient_count = band_row_count * block_count_x * blocks_per_mcu * 64;
                     int32_t block_size = max_block_size_x * max_block_size_y;
 
-                    // TODO: align to 16 bytes
-                    float *mcu = cui_alloc_array(temporary_memory, float, 3 * block_size, CuiDefaultAllocationParams());
-                    // TODO: align to 16 bytes
-                    float *input_block = cui_alloc_array(temporary_memory, float, 2 * 64, CuiDefaultAllocationParams());
-                    float *output_block = input_block + 64;
+                    CuiJpegBand bands[2];
+
+#ifndef CUI_NO_BACKEND
+                    CuiTaskGroup band_task_groups[2] = { 0 };
+#endif
+
+                    for (uint32_t band_index = 0; band_index < CuiArrayCount(bands); band_index += 1)
+                    {
+                        CuiJpegBand *band = bands + band_index;
+
+                        band->bitmap = bitmap;
+                        band->components = components;
+                        band->component_count = component_count;
+                        band->max_factor_x = max_factor_x;
+                        band->max_factor_y = max_factor_y;
+                        band->block_count_x = block_count_x;
+                        band->blocks_per_mcu = blocks_per_mcu;
+                        band->first_block_y = 0;
+                        // TODO: align to 16 bytes
+                        band->coefficients = cui_alloc_array(temporary_memory, float, band_coefficient_count, CuiDefaultAllocationParams());
+                        band->mcu = cui_alloc_array(temporary_memory, float, band_row_count * 3 * block_size, CuiDefaultAllocationParams());
+                    }
+
+                    int32_t current_band_index = 0;
+                    float *input_block = bands[0].coefficients;
 
                     CuiJpegBitReader reader = _cui_jpeg_begin_bit_reader(&cursor);
 
@@ -748,39 +854,7 @@ cui_image_decode_jpeg(CuiArena *temporary_memory, CuiBitmap *bitmap, CuiString d
 
                                         if (!result) break;
 
-#if 0
-                                        transform_interval -= cui_platform_get_performance_counter();
-#endif
-
-                                        _cui_jpeg_inverse_cosinus_transform(output_block, input_block);
-
-#if 0
-                                        transform_interval += cui_platform_get_performance_counter();
-#endif
-
-                                        uint32_t repeat_x = max_factor_x / comp->factor_x;
-                                        uint32_t repeat_y = max_factor_y / comp->factor_y;
-                                        float *dst = mcu + (component_index * block_size) +
-                                                           (sub_block_y * repeat_y * 8 * max_block_size_x) +
-                                                           (sub_block_x * repeat_x * 8);
-
-                                        for (uint32_t y = 0; y < 8; y++)
-                                        {
-                                            for (uint32_t ry = 0; ry < repeat_y; ry++)
-                                            {
-                                                float *row = dst;
-                                                for (uint32_t x = 0; x < 8; x++)
-                                                {
-                                                    float value = output_block[y * 8 + x];
-                                                    value = (value < 0) ? 0 : ((value > 255) ? 255 : value);
-                                                    for (uint32_t rx = 0; rx < repeat_x; rx++)
-                                                    {
-                                                        *row++ = value;
-                                                    }
-                                                }
-                                                dst += max_block_size_x;
-                                            }
-                                        }
+                                        input_block += 64;
                                     }
 
                                     if (!result) break;
@@ -793,26 +867,48 @@ cui_image_decode_jpeg(CuiArena *temporary_memory, CuiBitmap *bitmap, CuiString d
 
                             if (!result) break;
 
-                            uint8_t *row = (uint8_t *) bitmap->pixels +
-                                                       (block_y * max_block_size_y * bitmap->stride) +
-                                                       (4 * block_x * max_block_size_x);
+                            // reset marker
+                        }
 
+                        if (!result) break;
+
+                        CuiJpegBand *band = bands + current_band_index;
+                        int32_t band_row_index = block_y - band->first_block_y;
+
+                        if (((band_row_index + 1) == band_row_count) || ((block_y + 1) == block_count_y))
+                        {
 #if 0
-                            color_transform_interval -= cui_platform_get_performance_counter();
+                            transform_interval -= cui_platform_get_performance_counter();
 #endif
 
-                            _cui_jpeg_convert_color(mcu, row, max_block_size_x, max_block_size_y, bitmap->stride);
+#ifndef CUI_NO_BACKEND
+                            cui_task_group_parallel_for(band_task_groups + current_band_index, band_row_index + 1, 1,
+                                                        _cui_jpeg_transform_band, band);
+#else
+                            _cui_jpeg_transform_band(band, 0, band_row_index + 1);
+#endif
 
 #if 0
-                            color_transform_interval += cui_platform_get_performance_counter();
+                            transform_interval += cui_platform_get_performance_counter();
 #endif
 
-                            // reset marker
-                        }
+                            current_band_index = (current_band_index + 1) % CuiArrayCount(bands);
+                            band = bands + current_band_index;
 
-                        if (!result) break;
+#ifndef CUI_NO_BACKEND
+                            cui_task_group_wait(band_task_groups + current_band_index);
+#endif
+
+                            band->first_block_y = block_y + 1;
+                            input_block = band->coefficients;
+                        }
                     }
 
+#ifndef CUI_NO_BACKEND
+                    cui_task_group_wait(band_task_groups + 0);
+                    cui_task_group_wait(band_task_groups + 1);
+#endif
+
                     switch (orientation)
                     {
                         case 1: // normal
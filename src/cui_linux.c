@@ -710,6 +710,12 @@ _cui_initialize_opengles2_x11(CuiWindow *window, XSetWindowAttributes window_att
 static void
 _cui_window_destroy(CuiWindow *window)
 {
+    _cui_window_store_glyph_cache(window);
+    _cui_window_deallocate_retained_drawings(window);
+    _cui_window_deallocate_glyph_rasterizations(window);
+    _cui_window_deallocate_glyph_caches(window);
+    _cui_window_deallocate_texture_slots(window);
+
     switch (_cui_context.backend)
     {
         case CUI_LINUX_BACKEND_NONE:
@@ -1015,6 +1021,25 @@ _cui_wayland_resize_framebuffer(CuiLinuxFramebuffer *framebuffer, int32_t width,
     wl_buffer_add_listener(framebuffer->backend.wayland.buffer, &_cui_wayland_buffer_listener, framebuffer);
 }
 
+static void
+_cui_wayland_damage_framebuffer(CuiWindow *window, CuiLinuxFramebuffer *framebuffer)
+{
+    if (_cui_context.wayland_compositor_version >= WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION)
+    {
+        for (int32_t index = 0; index < framebuffer->base.dirty_rect_count; index += 1)
+        {
+            CuiRect rect = framebuffer->base.dirty_rects[index];
+            wl_surface_damage_buffer(window->wayland_surface, rect.min.x, rect.min.y,
+                                     cui_rect_get_width(rect), cui_rect_get_height(rect));
+        }
+    }
+    else if (framebuffer->base.dirty_rect_count > 0)
+    {
+        // Surface damage would have to be converted by the buffer scale and viewport.
+        wl_surface_damage(window->wayland_surface, 0, 0, INT32_MAX, INT32_MAX);
+    }
+}
+
 static void
 _cui_wayland_acquire_framebuffer(CuiWindow *window, int32_t width, int32_t height)
 {
@@ -1808,7 +1833,7 @@ _cui_wayland_handle_xdg_surface_configure(void *data, struct xdg_surface *xdg_su
                     CuiLinuxFramebuffer *framebuffer = window->current_framebuffer;
 
                     wl_surface_attach(window->wayland_surface, framebuffer->backend.wayland.buffer, 0, 0);
-                    wl_surface_damage(window->wayland_surface, 0, 0, INT32_MAX, INT32_MAX);
+                    _cui_wayland_damage_framebuffer(window, framebuffer);
                     wl_surface_commit(window->wayland_surface);
 
                     window->current_framebuffer = 0;
@@ -3079,6 +3104,14 @@ _cui_wayland_handle_key_down(CuiWindow *window, uint32_t keycode)
                     window->base.needs_redraw = true;
                 }
                 else
+#endif
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+                if (sym == XKB_KEY_F3)
+                {
+                    window->base.capture_command_buffer = true;
+                    window->base.needs_redraw = true;
+                }
+                else
 #endif
                 {
                     _CUI_KEY_DOWN_EVENT(CUI_KEY_F1 + (sym - XKB_KEY_F1));
@@ -3352,7 +3385,10 @@ _cui_wayland_handle_registry_add(void *data, struct wl_registry *registry, uint3
 
     if (cui_string_equals(interface_name, CuiCString(wl_compositor_interface.name)))
     {
-        _cui_context.wayland_compositor = (struct wl_compositor *) wl_registry_bind(registry, name, &wl_compositor_interface, 3);
+        // Version 4 adds wl_surface_damage_buffer which is used for partial presents.
+        _cui_context.wayland_compositor_version = (version < 4) ? version : 4;
+        _cui_context.wayland_compositor = (struct wl_compositor *) wl_registry_bind(registry, name, &wl_compositor_interface,
+                                                                                    _cui_context.wayland_compositor_version);
     }
     else if (cui_string_equals(interface_name, CuiCString(xdg_wm_base_interface.name)))
     {
@@ -4275,7 +4311,12 @@ cui_init(int argument_count, char **arguments)
 
     int32_t worker_thread_count = cui_platform_get_performance_core_count() - 1;
 
-    worker_thread_count = cui_max_int32(1, cui_min_int32(worker_thread_count, 15));
+    worker_thread_count = cui_max_int32(1, worker_thread_count);
+
+    if (!_cui_init_worker_thread_queue(&_cui_context.common.worker_thread_queue, worker_thread_count))
+    {
+        return false;
+    }
 
     pthread_cond_init(&_cui_context.common.worker_thread_queue.semaphore_cond, 0);
     pthread_mutex_init(&_cui_context.common.worker_thread_queue.semaphore_mutex, 0);
@@ -4291,7 +4332,7 @@ cui_init(int argument_count, char **arguments)
          worker_thread_index += 1)
     {
         pthread_t worker_thread;
-        pthread_create(&worker_thread, 0, _cui_worker_thread_proc, 0);
+        pthread_create(&worker_thread, 0, _cui_worker_thread_proc, (void *) (uintptr_t) (worker_thread_index + 1));
     }
 
     pthread_t interactive_background_thread;
@@ -5264,7 +5305,7 @@ cui_step(void)
                                 CuiLinuxFramebuffer *framebuffer = window->current_framebuffer;
 
                                 wl_surface_attach(window->wayland_surface, framebuffer->backend.wayland.buffer, 0, 0);
-                                wl_surface_damage(window->wayland_surface, 0, 0, INT32_MAX, INT32_MAX);
+                                _cui_wayland_damage_framebuffer(window, framebuffer);
                                 wl_surface_commit(window->wayland_surface);
 
                                 window->current_framebuffer = 0;
@@ -5547,6 +5588,7 @@ cui_step(void)
                     case Expose:
                     {
                         window->base.needs_redraw = true;
+                        window->x11_needs_full_present = true;
                     } break;
 
                     case ConfigureNotify:
@@ -5714,6 +5756,14 @@ cui_step(void)
                                         window->base.needs_redraw = true;
                                     }
                                     else
+#endif
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+                                    if (key == XK_F3)
+                                    {
+                                        window->base.capture_command_buffer = true;
+                                        window->base.needs_redraw = true;
+                                    }
+                                    else
 #endif
                                     {
                                         _CUI_KEY_DOWN_EVENT(CUI_KEY_F1 + (key - XK_F1));
@@ -5808,18 +5858,42 @@ cui_step(void)
                                 backbuffer.green_mask = 0x00FF00;
                                 backbuffer.blue_mask = 0x0000FF;
 
-                                if (_cui_context.has_shared_memory_extension)
+                                int32_t dirty_rect_count = framebuffer->base.dirty_rect_count;
+                                CuiRect *dirty_rects = framebuffer->base.dirty_rects;
+                                CuiRect full_rect = cui_make_rect(0, 0, backbuffer.width, backbuffer.height);
+
+                                if (window->x11_needs_full_present)
+                                {
+                                    dirty_rect_count = 1;
+                                    dirty_rects = &full_rect;
+                                    window->x11_needs_full_present = false;
+                                }
+
+                                if (_cui_context.has_shared_memory_extension && (dirty_rect_count > 0))
                                 {
                                     backbuffer.width = CuiAlign(backbuffer.width, 16);
                                     backbuffer.obdata = (char *) &framebuffer->backend.x11.shared_memory_info;
 
-                                    XShmPutImage(_cui_context.x11_display, window->x11_window, _cui_context.x11_default_gc, &backbuffer,
-                                                 0, 0, 0, 0, backbuffer.width, backbuffer.height, True);
+                                    // Only the last put sends the completion event that marks the framebuffer as not busy.
+                                    for (int32_t index = 0; index < dirty_rect_count; index += 1)
+                                    {
+                                        CuiRect rect = dirty_rects[index];
+
+                                        XShmPutImage(_cui_context.x11_display, window->x11_window, _cui_context.x11_default_gc, &backbuffer,
+                                                     rect.min.x, rect.min.y, rect.min.x, rect.min.y, cui_rect_get_width(rect),
+                                                     cui_rect_get_height(rect), (index == (dirty_rect_count - 1)) ? True : False);
+                                    }
                                 }
                                 else
                                 {
-                                    XPutImage(_cui_context.x11_display, window->x11_window, _cui_context.x11_default_gc, &backbuffer,
-                                              0, 0, 0, 0, backbuffer.width, backbuffer.height);
+                                    for (int32_t index = 0; index < dirty_rect_count; index += 1)
+                                    {
+                                        CuiRect rect = dirty_rects[index];
+
+                                        XPutImage(_cui_context.x11_display, window->x11_window, _cui_context.x11_default_gc, &backbuffer,
+                                                  rect.min.x, rect.min.y, rect.min.x, rect.min.y, cui_rect_get_width(rect), cui_rect_get_height(rect));
+                                    }
+
                                     XFlush(_cui_context.x11_display);
 
                                     framebuffer->is_busy = false;
@@ -247,6 +247,7 @@ struct CuiWindow
 #if CUI_BACKEND_X11_ENABLED
 
     bool first_frame;
+    bool x11_needs_full_present;
 
     int32_t windowed_x;
     int32_t windowed_y;
@@ -416,6 +417,7 @@ typedef struct CuiContext
     CuiWaylandTouchEvent *wayland_touch_events;
 
     uint32_t wayland_seat_version;
+    uint32_t wayland_compositor_version;
 
     struct wl_display *wayland_display;
     struct wl_compositor *wayland_compositor;
@@ -273,6 +273,12 @@ _cui_window_set_fullscreen(CuiWindow *window, bool fullscreen)
 static void
 _cui_window_destroy(CuiWindow *window)
 {
+    _cui_window_store_glyph_cache(window);
+    _cui_window_deallocate_retained_drawings(window);
+    _cui_window_deallocate_glyph_rasterizations(window);
+    _cui_window_deallocate_glyph_caches(window);
+    _cui_window_deallocate_texture_slots(window);
+
     switch (window->base.renderer->type)
     {
         case CUI_RENDERER_TYPE_SOFTWARE:
@@ -802,7 +808,15 @@ _cui_window_close(CuiWindow *window)
             _CUI_KEY_DOWN_EVENT(CUI_KEY_F2);
 #endif
         } break;
-        case kVK_F3:         { _CUI_KEY_DOWN_EVENT(CUI_KEY_F3);        } break;
+        case kVK_F3:
+        {
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+            cui_window->base.capture_command_buffer = true;
+            cui_window->base.needs_redraw = true;
+#else
+            _CUI_KEY_DOWN_EVENT(CUI_KEY_F3);
+#endif
+        } break;
         case kVK_F4:         { _CUI_KEY_DOWN_EVENT(CUI_KEY_F4);        } break;
         case kVK_F5:         { _CUI_KEY_DOWN_EVENT(CUI_KEY_F5);        } break;
         case kVK_F6:         { _CUI_KEY_DOWN_EVENT(CUI_KEY_F6);        } break;
@@ -1158,7 +1172,12 @@ cui_init(int argument_count, char **arguments)
 
     int32_t worker_thread_count = cui_platform_get_performance_core_count() - 1;
 
-    worker_thread_count = cui_max_int32(1, cui_min_int32(worker_thread_count, 15));
+    worker_thread_count = cui_max_int32(1, worker_thread_count);
+
+    if (!_cui_init_worker_thread_queue(&_cui_context.common.worker_thread_queue, worker_thread_count))
+    {
+        return false;
+    }
 
     pthread_cond_init(&_cui_context.common.worker_thread_queue.semaphore_cond, 0);
     pthread_mutex_init(&_cui_context.common.worker_thread_queue.semaphore_mutex, 0);
@@ -1186,7 +1205,7 @@ cui_init(int argument_count, char **arguments)
          worker_thread_index += 1)
     {
         pthread_t worker_thread;
-        pthread_create(&worker_thread, &worker_thread_attr, _cui_worker_thread_proc, 0);
+        pthread_create(&worker_thread, &worker_thread_attr, _cui_worker_thread_proc, (void *) (uintptr_t) (worker_thread_index + 1));
     }
 
     pthread_t interactive_background_thread;
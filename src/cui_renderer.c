@@ -49,9 +49,152 @@ _cui_renderer_begin_command_buffer(CuiRenderer *renderer)
     return command_buffer;
 }
 
+// Returns the textures that are currently allocated in the renderer.
+static inline CuiTextureTable *
+_cui_renderer_get_texture_table(CuiRenderer *renderer)
+{
+    CuiTextureTable *texture_table = 0;
+
+    switch (renderer->type)
+    {
+        case CUI_RENDERER_TYPE_SOFTWARE:
+        {
+#if CUI_RENDERER_SOFTWARE_ENABLED
+            CuiRendererSoftware *renderer_software = CuiContainerOf(renderer, CuiRendererSoftware, base);
+            texture_table = &renderer_software->texture_table;
+#else
+            CuiAssert(!"CUI_RENDERER_TYPE_SOFTWARE not enabled.");
+#endif
+        } break;
+
+        case CUI_RENDERER_TYPE_OPENGLES2:
+        {
+#if CUI_RENDERER_OPENGLES2_ENABLED
+            CuiRendererOpengles2 *renderer_opengles2 = CuiContainerOf(renderer, CuiRendererOpengles2, base);
+            texture_table = &renderer_opengles2->texture_table;
+#else
+            CuiAssert(!"CUI_RENDERER_TYPE_OPENGLES2 not enabled.");
+#endif
+        } break;
+
+        case CUI_RENDERER_TYPE_METAL:
+        {
+#if CUI_RENDERER_METAL_ENABLED
+            CuiRendererMetal *renderer_metal = CuiContainerOf(renderer, CuiRendererMetal, base);
+            texture_table = &renderer_metal->texture_table;
+#else
+            CuiAssert(!"CUI_RENDERER_TYPE_METAL not enabled.");
+#endif
+        } break;
+
+        case CUI_RENDERER_TYPE_DIRECT3D11:
+        {
+#if CUI_RENDERER_DIRECT3D11_ENABLED
+            CuiRendererDirect3D11 *renderer_direct3d11 = CuiContainerOf(renderer, CuiRendererDirect3D11, base);
+            texture_table = &renderer_direct3d11->texture_table;
+#else
+            CuiAssert(!"CUI_RENDERER_TYPE_DIRECT3D11 not enabled.");
+#endif
+        } break;
+    }
+
+    return texture_table;
+}
+
+// Metal and Direct3D 11 bind all textures at once, so they only support a fixed number of textures.
+static inline uint32_t
+_cui_renderer_get_max_texture_count(CuiRenderer *renderer)
+{
+    uint32_t max_texture_count = CUI_MAX_TEXTURE_COUNT;
+
+    switch (renderer->type)
+    {
+        case CUI_RENDERER_TYPE_SOFTWARE:
+        case CUI_RENDERER_TYPE_OPENGLES2:
+        {
+            max_texture_count = CUI_MAX_TEXTURE_TABLE_COUNT;
+        } break;
+
+        case CUI_RENDERER_TYPE_METAL:
+        case CUI_RENDERER_TYPE_DIRECT3D11:
+        {
+            max_texture_count = CUI_MAX_TEXTURE_COUNT;
+        } break;
+    }
+
+    return max_texture_count;
+}
+
+// Only the software renderer culls occluded primitives, the other renderers ignore this setting.
+static inline void
+_cui_renderer_set_occlusion_culling(CuiRenderer *renderer, bool enabled)
+{
+    switch (renderer->type)
+    {
+        case CUI_RENDERER_TYPE_SOFTWARE:
+        {
+#if CUI_RENDERER_SOFTWARE_ENABLED
+            CuiRendererSoftware *renderer_software = CuiContainerOf(renderer, CuiRendererSoftware, base);
+
+            if (renderer_software->occlusion_culling_enabled != enabled)
+            {
+                renderer_software->occlusion_culling_enabled = enabled;
+
+                // NOTE: The tile hashes were taken with the previous setting, so the next frame redraws all tiles.
+                renderer_software->tile_state_width = 0;
+                renderer_software->tile_state_height = 0;
+            }
+#else
+            (void) enabled;
+            CuiAssert(!"CUI_RENDERER_TYPE_SOFTWARE not enabled.");
+#endif
+        } break;
+
+        case CUI_RENDERER_TYPE_OPENGLES2:
+        case CUI_RENDERER_TYPE_METAL:
+        case CUI_RENDERER_TYPE_DIRECT3D11:
+        {
+            (void) enabled;
+        } break;
+    }
+}
+
+static inline bool
+_cui_renderer_get_occlusion_culling(CuiRenderer *renderer)
+{
+    bool enabled = false;
+
+    switch (renderer->type)
+    {
+        case CUI_RENDERER_TYPE_SOFTWARE:
+        {
+#if CUI_RENDERER_SOFTWARE_ENABLED
+            CuiRendererSoftware *renderer_software = CuiContainerOf(renderer, CuiRendererSoftware, base);
+            enabled = renderer_software->occlusion_culling_enabled;
+#else
+            CuiAssert(!"CUI_RENDERER_TYPE_SOFTWARE not enabled.");
+#endif
+        } break;
+
+        case CUI_RENDERER_TYPE_OPENGLES2:
+        case CUI_RENDERER_TYPE_METAL:
+        case CUI_RENDERER_TYPE_DIRECT3D11:
+        {
+        } break;
+    }
+
+    return enabled;
+}
+
 static inline void
 _cui_renderer_render(CuiRenderer *renderer, CuiFramebuffer *framebuffer, CuiCommandBuffer *command_buffer, CuiColor clear_color)
 {
+    _cui_command_buffer_finish(command_buffer);
+
+#if CUI_PRIMITIVE_MERGING_ENABLED
+    _cui_command_buffer_merge_primitives(command_buffer);
+#endif
+
     switch (renderer->type)
     {
         case CUI_RENDERER_TYPE_SOFTWARE:
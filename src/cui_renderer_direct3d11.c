@@ -1,17 +1,12 @@
+// The vertex buffer gets drawn and refilled when it is full.
+static const uint32_t _CUI_DIRECT3D11_MAX_VERTEX_COUNT = 16 * 1024 * 6;
+
 static CuiRenderer *
 _cui_renderer_direct3d11_create(ID3D11Device *d3d11_device, ID3D11DeviceContext *d3d11_device_context, IDXGISwapChain1 *dxgi_swapchain)
 {
-    uint64_t renderer_size          = CuiAlign(sizeof(CuiRendererDirect3D11), 16);
-    uint64_t texture_operation_size = CuiAlign(_CUI_MAX_TEXTURE_OPERATION_COUNT * sizeof(CuiTextureOperation), 16);
-    uint64_t index_buffer_size      = CuiAlign(_CUI_MAX_INDEX_BUFFER_COUNT * sizeof(uint32_t), 16);
-    uint64_t push_buffer_size       = CuiAlign(_CUI_MAX_PUSH_BUFFER_SIZE, 16);
-
-    uint64_t allocation_size = renderer_size + texture_operation_size + index_buffer_size + push_buffer_size;
-
-    uint8_t *allocation = (uint8_t *) cui_platform_allocate(allocation_size);
+    uint64_t allocation_size = CuiAlign(sizeof(CuiRendererDirect3D11), 16);
 
-    CuiRendererDirect3D11 *renderer = (CuiRendererDirect3D11 *) allocation;
-    allocation += renderer_size;
+    CuiRendererDirect3D11 *renderer = (CuiRendererDirect3D11 *) cui_platform_allocate(allocation_size);
 
     CuiClearStruct(*renderer);
 
@@ -23,16 +18,7 @@ _cui_renderer_direct3d11_create(ID3D11Device *d3d11_device, ID3D11DeviceContext
     command_buffer->max_texture_width  = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
     command_buffer->max_texture_height = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
 
-    command_buffer->max_texture_operation_count = _CUI_MAX_TEXTURE_OPERATION_COUNT;
-    command_buffer->texture_operations = (CuiTextureOperation *) allocation;
-    allocation += texture_operation_size;
-
-    command_buffer->max_index_buffer_count = _CUI_MAX_INDEX_BUFFER_COUNT;
-    command_buffer->index_buffer = (uint32_t *) allocation;
-    allocation += index_buffer_size;
-
-    command_buffer->max_push_buffer_size = _CUI_MAX_PUSH_BUFFER_SIZE;
-    command_buffer->push_buffer = (uint8_t *) allocation;
+    _cui_command_buffer_allocate(command_buffer);
 
     renderer->device         = d3d11_device;
     renderer->device_context = d3d11_device_context;
@@ -137,7 +123,7 @@ _cui_renderer_direct3d11_create(ID3D11Device *d3d11_device, ID3D11DeviceContext
     // TODO: check for errors
     ID3D11Device_CreateBuffer(renderer->device, &constant_buffer_description, 0, &renderer->constant_buffer);
 
-    int32_t vertex_buffer_size = _CUI_MAX_INDEX_BUFFER_COUNT * 6 * sizeof(CuiDirect3D11Vertex);
+    int32_t vertex_buffer_size = _CUI_DIRECT3D11_MAX_VERTEX_COUNT * sizeof(CuiDirect3D11Vertex);
 
     D3D11_BUFFER_DESC vertex_buffer_description;
     vertex_buffer_description.ByteWidth           = vertex_buffer_size;
@@ -221,6 +207,9 @@ _cui_renderer_direct3d11_destroy(CuiRendererDirect3D11 *renderer)
     ID3D11PixelShader_Release(renderer->pixel_shader);
     ID3D11VertexShader_Release(renderer->vertex_shader);
 
+    _cui_command_buffer_deallocate(&renderer->command_buffer);
+    _cui_texture_table_destroy(&renderer->texture_table);
+
     cui_platform_deallocate(renderer, renderer->allocation_size);
 }
 
@@ -229,9 +218,7 @@ _cui_renderer_direct3d11_begin_command_buffer(CuiRendererDirect3D11 *renderer)
 {
     CuiCommandBuffer *command_buffer = &renderer->command_buffer;
 
-    command_buffer->push_buffer_size = 0;
-    command_buffer->index_buffer_count = 0;
-    command_buffer->texture_operation_count = 0;
+    _cui_command_buffer_reset(command_buffer);
 
     return command_buffer;
 }
@@ -245,16 +232,17 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
     {
         CuiTextureOperation *texture_op = command_buffer->texture_operations + index;
 
-        int32_t texture_id = texture_op->texture_id;
-        CuiAssert(texture_id >= 0);
-        CuiAssert(texture_id < CUI_MAX_TEXTURE_COUNT);
+        uint32_t texture_id = texture_op->texture_id;
+        uint32_t texture_index = _cui_texture_id_get_index(texture_id);
+        CuiAssert(texture_index < CUI_MAX_TEXTURE_COUNT);
 
         switch (texture_op->type)
         {
             case CUI_TEXTURE_OPERATION_ALLOCATE:
             {
                 CuiBitmap bitmap = texture_op->payload.bitmap;
-                renderer->bitmaps[texture_id] = bitmap;
+                _cui_texture_table_allocate(&renderer->texture_table, texture_id, (CuiTextureFormat) texture_op->format, bitmap,
+                                            4 * (uint64_t) bitmap.width * (uint64_t) bitmap.height);
 
                 D3D11_TEXTURE2D_DESC texture_description;
                 texture_description.Width              = bitmap.width;
@@ -270,7 +258,7 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
                 texture_description.MiscFlags          = 0;
 
                 // TODO: check for errors
-                ID3D11Device_CreateTexture2D(renderer->device, &texture_description, 0, renderer->textures + texture_id);
+                ID3D11Device_CreateTexture2D(renderer->device, &texture_description, 0, renderer->textures + texture_index);
 
                 D3D11_SHADER_RESOURCE_VIEW_DESC texture_view_description;
                 texture_view_description.Format                    = texture_description.Format;
@@ -279,8 +267,8 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
                 texture_view_description.Texture2D.MipLevels       = 1;
 
                 // TODO: check for errors
-                ID3D11Device_CreateShaderResourceView(renderer->device, (ID3D11Resource *) renderer->textures[texture_id],
-                                                      &texture_view_description, renderer->texture_views + texture_id);
+                ID3D11Device_CreateShaderResourceView(renderer->device, (ID3D11Resource *) renderer->textures[texture_index],
+                                                      &texture_view_description, renderer->texture_views + texture_index);
 
                 D3D11_SAMPLER_DESC sampler_description;
                 sampler_description.Filter         = D3D11_FILTER_MIN_MAG_MIP_POINT;
@@ -298,32 +286,68 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
                 sampler_description.MaxLOD         = 0.0f;
 
                 // TODO: check for errors
-                ID3D11Device_CreateSamplerState(renderer->device, &sampler_description, renderer->samplers + texture_id);
+                ID3D11Device_CreateSamplerState(renderer->device, &sampler_description, renderer->samplers + texture_index);
             } break;
 
             case CUI_TEXTURE_OPERATION_DEALLOCATE:
             {
-                CuiClearStruct(renderer->bitmaps[texture_id]);
+                _cui_texture_table_deallocate(&renderer->texture_table, texture_id);
 
-                ID3D11SamplerState_Release(renderer->samplers[texture_id]);
-                ID3D11ShaderResourceView_Release(renderer->texture_views[texture_id]);
-                ID3D11Texture2D_Release(renderer->textures[texture_id]);
+                ID3D11SamplerState_Release(renderer->samplers[texture_index]);
+                ID3D11ShaderResourceView_Release(renderer->texture_views[texture_index]);
+                ID3D11Texture2D_Release(renderer->textures[texture_index]);
 
-                renderer->samplers[texture_id] = 0;
-                renderer->texture_views[texture_id] = 0;
-                renderer->textures[texture_id] = 0;
+                renderer->samplers[texture_index] = 0;
+                renderer->texture_views[texture_index] = 0;
+                renderer->textures[texture_index] = 0;
             } break;
 
             case CUI_TEXTURE_OPERATION_UPDATE:
             {
-                CuiRect rect = texture_op->payload.rect;
-                CuiBitmap bitmap = renderer->bitmaps[texture_id];
+                CuiTextureUpdate *update = &texture_op->payload.update;
+                CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, texture_id);
+                CuiBitmap bitmap = texture->bitmap;
 
-                D3D11_BOX region = { rect.min.x, rect.min.y, 0, rect.max.x, rect.max.y, 1 };
+                // NOTE: Direct3D textures are always BGRA8, so coverage gets expanded before the upload.
+                uint32_t *expanded_pixels = 0;
+                uint32_t expanded_size = 0;
 
-                ID3D11DeviceContext_UpdateSubresource(renderer->device_context, (ID3D11Resource *) renderer->textures[texture_id], 0,
-                                                      &region, (uint8_t *) bitmap.pixels + (rect.min.y * bitmap.stride) + (rect.min.x * 4),
-                                                      bitmap.stride, 0);
+                if (texture->format == CUI_TEXTURE_FORMAT_A8)
+                {
+                    for (uint32_t rect_index = 0; rect_index < update->rect_count; rect_index += 1)
+                    {
+                        CuiRect rect = update->rects[rect_index];
+                        expanded_size = cui_max_uint32(expanded_size, 4 * (uint32_t) (cui_rect_get_width(rect) *
+                                                                                      cui_rect_get_height(rect)));
+                    }
+
+                    expanded_pixels = (uint32_t *) cui_platform_allocate(expanded_size);
+                }
+
+                for (uint32_t rect_index = 0; rect_index < update->rect_count; rect_index += 1)
+                {
+                    CuiRect rect = update->rects[rect_index];
+
+                    D3D11_BOX region = { rect.min.x, rect.min.y, 0, rect.max.x, rect.max.y, 1 };
+
+                    uint8_t *pixels = (uint8_t *) bitmap.pixels + (rect.min.y * bitmap.stride) + (rect.min.x * 4);
+                    UINT row_pitch = bitmap.stride;
+
+                    if (expanded_pixels)
+                    {
+                        _cui_texture_expand_a8_to_bgra(expanded_pixels, bitmap, rect);
+                        pixels = (uint8_t *) expanded_pixels;
+                        row_pitch = 4 * cui_rect_get_width(rect);
+                    }
+
+                    ID3D11DeviceContext_UpdateSubresource(renderer->device_context, (ID3D11Resource *) renderer->textures[texture_index], 0,
+                                                          &region, pixels, row_pitch, 0);
+                }
+
+                if (expanded_pixels)
+                {
+                    cui_platform_deallocate(expanded_pixels, expanded_size);
+                }
             } break;
         }
     }
@@ -404,7 +428,10 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
 
         CuiTexturedRect *textured_rect = (CuiTexturedRect *) (command_buffer->push_buffer + rect_offset);
 
-        if ((textured_rect->texture_id != current_texture_id) || (textured_rect->clip_rect != current_clip_rect))
+        bool vertex_buffer_is_full = ((vertices - vertex_start) + 6) > _CUI_DIRECT3D11_MAX_VERTEX_COUNT;
+
+        if (vertex_buffer_is_full || (textured_rect->texture_id != current_texture_id) ||
+            (textured_rect->clip_rect != current_clip_rect))
         {
             int64_t vertex_count = vertices - vertex_start;
 
@@ -426,7 +453,8 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
 
             if (textured_rect->texture_id != current_texture_id)
             {
-                CuiBitmap bitmap = renderer->bitmaps[textured_rect->texture_id];
+                uint32_t texture_index = _cui_texture_id_get_index(textured_rect->texture_id);
+                CuiBitmap bitmap = _cui_texture_table_get(&renderer->texture_table, textured_rect->texture_id)->bitmap;
 
                 // TODO: check for errors
                 ID3D11DeviceContext_Map(renderer->device_context, (ID3D11Resource *) renderer->constant_buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapping);
@@ -437,8 +465,8 @@ _cui_renderer_direct3d11_render(CuiRendererDirect3D11 *renderer, CuiFramebuffer
 
                 ID3D11DeviceContext_Unmap(renderer->device_context, (ID3D11Resource*) renderer->constant_buffer, 0);
 
-                ID3D11DeviceContext_PSSetShaderResources(renderer->device_context, 0, 1, renderer->texture_views + textured_rect->texture_id);
-                ID3D11DeviceContext_PSSetSamplers(renderer->device_context, 0, 1, renderer->samplers + textured_rect->texture_id);
+                ID3D11DeviceContext_PSSetShaderResources(renderer->device_context, 0, 1, renderer->texture_views + texture_index);
+                ID3D11DeviceContext_PSSetSamplers(renderer->device_context, 0, 1, renderer->samplers + texture_index);
 
                 current_texture_id = textured_rect->texture_id;
             }
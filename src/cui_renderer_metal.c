@@ -3,15 +3,9 @@ _cui_renderer_metal_create(CuiArena *temporary_memory, id<MTLDevice> metal_devic
 {
     CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
 
-    uint64_t renderer_size          = CuiAlign(sizeof(CuiRendererMetal), 16);
-    uint64_t texture_operation_size = CuiAlign(_CUI_MAX_TEXTURE_OPERATION_COUNT * sizeof(CuiTextureOperation), 16);
+    uint64_t allocation_size = CuiAlign(sizeof(CuiRendererMetal), 16);
 
-    uint64_t allocation_size = renderer_size + texture_operation_size;
-
-    uint8_t *allocation = (uint8_t *) cui_platform_allocate(allocation_size);
-
-    CuiRendererMetal *renderer = (CuiRendererMetal *) allocation;
-    allocation += renderer_size;
+    CuiRendererMetal *renderer = (CuiRendererMetal *) cui_platform_allocate(allocation_size);
 
     CuiClearStruct(*renderer);
 
@@ -28,9 +22,7 @@ _cui_renderer_metal_create(CuiArena *temporary_memory, id<MTLDevice> metal_devic
     command_buffer->max_texture_width  = 16384;
     command_buffer->max_texture_height = 16384;
 
-    command_buffer->max_texture_operation_count = _CUI_MAX_TEXTURE_OPERATION_COUNT;
-    command_buffer->texture_operations = (CuiTextureOperation *) allocation;
-    allocation += texture_operation_size;
+    _cui_command_buffer_allocate(command_buffer);
 
     renderer->command_queue = [renderer->device newCommandQueue];
 
@@ -181,7 +173,7 @@ _cui_renderer_metal_create(CuiArena *temporary_memory, id<MTLDevice> metal_devic
         "    result.position      = vertex_transform * float4(position, 0.0f, 1.0f);\n"
         "    result.color         = rect->color;\n"
         "    result.uv            = uv;\n"
-        "    result.texture_index = rect->texture_index;\n"
+        "    result.texture_index = rect->texture_index & %u;\n"
         "\n"
         "    return result;\n"
         "}\n"
@@ -197,7 +189,7 @@ _cui_renderer_metal_create(CuiArena *temporary_memory, id<MTLDevice> metal_devic
         "    return half4(color * tex_sample);\n"
         "}\n");
 
-        shader_src = cui_sprint(temporary_memory, shader_src, CUI_MAX_TEXTURE_COUNT);
+        shader_src = cui_sprint(temporary_memory, shader_src, CUI_TEXTURE_ID_INDEX_MASK, CUI_MAX_TEXTURE_COUNT);
 
         NSString *shader_source = [[NSString alloc] initWithBytes: shader_src.data
                                                            length: shader_src.count
@@ -234,21 +226,15 @@ _cui_renderer_metal_create(CuiArena *temporary_memory, id<MTLDevice> metal_devic
 
             renderer->buffer_transform = [renderer->device newBufferWithLength: 16 * sizeof(float)
                                                                        options: MTLResourceStorageModeManaged];
-            renderer->push_buffer      = [renderer->device newBufferWithLength: _CUI_MAX_PUSH_BUFFER_SIZE
+            renderer->push_buffer      = [renderer->device newBufferWithLength: command_buffer->max_push_buffer_size
                                                                        options: MTLResourceStorageModeShared];
-            renderer->index_buffer     = [renderer->device newBufferWithLength: _CUI_MAX_INDEX_BUFFER_COUNT * sizeof(uint32_t)
+            renderer->index_buffer     = [renderer->device newBufferWithLength: command_buffer->max_index_buffer_count * sizeof(uint32_t)
                                                                        options: MTLResourceStorageModeShared];
 
             CuiAssert(renderer->buffer_transform.contents);
             CuiAssert(renderer->push_buffer.contents);
             CuiAssert(renderer->index_buffer.contents);
 
-            command_buffer->max_push_buffer_size = _CUI_MAX_PUSH_BUFFER_SIZE;
-            command_buffer->push_buffer = (uint8_t *) renderer->push_buffer.contents;
-
-            command_buffer->max_index_buffer_count = _CUI_MAX_INDEX_BUFFER_COUNT;
-            command_buffer->index_buffer = (uint32_t *) renderer->index_buffer.contents;
-
             success = true;
         }
         else
@@ -298,6 +284,9 @@ _cui_renderer_metal_destroy(CuiRendererMetal *renderer)
     [renderer->render_pass release];
     [renderer->command_queue release];
 
+    _cui_command_buffer_deallocate(&renderer->command_buffer);
+    _cui_texture_table_destroy(&renderer->texture_table);
+
     cui_platform_deallocate(renderer, renderer->allocation_size);
 }
 
@@ -306,9 +295,7 @@ _cui_renderer_metal_begin_command_buffer(CuiRendererMetal *renderer)
 {
     CuiCommandBuffer *command_buffer = &renderer->command_buffer;
 
-    command_buffer->push_buffer_size = 0;
-    command_buffer->index_buffer_count = 0;
-    command_buffer->texture_operation_count = 0;
+    _cui_command_buffer_reset(command_buffer);
 
     return command_buffer;
 }
@@ -323,16 +310,17 @@ _cui_renderer_metal_render(CuiRendererMetal *renderer, CuiFramebuffer *framebuff
     {
         CuiTextureOperation *texture_op = command_buffer->texture_operations + index;
 
-        int32_t texture_id = texture_op->texture_id;
-        CuiAssert(texture_id >= 0);
-        CuiAssert(texture_id < CUI_MAX_TEXTURE_COUNT);
+        uint32_t texture_id = texture_op->texture_id;
+        uint32_t texture_index = _cui_texture_id_get_index(texture_id);
+        CuiAssert(texture_index < CUI_MAX_TEXTURE_COUNT);
 
         switch (texture_op->type)
         {
             case CUI_TEXTURE_OPERATION_ALLOCATE:
             {
                 CuiBitmap bitmap = texture_op->payload.bitmap;
-                renderer->bitmaps[texture_id] = bitmap;
+                _cui_texture_table_allocate(&renderer->texture_table, texture_id, (CuiTextureFormat) texture_op->format, bitmap,
+                                            4 * (uint64_t) bitmap.width * (uint64_t) bitmap.height);
 
                 MTLTextureDescriptor *texture_descriptor = [MTLTextureDescriptor new];
                 texture_descriptor.pixelFormat = MTLPixelFormatBGRA8Unorm;
@@ -340,38 +328,97 @@ _cui_renderer_metal_render(CuiRendererMetal *renderer, CuiFramebuffer *framebuff
                 texture_descriptor.height      = bitmap.height;
                 texture_descriptor.storageMode = MTLStorageModeManaged;
 
-                renderer->textures[texture_id] = [renderer->device newTextureWithDescriptor: texture_descriptor];
+                renderer->textures[texture_index] = [renderer->device newTextureWithDescriptor: texture_descriptor];
 
                 [texture_descriptor release];
             } break;
 
             case CUI_TEXTURE_OPERATION_DEALLOCATE:
             {
-                CuiClearStruct(renderer->bitmaps[texture_id]);
-                [renderer->textures[texture_id] setPurgeableState: MTLPurgeableStateEmpty];
-                [renderer->textures[texture_id] release];
-                renderer->textures[texture_id] = 0;
+                _cui_texture_table_deallocate(&renderer->texture_table, texture_id);
+                [renderer->textures[texture_index] setPurgeableState: MTLPurgeableStateEmpty];
+                [renderer->textures[texture_index] release];
+                renderer->textures[texture_index] = 0;
             } break;
 
             case CUI_TEXTURE_OPERATION_UPDATE:
             {
-                CuiRect rect = texture_op->payload.rect;
-                CuiBitmap bitmap = renderer->bitmaps[texture_id];
+                CuiTextureUpdate *update = &texture_op->payload.update;
+                CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, texture_id);
+                CuiBitmap bitmap = texture->bitmap;
+
+                // NOTE: Metal textures are always BGRA8, so coverage gets expanded before the upload.
+                uint32_t *expanded_pixels = 0;
+                uint32_t expanded_size = 0;
+
+                if (texture->format == CUI_TEXTURE_FORMAT_A8)
+                {
+                    for (uint32_t rect_index = 0; rect_index < update->rect_count; rect_index += 1)
+                    {
+                        CuiRect rect = update->rects[rect_index];
+                        expanded_size = cui_max_uint32(expanded_size, 4 * (uint32_t) (cui_rect_get_width(rect) *
+                                                                                      cui_rect_get_height(rect)));
+                    }
+
+                    expanded_pixels = (uint32_t *) cui_platform_allocate(expanded_size);
+                }
+
+                for (uint32_t rect_index = 0; rect_index < update->rect_count; rect_index += 1)
+                {
+                    CuiRect rect = update->rects[rect_index];
+
+                    MTLRegion region = MTLRegionMake2D(rect.min.x, rect.min.y,
+                                                       cui_rect_get_width(rect),
+                                                       cui_rect_get_height(rect));
+
+                    uint8_t *pixels = (uint8_t *) bitmap.pixels + (rect.min.y * bitmap.stride) + (rect.min.x * 4);
+                    int64_t bytes_per_row = bitmap.stride;
+
+                    if (expanded_pixels)
+                    {
+                        _cui_texture_expand_a8_to_bgra(expanded_pixels, bitmap, rect);
+                        pixels = (uint8_t *) expanded_pixels;
+                        bytes_per_row = 4 * cui_rect_get_width(rect);
+                    }
+
+                    [renderer->textures[texture_index] replaceRegion: region
+                                                         mipmapLevel: 0
+                                                           withBytes: pixels
+                                                         bytesPerRow: bytes_per_row];
+                }
+
+                if (expanded_pixels)
+                {
+                    cui_platform_deallocate(expanded_pixels, expanded_size);
+                }
+            } break;
+        }
+    }
 
-                MTLRegion region = MTLRegionMake2D(rect.min.x, rect.min.y,
-                                                   cui_rect_get_width(rect),
-                                                   cui_rect_get_height(rect));
+    // The command buffer can grow, so the gpu buffers are resized to its capacity and get a copy of it.
+    if (renderer->push_buffer.length < command_buffer->max_push_buffer_size)
+    {
+        [renderer->push_buffer setPurgeableState: MTLPurgeableStateEmpty];
+        [renderer->push_buffer release];
 
-                uint8_t *pixels = (uint8_t *) bitmap.pixels + (rect.min.y * bitmap.stride) + (rect.min.x * 4);
+        renderer->push_buffer = [renderer->device newBufferWithLength: command_buffer->max_push_buffer_size
+                                                              options: MTLResourceStorageModeShared];
+        CuiAssert(renderer->push_buffer.contents);
+    }
 
-                [renderer->textures[texture_id] replaceRegion: region
-                                                  mipmapLevel: 0
-                                                    withBytes: pixels
-                                                  bytesPerRow: bitmap.stride];
-            } break;
-        }
+    if (renderer->index_buffer.length < (command_buffer->max_index_buffer_count * sizeof(uint32_t)))
+    {
+        [renderer->index_buffer setPurgeableState: MTLPurgeableStateEmpty];
+        [renderer->index_buffer release];
+
+        renderer->index_buffer = [renderer->device newBufferWithLength: command_buffer->max_index_buffer_count * sizeof(uint32_t)
+                                                               options: MTLResourceStorageModeShared];
+        CuiAssert(renderer->index_buffer.contents);
     }
 
+    cui_copy_memory(renderer->push_buffer.contents, command_buffer->push_buffer, command_buffer->push_buffer_size);
+    cui_copy_memory(renderer->index_buffer.contents, command_buffer->index_buffer, command_buffer->index_buffer_count * sizeof(uint32_t));
+
     id<MTLCommandBuffer> cmd_buffer = [renderer->command_queue commandBuffer];
 
     renderer->render_pass.colorAttachments[0].clearColor  = MTLClearColorMake(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
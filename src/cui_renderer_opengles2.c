@@ -77,6 +77,30 @@ _cui_renderer_opengles2_create_program(char *header_source, char *vertex_source,
     return program_id;
 }
 
+static inline GLenum
+_cui_renderer_opengles2_get_texture_format(CuiTextureFormat format)
+{
+    return (format == CUI_TEXTURE_FORMAT_A8) ? GL_ALPHA : GL_RGBA;
+}
+
+// Every rect needs 6 vertices and at most one draw command.
+static void
+_cui_renderer_opengles2_reserve_vertices(CuiRendererOpengles2 *renderer, uint32_t rect_count)
+{
+    if (renderer->vertices)
+    {
+        cui_platform_deallocate(renderer->vertices, renderer->max_rect_count * 6 * sizeof(CuiOpengles2Vertex));
+        cui_platform_deallocate(renderer->draw_list, renderer->max_rect_count * sizeof(CuiOpengles2DrawCommand));
+    }
+
+    renderer->max_rect_count = rect_count;
+    renderer->vertices = (CuiOpengles2Vertex *) cui_platform_allocate(rect_count * 6 * sizeof(CuiOpengles2Vertex));
+    renderer->draw_list = (CuiOpengles2DrawCommand *) cui_platform_allocate(rect_count * sizeof(CuiOpengles2DrawCommand));
+
+    glBindBuffer(GL_ARRAY_BUFFER, renderer->vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, rect_count * 6 * sizeof(CuiOpengles2Vertex), 0, GL_STREAM_DRAW);
+}
+
 static CuiRenderer *
 _cui_renderer_opengles2_create(void)
 {
@@ -112,20 +136,9 @@ _cui_renderer_opengles2_create(void)
         }
     }
 
-    uint64_t renderer_size          = CuiAlign(sizeof(CuiRendererOpengles2), 16);
-    uint64_t texture_operation_size = CuiAlign(_CUI_MAX_TEXTURE_OPERATION_COUNT * sizeof(CuiTextureOperation), 16);
-    uint64_t index_buffer_size      = CuiAlign(_CUI_MAX_INDEX_BUFFER_COUNT * sizeof(uint32_t), 16);
-    uint64_t push_buffer_size       = CuiAlign(_CUI_MAX_PUSH_BUFFER_SIZE, 16);
-    uint64_t vertex_buffer_size     = CuiAlign(_CUI_MAX_INDEX_BUFFER_COUNT * 6 * sizeof(CuiOpengles2Vertex), 16);
-    uint64_t draw_list_size         = CuiAlign(64 * sizeof(CuiOpengles2DrawCommand), 16);
-
-    uint64_t allocation_size = renderer_size + texture_operation_size + index_buffer_size +
-                               push_buffer_size + vertex_buffer_size + draw_list_size;
+    uint64_t allocation_size = CuiAlign(sizeof(CuiRendererOpengles2), 16);
 
-    uint8_t *allocation = (uint8_t *) cui_platform_allocate(allocation_size);
-
-    CuiRendererOpengles2 *renderer = (CuiRendererOpengles2 *) allocation;
-    allocation += renderer_size;
+    CuiRendererOpengles2 *renderer = (CuiRendererOpengles2 *) cui_platform_allocate(allocation_size);
 
     CuiClearStruct(*renderer);
 
@@ -146,27 +159,11 @@ _cui_renderer_opengles2_create(void)
     command_buffer->max_texture_width  = max_texture_size;
     command_buffer->max_texture_height = max_texture_size;
 
-    command_buffer->max_texture_operation_count = _CUI_MAX_TEXTURE_OPERATION_COUNT;
-    command_buffer->texture_operations = (CuiTextureOperation *) allocation;
-    allocation += texture_operation_size;
-
-    command_buffer->max_index_buffer_count = _CUI_MAX_INDEX_BUFFER_COUNT;
-    command_buffer->index_buffer = (uint32_t *) allocation;
-    allocation += index_buffer_size;
-
-    command_buffer->max_push_buffer_size = _CUI_MAX_PUSH_BUFFER_SIZE;
-    command_buffer->push_buffer = (uint8_t *) allocation;
-    allocation += push_buffer_size;
-
-    renderer->vertices = (CuiOpengles2Vertex *) allocation;
-    allocation += vertex_buffer_size;
-
-    renderer->draw_list = (CuiOpengles2DrawCommand *) allocation;
-    allocation += draw_list_size;
+    _cui_command_buffer_allocate(command_buffer);
 
     glGenBuffers(1, &renderer->vertex_buffer);
-    glBindBuffer(GL_ARRAY_BUFFER, renderer->vertex_buffer);
-    glBufferData(GL_ARRAY_BUFFER, vertex_buffer_size, 0, GL_STREAM_DRAW);
+
+    _cui_renderer_opengles2_reserve_vertices(renderer, command_buffer->max_index_buffer_count);
 
     char *header = (char *) "#version 100\n";
 
@@ -192,19 +189,22 @@ _cui_renderer_opengles2_create(void)
     "precision mediump float;\n"
     "\n"
     "uniform sampler2D u_texture;\n"
+    "uniform float u_alpha_texture;\n"
     "\n"
     "varying vec4 v_color;\n"
     "varying vec2 v_uv;\n"
     "\n"
     "void main()\n"
     "{\n"
-    "    gl_FragColor = v_color * texture2D(u_texture, v_uv).bgra;\n"
+    "    vec4 texel = texture2D(u_texture, v_uv);\n"
+    "    gl_FragColor = v_color * mix(texel.bgra, texel.aaaa, u_alpha_texture);\n"
     "}\n";
 
     renderer->program = _cui_renderer_opengles2_create_program(header, vertex_source, fragment_source);
     renderer->texture_scale_location = glGetUniformLocation(renderer->program, "u_texture_scale");
     renderer->vertex_scale_location = glGetUniformLocation(renderer->program, "u_vertex_scale");
     renderer->texture_location = glGetUniformLocation(renderer->program, "u_texture");
+    renderer->alpha_texture_location = glGetUniformLocation(renderer->program, "u_alpha_texture");
     renderer->position_location = glGetAttribLocation(renderer->program, "a_position");
     renderer->color_location = glGetAttribLocation(renderer->program, "a_color");
     renderer->uv_location = glGetAttribLocation(renderer->program, "a_uv");
@@ -217,68 +217,90 @@ _cui_renderer_opengles2_create(void)
 static void
 _cui_renderer_opengles2_destroy(CuiRendererOpengles2 *renderer)
 {
-    glDeleteTextures(CuiArrayCount(renderer->textures), renderer->textures);
+    for (uint32_t index = 0; index < renderer->texture_table.allocated; index += 1)
+    {
+        CuiTexture *texture = renderer->texture_table.textures + index;
+
+        if (texture->texture_id)
+        {
+            glDeleteTextures(1, &texture->backend_texture);
+        }
+    }
+
     glDeleteProgram(renderer->program);
     glDeleteBuffers(1, &renderer->vertex_buffer);
 
+    cui_platform_deallocate(renderer->vertices, renderer->max_rect_count * 6 * sizeof(CuiOpengles2Vertex));
+    cui_platform_deallocate(renderer->draw_list, renderer->max_rect_count * sizeof(CuiOpengles2DrawCommand));
+
+    _cui_command_buffer_deallocate(&renderer->command_buffer);
+    _cui_texture_table_destroy(&renderer->texture_table);
+
     cui_platform_deallocate(renderer, renderer->allocation_size);
 }
 
 #if CUI_PLATFORM_ANDROID
 
-static uint32_t
-_cui_renderer_opengles2_store_textures(CuiRendererOpengles2 *renderer, uint32_t max_texture_state_count, CuiTextureState *texture_states)
+// Moves the textures into 'texture_table', so that they can be uploaded again
+// when a new renderer is created after the EGL context was lost.
+static void
+_cui_renderer_opengles2_store_textures(CuiRendererOpengles2 *renderer, CuiTextureTable *texture_table)
 {
-    uint32_t count = 0;
+    *texture_table = renderer->texture_table;
+    CuiClearStruct(renderer->texture_table);
 
-    for (uint32_t texture_id = 0; texture_id < CuiArrayCount(renderer->textures); texture_id += 1)
+    for (uint32_t index = 0; index < texture_table->allocated; index += 1)
     {
-        if (renderer->textures[texture_id])
-        {
-            if (count < max_texture_state_count)
-            {
-                CuiTextureState *state = texture_states + count;
-                count += 1;
+        CuiTexture *texture = texture_table->textures + index;
 
-                state->texture_id = texture_id;
-                state->bitmap = renderer->bitmaps[texture_id];
-            }
+        if (texture->texture_id)
+        {
+            glDeleteTextures(1, &texture->backend_texture);
+            texture->backend_texture = 0;
         }
     }
-
-    return count;
 }
 
 static void
-_cui_renderer_opengles2_restore_textures(CuiRendererOpengles2 *renderer, uint32_t texture_state_count, CuiTextureState *texture_states)
+_cui_renderer_opengles2_restore_textures(CuiRendererOpengles2 *renderer, CuiTextureTable *texture_table)
 {
-    for (uint32_t i = 0; i < texture_state_count; i += 1)
+    CuiAssert(!renderer->texture_table.textures);
+
+    renderer->texture_table = *texture_table;
+    CuiClearStruct(*texture_table);
+
+    for (uint32_t index = 0; index < renderer->texture_table.allocated; index += 1)
     {
-        CuiTextureState *state = texture_states + i;
+        CuiTexture *texture = renderer->texture_table.textures + index;
+
+        if (!texture->texture_id)
+        {
+            continue;
+        }
 
-        int32_t texture_id = state->texture_id;
-        CuiBitmap bitmap = state->bitmap;
+        CuiBitmap bitmap = texture->bitmap;
 
-        glGenTextures(1, renderer->textures + texture_id);
-        glBindTexture(GL_TEXTURE_2D, renderer->textures[texture_id]);
+        GLenum format = _cui_renderer_opengles2_get_texture_format(texture->format);
+        int32_t bytes_per_pixel = _cui_texture_format_get_bytes_per_pixel(texture->format);
 
-        renderer->bitmaps[texture_id] = bitmap;
+        glGenTextures(1, &texture->backend_texture);
+        glBindTexture(GL_TEXTURE_2D, texture->backend_texture);
 
-        if (bitmap.stride == (bitmap.width * 4))
+        if (bitmap.stride == (bitmap.width * bytes_per_pixel))
         {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap.width, bitmap.height,
-                         0, GL_RGBA, GL_UNSIGNED_BYTE, bitmap.pixels);
+            glTexImage2D(GL_TEXTURE_2D, 0, format, bitmap.width, bitmap.height,
+                         0, format, GL_UNSIGNED_BYTE, bitmap.pixels);
         }
         else
         {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap.width, bitmap.height,
-                         0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            glTexImage2D(GL_TEXTURE_2D, 0, format, bitmap.width, bitmap.height,
+                         0, format, GL_UNSIGNED_BYTE, 0);
 
-            int32_t row_length = bitmap.stride >> 2;
+            int32_t row_length = bitmap.stride / bytes_per_pixel;
 
             glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, row_length);
             glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, bitmap.width, bitmap.height,
-                            GL_RGBA, GL_UNSIGNED_BYTE, bitmap.pixels);
+                            format, GL_UNSIGNED_BYTE, bitmap.pixels);
             glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
         }
 
@@ -296,9 +318,7 @@ _cui_renderer_opengles2_begin_command_buffer(CuiRendererOpengles2 *renderer)
 {
     CuiCommandBuffer *command_buffer = &renderer->command_buffer;
 
-    command_buffer->push_buffer_size = 0;
-    command_buffer->index_buffer_count = 0;
-    command_buffer->texture_operation_count = 0;
+    _cui_command_buffer_reset(command_buffer);
 
     return command_buffer;
 }
@@ -316,24 +336,29 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
     {
         CuiTextureOperation *texture_op = command_buffer->texture_operations + index;
 
-        int32_t texture_id = texture_op->texture_id;
-        CuiAssert(texture_id >= 0);
-        CuiAssert(texture_id < CUI_MAX_TEXTURE_COUNT);
+        uint32_t texture_id = texture_op->texture_id;
 
         switch (texture_op->type)
         {
             case CUI_TEXTURE_OPERATION_ALLOCATE:
             {
-                glGenTextures(1, renderer->textures + texture_id);
-                glBindTexture(GL_TEXTURE_2D, renderer->textures[texture_id]);
-
                 CuiBitmap bitmap = texture_op->payload.bitmap;
-                renderer->bitmaps[texture_id] = bitmap;
+                CuiTextureFormat texture_format = (CuiTextureFormat) texture_op->format;
+                int32_t bytes_per_pixel = _cui_texture_format_get_bytes_per_pixel(texture_format);
+
+                CuiTexture *texture = _cui_texture_table_allocate(&renderer->texture_table, texture_id, texture_format, bitmap,
+                                                                  (uint64_t) bytes_per_pixel * (uint64_t) bitmap.width *
+                                                                  (uint64_t) bitmap.height);
+
+                glGenTextures(1, &texture->backend_texture);
+                glBindTexture(GL_TEXTURE_2D, texture->backend_texture);
 
                 CuiAssert(!(bitmap.stride & 3));
 
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap.width, bitmap.height,
-                             0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+                GLenum format = _cui_renderer_opengles2_get_texture_format(texture_format);
+
+                glTexImage2D(GL_TEXTURE_2D, 0, format, bitmap.width, bitmap.height,
+                             0, format, GL_UNSIGNED_BYTE, 0);
 
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -343,29 +368,45 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
 
             case CUI_TEXTURE_OPERATION_DEALLOCATE:
             {
-                CuiClearStruct(renderer->bitmaps[texture_id]);
-                glDeleteTextures(1, renderer->textures + texture_id);
-                renderer->textures[texture_id] = 0;
+                CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, texture_id);
+
+                glDeleteTextures(1, &texture->backend_texture);
+                _cui_texture_table_deallocate(&renderer->texture_table, texture_id);
             } break;
 
             case CUI_TEXTURE_OPERATION_UPDATE:
             {
-                CuiRect rect = texture_op->payload.rect;
-                CuiBitmap bitmap = renderer->bitmaps[texture_id];
+                CuiTextureUpdate *update = &texture_op->payload.update;
+                CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, texture_id);
+                CuiBitmap bitmap = texture->bitmap;
 
-                glBindTexture(GL_TEXTURE_2D, renderer->textures[texture_id]);
+                glBindTexture(GL_TEXTURE_2D, texture->backend_texture);
 
-                int32_t row_length = bitmap.stride >> 2;
+                GLenum format = _cui_renderer_opengles2_get_texture_format(texture->format);
+                int32_t bytes_per_pixel = _cui_texture_format_get_bytes_per_pixel(texture->format);
+                int32_t row_length = bitmap.stride / bytes_per_pixel;
 
                 glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, row_length);
-                glTexSubImage2D(GL_TEXTURE_2D, 0, rect.min.x, rect.min.y, cui_rect_get_width(rect),
-                                cui_rect_get_height(rect), GL_RGBA, GL_UNSIGNED_BYTE,
-                                (uint8_t *) bitmap.pixels + (rect.min.y * bitmap.stride) + (rect.min.x * 4));
+
+                for (uint32_t rect_index = 0; rect_index < update->rect_count; rect_index += 1)
+                {
+                    CuiRect rect = update->rects[rect_index];
+
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.min.x, rect.min.y, cui_rect_get_width(rect),
+                                    cui_rect_get_height(rect), format, GL_UNSIGNED_BYTE,
+                                    (uint8_t *) bitmap.pixels + (rect.min.y * bitmap.stride) + (rect.min.x * bytes_per_pixel));
+                }
+
                 glPixelStorei(GL_UNPACK_ROW_LENGTH_EXT, 0);
             } break;
         }
     }
 
+    if (command_buffer->index_buffer_count > renderer->max_rect_count)
+    {
+        _cui_renderer_opengles2_reserve_vertices(renderer, command_buffer->max_index_buffer_count);
+    }
+
     uint32_t draw_list_count = 0;
     CuiOpengles2DrawCommand *draw_command = renderer->draw_list;
 
@@ -383,6 +424,7 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
         draw_command->vertex_count = 0;
         draw_command->texture_id = -1;
         draw_command->texture_scale = cui_make_float_point(1.0f, 1.0f);
+        draw_command->alpha_texture = false;
         draw_command->clip_rect_x = 0;
         draw_command->clip_rect_y = 0;
         draw_command->clip_rect_width = framebuffer->width;
@@ -411,13 +453,14 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
 
                 if (textured_rect->texture_id != current_texture_id)
                 {
-                    CuiBitmap bitmap = renderer->bitmaps[textured_rect->texture_id];
+                    CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, textured_rect->texture_id);
 
-                    float a = 1.0f / bitmap.width;
-                    float b = 1.0f / bitmap.height;
+                    float a = 1.0f / texture->bitmap.width;
+                    float b = 1.0f / texture->bitmap.height;
 
-                    draw_command->texture_id = renderer->textures[textured_rect->texture_id];
+                    draw_command->texture_id = texture->backend_texture;
                     draw_command->texture_scale = cui_make_float_point(a, b);
+                    draw_command->alpha_texture = (texture->format == CUI_TEXTURE_FORMAT_A8);
 
                     current_texture_id = textured_rect->texture_id;
                 }
@@ -516,6 +559,7 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
 
         glBindTexture(GL_TEXTURE_2D, draw_command->texture_id);
         glUniform2f(renderer->texture_scale_location, draw_command->texture_scale.x, draw_command->texture_scale.y);
+        glUniform1f(renderer->alpha_texture_location, draw_command->alpha_texture ? 1.0f : 0.0f);
         glScissor(draw_command->clip_rect_x, draw_command->clip_rect_y, draw_command->clip_rect_width, draw_command->clip_rect_height);
 
         glDrawArrays(GL_TRIANGLES, draw_command->vertex_offset, draw_command->vertex_count);
@@ -543,6 +587,8 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
         renderer->max_render_time = render_time_ms;
     }
 
+    renderer->sum_unmerged_primitive_count += command_buffer->unmerged_index_buffer_count;
+    renderer->sum_primitive_count += command_buffer->index_buffer_count;
     renderer->sum_render_time += render_time;
     renderer->frame_count += 1;
 
@@ -550,10 +596,19 @@ _cui_renderer_opengles2_render(CuiRendererOpengles2 *renderer, CuiFramebuffer *f
     {
         printf("render time:  min=%fms  max=%fms  avg=%fms\n", renderer->min_render_time, renderer->max_render_time,
                renderer->sum_render_time * (1.0 / 300.0));
+        printf("command buffer high-water mark:  push buffer=%u bytes  primitives=%u  texture operations=%u\n",
+               command_buffer->push_buffer_high_water_mark, command_buffer->index_buffer_high_water_mark,
+               command_buffer->texture_operation_high_water_mark);
+        printf("primitives:  avg=%f  after merging=%f\n", (double) renderer->sum_unmerged_primitive_count * (1.0 / 300.0),
+               (double) renderer->sum_primitive_count * (1.0 / 300.0));
+        printf("textures:  count=%u  memory=%llu bytes  max memory=%llu bytes\n", renderer->texture_table.texture_count,
+               (unsigned long long) renderer->texture_table.memory_size, (unsigned long long) renderer->texture_table.max_memory_size);
 
         renderer->min_render_time = 1000.0f;
         renderer->max_render_time = 0.0f;
         renderer->sum_render_time = 0.0;
+        renderer->sum_unmerged_primitive_count = 0;
+        renderer->sum_primitive_count = 0;
         renderer->frame_count = 0;
     }
 #endif
@@ -1,41 +1,54 @@
-#define CUI_SOFTWARE_RENDERER_TILE_COUNT_X 8
-#define CUI_SOFTWARE_RENDERER_TILE_COUNT_Y 4
+// Tiles are sized so that their pixels stay in a typical L2 cache.
+#define CUI_SOFTWARE_RENDERER_TARGET_TILE_SIZE CuiKiB(128)
+#define CUI_SOFTWARE_RENDERER_TILES_PER_CORE 4
+#define CUI_SOFTWARE_RENDERER_MAX_TILE_COUNT_PER_AXIS 256
+#define CUI_SOFTWARE_RENDERER_MAX_TILE_COUNT 4096
+
+#define CUI_SOFTWARE_RENDERER_MAX_BIN_CHUNK_COUNT 16
+#define CUI_SOFTWARE_RENDERER_MIN_BIN_CHUNK_SIZE 512
 
 static CuiRenderer *
 _cui_renderer_software_create(void)
 {
-    uint64_t renderer_size          = CuiAlign(sizeof(CuiRendererSoftware), 16);
-    uint64_t texture_operation_size = CuiAlign(_CUI_MAX_TEXTURE_OPERATION_COUNT * sizeof(CuiTextureOperation), 16);
-    uint64_t index_buffer_size      = CuiAlign(_CUI_MAX_INDEX_BUFFER_COUNT * sizeof(uint32_t), 16);
-    uint64_t push_buffer_size       = CuiAlign(_CUI_MAX_PUSH_BUFFER_SIZE, 16);
-
-    uint64_t allocation_size = renderer_size + texture_operation_size + index_buffer_size + push_buffer_size;
+    uint64_t allocation_size = CuiAlign(sizeof(CuiRendererSoftware), 16);
 
-    uint8_t *allocation = (uint8_t *) cui_platform_allocate(allocation_size);
-
-    CuiRendererSoftware *renderer = (CuiRendererSoftware *) allocation;
-    allocation += renderer_size;
+    CuiRendererSoftware *renderer = (CuiRendererSoftware *) cui_platform_allocate(allocation_size);
 
     CuiClearStruct(*renderer);
 
     renderer->base.type = CUI_RENDERER_TYPE_SOFTWARE;
     renderer->allocation_size = allocation_size;
 
+    {
+        CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(&_cui_context.common.temporary_memory);
+
+        // CUI_SOFTWARE_RENDERER_OCCLUSION_CULLING=0 turns occlusion culling off by default,
+        // cui_window_set_occlusion_culling() switches it while the app runs.
+        CuiString occlusion_culling = cui_platform_get_environment_variable(&_cui_context.common.temporary_memory, &_cui_context.common.temporary_memory,
+                                                                            CuiStringLiteral("CUI_SOFTWARE_RENDERER_OCCLUSION_CULLING"));
+        renderer->occlusion_culling_enabled = !occlusion_culling.count || (cui_string_parse_int32(occlusion_culling) != 0);
+
+        // For tuning the tile size can be forced with CUI_SOFTWARE_RENDERER_TILE_WIDTH/HEIGHT (in pixels).
+        renderer->tile_width_override = cui_platform_get_environment_variable_int32(&_cui_context.common.temporary_memory,
+                                                                                    CuiStringLiteral("CUI_SOFTWARE_RENDERER_TILE_WIDTH"));
+        renderer->tile_height_override = cui_platform_get_environment_variable_int32(&_cui_context.common.temporary_memory,
+                                                                                     CuiStringLiteral("CUI_SOFTWARE_RENDERER_TILE_HEIGHT"));
+
+        cui_end_temporary_memory(temp_memory);
+    }
+
+#if CUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED
+    renderer->platform_performance_frequency = cui_platform_get_performance_frequency();
+    renderer->min_render_time = 1000.0f;
+    renderer->max_render_time = 0.0f;
+#endif
+
     CuiCommandBuffer *command_buffer = &renderer->command_buffer;
 
     command_buffer->max_texture_width  = 32768;
     command_buffer->max_texture_height = 32768;
 
-    command_buffer->max_texture_operation_count = _CUI_MAX_TEXTURE_OPERATION_COUNT;
-    command_buffer->texture_operations = (CuiTextureOperation *) allocation;
-    allocation += texture_operation_size;
-
-    command_buffer->max_index_buffer_count = _CUI_MAX_INDEX_BUFFER_COUNT;
-    command_buffer->index_buffer = (uint32_t *) allocation;
-    allocation += index_buffer_size;
-
-    command_buffer->max_push_buffer_size = _CUI_MAX_PUSH_BUFFER_SIZE;
-    command_buffer->push_buffer = (uint8_t *) allocation;
+    _cui_command_buffer_allocate(command_buffer);
 
     return &renderer->base;
 }
@@ -43,6 +56,29 @@ _cui_renderer_software_create(void)
 static void
 _cui_renderer_software_destroy(CuiRendererSoftware *renderer)
 {
+    if (renderer->binning_memory)
+    {
+        cui_platform_deallocate(renderer->binning_memory, renderer->binning_memory_size);
+    }
+
+    if (renderer->tile_primitive_memory)
+    {
+        cui_platform_deallocate(renderer->tile_primitive_memory, renderer->tile_primitive_memory_size);
+    }
+
+    if (renderer->tile_hashes)
+    {
+        cui_platform_deallocate(renderer->tile_hashes, 2 * renderer->max_tile_state_count * sizeof(uint64_t));
+    }
+
+    if (renderer->render_job_memory)
+    {
+        cui_platform_deallocate(renderer->render_job_memory, renderer->render_job_memory_size);
+    }
+
+    _cui_command_buffer_deallocate(&renderer->command_buffer);
+    _cui_texture_table_destroy(&renderer->texture_table);
+
     cui_platform_deallocate(renderer, renderer->allocation_size);
 }
 
@@ -51,109 +87,812 @@ _cui_renderer_software_begin_command_buffer(CuiRendererSoftware *renderer)
 {
     CuiCommandBuffer *command_buffer = &renderer->command_buffer;
 
-    command_buffer->push_buffer_size = 0;
-    command_buffer->index_buffer_count = 0;
-    command_buffer->texture_operation_count = 0;
+    _cui_command_buffer_reset(command_buffer);
 
     return command_buffer;
 }
 
+// NOTE: All blending is done in 8-bit fixed point. _cui_mul_255 computes round(a * b / 255)
+// exactly for a, b in [0, 255]. The SIMD paths below use the same formula, so the scalar
+// fallback is bit-exact against them.
+
+static inline uint32_t
+_cui_mul_255(uint32_t a, uint32_t b)
+{
+    uint32_t x = (a * b) + 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline uint32_t
+_cui_renderer_software_blend_pixel(uint32_t dst, uint32_t texel, uint32_t color)
+{
+    uint32_t src_b = _cui_mul_255((texel >>  0) & 0xFF, (color >>  0) & 0xFF);
+    uint32_t src_g = _cui_mul_255((texel >>  8) & 0xFF, (color >>  8) & 0xFF);
+    uint32_t src_r = _cui_mul_255((texel >> 16) & 0xFF, (color >> 16) & 0xFF);
+    uint32_t src_a = _cui_mul_255((texel >> 24) & 0xFF, (color >> 24) & 0xFF);
+
+    uint32_t inv_a = 255 - src_a;
+
+    uint32_t b = cui_min_uint32(src_b + _cui_mul_255((dst >>  0) & 0xFF, inv_a), 255);
+    uint32_t g = cui_min_uint32(src_g + _cui_mul_255((dst >>  8) & 0xFF, inv_a), 255);
+    uint32_t r = cui_min_uint32(src_r + _cui_mul_255((dst >> 16) & 0xFF, inv_a), 255);
+    uint32_t a = cui_min_uint32(src_a + _cui_mul_255((dst >> 24) & 0xFF, inv_a), 255);
+
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Blends 4 texels, modulated by color, onto 4 consecutive destination pixels.
+static inline void
+_cui_renderer_software_blend_4_pixels(uint32_t *dst, uint32_t *texels, uint32_t color)
+{
+#if CUI_ARCH_X86_64
+    __m128i zero = _mm_setzero_si128();
+    __m128i round = _mm_set1_epi16(128);
+    __m128i max_value = _mm_set1_epi16(255);
+    __m128i wide_color = _mm_unpacklo_epi8(_mm_set1_epi32(color), zero);
+
+    __m128i src = _mm_loadu_si128((__m128i *) texels);
+    __m128i dest = _mm_loadu_si128((__m128i *) dst);
+
+    __m128i src_lo = _mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), wide_color);
+    __m128i src_hi = _mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), wide_color);
+
+    src_lo = _mm_add_epi16(src_lo, round);
+    src_hi = _mm_add_epi16(src_hi, round);
+    src_lo = _mm_srli_epi16(_mm_add_epi16(src_lo, _mm_srli_epi16(src_lo, 8)), 8);
+    src_hi = _mm_srli_epi16(_mm_add_epi16(src_hi, _mm_srli_epi16(src_hi, 8)), 8);
+
+    __m128i inv_a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src_lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i inv_a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(src_hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    inv_a_lo = _mm_sub_epi16(max_value, inv_a_lo);
+    inv_a_hi = _mm_sub_epi16(max_value, inv_a_hi);
+
+    __m128i dst_lo = _mm_mullo_epi16(_mm_unpacklo_epi8(dest, zero), inv_a_lo);
+    __m128i dst_hi = _mm_mullo_epi16(_mm_unpackhi_epi8(dest, zero), inv_a_hi);
+
+    dst_lo = _mm_add_epi16(dst_lo, round);
+    dst_hi = _mm_add_epi16(dst_hi, round);
+    dst_lo = _mm_srli_epi16(_mm_add_epi16(dst_lo, _mm_srli_epi16(dst_lo, 8)), 8);
+    dst_hi = _mm_srli_epi16(_mm_add_epi16(dst_hi, _mm_srli_epi16(dst_hi, 8)), 8);
+
+    __m128i result = _mm_packus_epi16(_mm_add_epi16(src_lo, dst_lo), _mm_add_epi16(src_hi, dst_hi));
+
+    _mm_storeu_si128((__m128i *) dst, result);
+#elif CUI_ARCH_ARM64
+    static const uint8_t alpha_index[16] = { 3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15 };
+
+    uint8x16_t wide_color = vreinterpretq_u8_u32(vdupq_n_u32(color));
+
+    uint8x16_t src = vreinterpretq_u8_u32(vld1q_u32(texels));
+    uint8x16_t dest = vreinterpretq_u8_u32(vld1q_u32(dst));
+
+    uint16x8_t src_lo = vmull_u8(vget_low_u8(src), vget_low_u8(wide_color));
+    uint16x8_t src_hi = vmull_u8(vget_high_u8(src), vget_high_u8(wide_color));
+
+    // (x + ((x + 128) >> 8) + 128) >> 8
+    src = vcombine_u8(vrshrn_n_u16(vaddq_u16(src_lo, vrshrq_n_u16(src_lo, 8)), 8),
+                      vrshrn_n_u16(vaddq_u16(src_hi, vrshrq_n_u16(src_hi, 8)), 8));
+
+    uint8x16_t inv_a = vmvnq_u8(vqtbl1q_u8(src, vld1q_u8(alpha_index)));
+
+    uint16x8_t dst_lo = vmull_u8(vget_low_u8(dest), vget_low_u8(inv_a));
+    uint16x8_t dst_hi = vmull_u8(vget_high_u8(dest), vget_high_u8(inv_a));
+
+    dest = vcombine_u8(vrshrn_n_u16(vaddq_u16(dst_lo, vrshrq_n_u16(dst_lo, 8)), 8),
+                       vrshrn_n_u16(vaddq_u16(dst_hi, vrshrq_n_u16(dst_hi, 8)), 8));
+
+    vst1q_u32(dst, vreinterpretq_u32_u8(vqaddq_u8(src, dest)));
+#else
+    dst[0] = _cui_renderer_software_blend_pixel(dst[0], texels[0], color);
+    dst[1] = _cui_renderer_software_blend_pixel(dst[1], texels[1], color);
+    dst[2] = _cui_renderer_software_blend_pixel(dst[2], texels[2], color);
+    dst[3] = _cui_renderer_software_blend_pixel(dst[3], texels[3], color);
+#endif
+}
+
+typedef enum CuiTexturedRectKind
+{
+    CUI_TEXTURED_RECT_KIND_SOLID    = 0,
+    CUI_TEXTURED_RECT_KIND_UNSCALED = 1,
+    CUI_TEXTURED_RECT_KIND_SCALED   = 2,
+} CuiTexturedRectKind;
+
+// Steps a texture coordinate across a rect without dividing per pixel. The sampled coordinate
+// for pixel i is floor(a0 + da * (i + 0.5) / length), which is tracked as quotient + remainder
+// with the denominator 2 * length.
+typedef struct CuiTexCoordStepper
+{
+    int32_t value;
+    int32_t remainder;
+    int32_t step;
+    int32_t step_remainder;
+    int32_t denominator;
+} CuiTexCoordStepper;
+
+static inline int64_t
+_cui_floor_div_int64(int64_t a, int64_t b)
+{
+    int64_t result = a / b;
+
+    if ((a % b) && ((a < 0) != (b < 0)))
+    {
+        result -= 1;
+    }
+
+    return result;
+}
+
+static inline void
+_cui_tex_coord_stepper_init(CuiTexCoordStepper *stepper, int32_t a0, int32_t da, int32_t length, int32_t offset)
+{
+    CuiAssert(length > 0);
+
+    int64_t denominator = 2 * (int64_t) length;
+    int64_t numerator = ((int64_t) a0 * denominator) + ((int64_t) da * (2 * (int64_t) offset + 1));
+    int64_t value = _cui_floor_div_int64(numerator, denominator);
+    int64_t step = _cui_floor_div_int64(2 * (int64_t) da, denominator);
+
+    stepper->value = (int32_t) value;
+    stepper->remainder = (int32_t) (numerator - (value * denominator));
+    stepper->step = (int32_t) step;
+    stepper->step_remainder = (int32_t) ((2 * (int64_t) da) - (step * denominator));
+    stepper->denominator = (int32_t) denominator;
+}
+
+static inline void
+_cui_tex_coord_stepper_advance(CuiTexCoordStepper *stepper)
+{
+    stepper->value += stepper->step;
+    stepper->remainder += stepper->step_remainder;
+
+    if (stepper->remainder >= stepper->denominator)
+    {
+        stepper->value += 1;
+        stepper->remainder -= stepper->denominator;
+    }
+}
+
+static inline CuiTexturedRectKind
+_cui_renderer_software_classify_textured_rect(CuiTexturedRect *textured_rect)
+{
+    int32_t du = textured_rect->u1 - textured_rect->u0;
+    int32_t dv = textured_rect->v1 - textured_rect->v0;
+
+    if ((du == 0) && (dv == 0))
+    {
+        return CUI_TEXTURED_RECT_KIND_SOLID;
+    }
+    else if ((du == (textured_rect->x1 - textured_rect->x0)) &&
+             (dv == (textured_rect->y1 - textured_rect->y0)))
+    {
+        return CUI_TEXTURED_RECT_KIND_UNSCALED;
+    }
+    else
+    {
+        return CUI_TEXTURED_RECT_KIND_SCALED;
+    }
+}
+
+// A8 textures only store coverage, which expands to premultiplied white.
+static inline uint32_t
+_cui_renderer_software_fetch_texel(uint8_t *texture_row, CuiTextureFormat format, int32_t u)
+{
+    if (format == CUI_TEXTURE_FORMAT_A8)
+    {
+        return 0x01010101 * texture_row[u];
+    }
+    else
+    {
+        return ((uint32_t *) texture_row)[u];
+    }
+}
+
+static inline uint32_t
+_cui_renderer_software_get_texel(CuiTexture *texture, int32_t u, int32_t v)
+{
+    uint8_t *texture_row = (uint8_t *) texture->bitmap.pixels + (texture->bitmap.stride * v);
+    return _cui_renderer_software_fetch_texel(texture_row, texture->format, u);
+}
+
 static void
-_cui_renderer_software_render_tile(CuiRendererSoftware *renderer, CuiBitmap *framebuffer, CuiCommandBuffer *command_buffer,
-                                   CuiRect tile_rect, CuiColor clear_color)
+_cui_renderer_software_draw_textured_rect(CuiBitmap *framebuffer, CuiTexture *texture, CuiTexturedRect *textured_rect, CuiRect clip_rect)
 {
-    CuiBitmap clear_bitmap = *framebuffer;
-    clear_bitmap.width  = cui_rect_get_width(tile_rect);
-    clear_bitmap.height = cui_rect_get_height(tile_rect);
-    clear_bitmap.pixels = (uint8_t *) clear_bitmap.pixels + (tile_rect.min.y * clear_bitmap.stride) + (tile_rect.min.x * 4);
+    int32_t x0 = textured_rect->x0;
+    int32_t y0 = textured_rect->y0;
+    int32_t x1 = textured_rect->x1;
+    int32_t y1 = textured_rect->y1;
+    int32_t u0 = textured_rect->u0;
+    int32_t v0 = textured_rect->v0;
+    int32_t u1 = textured_rect->u1;
+    int32_t v1 = textured_rect->v1;
+    uint32_t color = cui_color_pack_bgra(textured_rect->color);
+
+    int32_t x_min = x0;
+    int32_t y_min = y0;
+    int32_t x_max = x1;
+    int32_t y_max = y1;
 
-    cui_bitmap_clear(&clear_bitmap, clear_color);
+    if (x_min < clip_rect.min.x) x_min = clip_rect.min.x;
+    if (y_min < clip_rect.min.y) y_min = clip_rect.min.y;
+    if (x_max > clip_rect.max.x) x_max = clip_rect.max.x;
+    if (y_max > clip_rect.max.y) y_max = clip_rect.max.y;
 
-    for (uint32_t i = 0; i < command_buffer->index_buffer_count; i += 1)
+    if ((x_min >= x_max) || (y_min >= y_max))
     {
-        uint32_t rect_offset = command_buffer->index_buffer[i];
+        return;
+    }
 
-        CuiTexturedRect *textured_rect = (CuiTexturedRect *) (command_buffer->push_buffer + rect_offset);
-        CuiBitmap *texture = renderer->bitmaps + textured_rect->texture_id;
+    // TODO: clamp texture coordinates
+
+    uint8_t *row = (uint8_t *) framebuffer->pixels + (framebuffer->stride * y_min) + (4 * x_min);
+
+    switch (_cui_renderer_software_classify_textured_rect(textured_rect))
+    {
+        case CUI_TEXTURED_RECT_KIND_SOLID:
+        {
+            uint32_t texel = _cui_renderer_software_get_texel(texture, u0, v0);
+            uint32_t src = _cui_renderer_software_blend_pixel(0, texel, color);
+
+            if (src == 0)
+            {
+                // Fully transparent, nothing to do.
+            }
+            else if ((src >> 24) == 0xFF)
+            {
+                for (int32_t y = y_min; y < y_max; y += 1)
+                {
+                    uint32_t *pixel = (uint32_t *) row;
+
+                    for (int32_t x = x_min; x < x_max; x += 1)
+                    {
+                        *pixel++ = src;
+                    }
+
+                    row += framebuffer->stride;
+                }
+            }
+            else
+            {
+                // src is already modulated, multiplying with white keeps it unchanged.
+                uint32_t texels[4] = { src, src, src, src };
+
+                for (int32_t y = y_min; y < y_max; y += 1)
+                {
+                    uint32_t *pixel = (uint32_t *) row;
+
+                    int32_t x = x_min;
+
+                    for (; (x + 4) <= x_max; x += 4)
+                    {
+                        _cui_renderer_software_blend_4_pixels(pixel, texels, 0xFFFFFFFF);
+                        pixel += 4;
+                    }
+
+                    for (; x < x_max; x += 1)
+                    {
+                        *pixel = _cui_renderer_software_blend_pixel(*pixel, src, 0xFFFFFFFF);
+                        pixel += 1;
+                    }
+
+                    row += framebuffer->stride;
+                }
+            }
+        } break;
+
+        case CUI_TEXTURED_RECT_KIND_UNSCALED:
+        {
+            CuiBitmap *bitmap = &texture->bitmap;
+
+            if (texture->format == CUI_TEXTURE_FORMAT_A8)
+            {
+                uint8_t *texture_row = (uint8_t *) bitmap->pixels + (bitmap->stride * (v0 + (y_min - y0))) + (u0 + (x_min - x0));
+
+                for (int32_t y = y_min; y < y_max; y += 1)
+                {
+                    uint32_t *pixel = (uint32_t *) row;
+                    uint8_t *coverage = texture_row;
+
+                    int32_t x = x_min;
+
+                    for (; (x + 4) <= x_max; x += 4)
+                    {
+                        uint32_t texels[4] = {
+                            0x01010101 * coverage[0], 0x01010101 * coverage[1],
+                            0x01010101 * coverage[2], 0x01010101 * coverage[3],
+                        };
+
+                        _cui_renderer_software_blend_4_pixels(pixel, texels, color);
+                        pixel += 4;
+                        coverage += 4;
+                    }
+
+                    for (; x < x_max; x += 1)
+                    {
+                        *pixel = _cui_renderer_software_blend_pixel(*pixel, 0x01010101 * *coverage, color);
+                        pixel += 1;
+                        coverage += 1;
+                    }
+
+                    row += framebuffer->stride;
+                    texture_row += bitmap->stride;
+                }
+
+                break;
+            }
+
+            uint8_t *texture_row = (uint8_t *) bitmap->pixels + (bitmap->stride * (v0 + (y_min - y0))) +
+                                   (4 * (u0 + (x_min - x0)));
+
+            for (int32_t y = y_min; y < y_max; y += 1)
+            {
+                uint32_t *pixel = (uint32_t *) row;
+                uint32_t *texel = (uint32_t *) texture_row;
+
+                int32_t x = x_min;
+
+                for (; (x + 4) <= x_max; x += 4)
+                {
+                    _cui_renderer_software_blend_4_pixels(pixel, texel, color);
+                    pixel += 4;
+                    texel += 4;
+                }
+
+                for (; x < x_max; x += 1)
+                {
+                    *pixel = _cui_renderer_software_blend_pixel(*pixel, *texel, color);
+                    pixel += 1;
+                    texel += 1;
+                }
+
+                row += framebuffer->stride;
+                texture_row += bitmap->stride;
+            }
+        } break;
+
+        case CUI_TEXTURED_RECT_KIND_SCALED:
+        {
+            CuiTextureFormat format = texture->format;
+
+            CuiTexCoordStepper v_stepper;
+            _cui_tex_coord_stepper_init(&v_stepper, v0, v1 - v0, y1 - y0, y_min - y0);
+
+            CuiTexCoordStepper u_start;
+            _cui_tex_coord_stepper_init(&u_start, u0, u1 - u0, x1 - x0, x_min - x0);
+
+            for (int32_t y = y_min; y < y_max; y += 1)
+            {
+                uint32_t *pixel = (uint32_t *) row;
+                uint8_t *texture_row = (uint8_t *) texture->bitmap.pixels + (texture->bitmap.stride * v_stepper.value);
+
+                CuiTexCoordStepper u_stepper = u_start;
+
+                int32_t x = x_min;
+
+                for (; (x + 4) <= x_max; x += 4)
+                {
+                    uint32_t texels[4];
+
+                    for (int32_t i = 0; i < 4; i += 1)
+                    {
+                        texels[i] = _cui_renderer_software_fetch_texel(texture_row, format, u_stepper.value);
+                        _cui_tex_coord_stepper_advance(&u_stepper);
+                    }
+
+                    _cui_renderer_software_blend_4_pixels(pixel, texels, color);
+                    pixel += 4;
+                }
+
+                for (; x < x_max; x += 1)
+                {
+                    uint32_t texel = _cui_renderer_software_fetch_texel(texture_row, format, u_stepper.value);
+                    *pixel = _cui_renderer_software_blend_pixel(*pixel, texel, color);
+                    _cui_tex_coord_stepper_advance(&u_stepper);
+                    pixel += 1;
+                }
+
+                _cui_tex_coord_stepper_advance(&v_stepper);
+                row += framebuffer->stride;
+            }
+        } break;
+    }
+}
+
+// The binning pass splits the index buffer into chunks. For every chunk and tile it counts
+// the primitives that overlap the tile, then every chunk scatters its primitives into the
+// tile lists. Because the lists are laid out tile-major and chunk-minor each tile list
+// keeps the submission order.
+typedef struct CuiRenderBinning
+{
+    CuiCommandBuffer *command_buffer;
+    CuiRect framebuffer_rect;
+
+    int32_t tile_width;
+    int32_t tile_height;
+    uint32_t tile_count_x;
+    uint32_t tile_count_y;
+
+    uint32_t chunk_count;
+    uint32_t chunk_size;
 
-        CuiRect clip_rect;
+    uint32_t *primitive_tile_bounds;    // [index_buffer_count] packed min/max tile coordinates
+    uint64_t *primitive_hashes;         // [index_buffer_count]
+    uint8_t *primitive_texture_changed; // [index_buffer_count] samples texels updated this frame
+    uint32_t *chunk_tile_offsets;       // [chunk_count * tile_count] counts, then write offsets
+    uint32_t *tile_offsets;             // [tile_count + 1] start of every tile list
+    uint32_t *tile_primitives;          // index buffer indices of the primitives per tile
+
+    uint64_t wait_time;
+    uint32_t park_count;
+} CuiRenderBinning;
+
+typedef struct CuiRenderBinningWork
+{
+    CuiRenderBinning *binning;
+    uint32_t chunk_index;
+} CuiRenderBinningWork;
+
+#define _CUI_EMPTY_TILE_BOUNDS 0xFFFFFFFF
+
+static inline uint64_t
+_cui_renderer_software_hash_textured_rect(CuiCommandBuffer *command_buffer, CuiTexturedRect *textured_rect)
+{
+    // NOTE: The clip rect offset differs between frames, the clip rect itself is hashed below.
+    uint64_t values[4];
+    cui_copy_memory(values, textured_rect, sizeof(values));
+
+    uint64_t hash = 0;
+
+    hash = _cui_hash_mix_u64(hash, values[0]); // x0, y0, x1, y1
+    hash = _cui_hash_mix_u64(hash, values[1]); // u0, v0, u1, v1
+    hash = _cui_hash_mix_u64(hash, values[2]); // color.r, color.g
+    hash = _cui_hash_mix_u64(hash, values[3]); // color.b, color.a
+    hash = _cui_hash_mix_u64(hash, textured_rect->texture_id);
+
+    if (textured_rect->clip_rect)
+    {
+        uint64_t clip_rect;
+        cui_copy_memory(&clip_rect, command_buffer->push_buffer + textured_rect->clip_rect - 1, sizeof(clip_rect));
+        hash = _cui_hash_mix_u64(hash, clip_rect);
+    }
+
+    return hash;
+}
+
+static inline bool
+_cui_renderer_software_samples_updated_texels(CuiCommandBuffer *command_buffer, CuiTexturedRect *textured_rect)
+{
+    for (uint32_t index = 0; index < command_buffer->texture_operation_count; index += 1)
+    {
+        CuiTextureOperation *texture_op = command_buffer->texture_operations + index;
+
+        if (texture_op->texture_id == textured_rect->texture_id)
+        {
+            if (texture_op->type != CUI_TEXTURE_OPERATION_UPDATE)
+            {
+                return true;
+            }
+
+            CuiRect uv = cui_make_rect(cui_min_int32(textured_rect->u0, textured_rect->u1),
+                                       cui_min_int32(textured_rect->v0, textured_rect->v1),
+                                       cui_max_int32(textured_rect->u0, textured_rect->u1) + 1,
+                                       cui_max_int32(textured_rect->v0, textured_rect->v1) + 1);
+            CuiTextureUpdate *update = &texture_op->payload.update;
+
+            for (uint32_t rect_index = 0; rect_index < update->rect_count; rect_index += 1)
+            {
+                CuiRect overlap = cui_rect_get_intersection(uv, update->rects[rect_index]);
+
+                if ((overlap.min.x < overlap.max.x) && (overlap.min.y < overlap.max.y))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+static void
+_cui_renderer_software_do_count_work(void *data)
+{
+    CuiRenderBinningWork *job = (CuiRenderBinningWork *) data;
+    CuiRenderBinning *binning = job->binning;
+    CuiCommandBuffer *command_buffer = binning->command_buffer;
+
+    uint32_t tile_count = binning->tile_count_x * binning->tile_count_y;
+    uint32_t *tile_counts = binning->chunk_tile_offsets + (job->chunk_index * tile_count);
+
+    for (uint32_t i = 0; i < tile_count; i += 1)
+    {
+        tile_counts[i] = 0;
+    }
+
+    uint32_t start = job->chunk_index * binning->chunk_size;
+    uint32_t end = cui_min_uint32(start + binning->chunk_size, command_buffer->index_buffer_count);
+
+    for (uint32_t i = start; i < end; i += 1)
+    {
+        CuiTexturedRect *textured_rect = (CuiTexturedRect *) (command_buffer->push_buffer + command_buffer->index_buffer[i]);
+
+        CuiRect rect = cui_make_rect(textured_rect->x0, textured_rect->y0, textured_rect->x1, textured_rect->y1);
+        rect = cui_rect_get_intersection(rect, binning->framebuffer_rect);
 
         if (textured_rect->clip_rect)
         {
-            CuiClipRect *rect = (CuiClipRect *) (command_buffer->push_buffer + textured_rect->clip_rect - 1);
-            clip_rect = cui_make_rect(rect->x_min, rect->y_min, rect->x_max, rect->y_max);
-            clip_rect = cui_rect_get_intersection(tile_rect, clip_rect);
+            CuiClipRect *clip_rect = (CuiClipRect *) (command_buffer->push_buffer + textured_rect->clip_rect - 1);
+            rect = cui_rect_get_intersection(rect, cui_make_rect(clip_rect->x_min, clip_rect->y_min,
+                                                                 clip_rect->x_max, clip_rect->y_max));
         }
-        else
+
+        if ((rect.min.x >= rect.max.x) || (rect.min.y >= rect.max.y))
         {
-            clip_rect = tile_rect;
+            binning->primitive_tile_bounds[i] = _CUI_EMPTY_TILE_BOUNDS;
+            continue;
         }
 
-        int32_t x0 = textured_rect->x0;
-        int32_t y0 = textured_rect->y0;
-        int32_t x1 = textured_rect->x1;
-        int32_t y1 = textured_rect->y1;
-        float u0 = (float) textured_rect->u0;
-        float v0 = (float) textured_rect->v0;
-        float u1 = (float) textured_rect->u1;
-        float v1 = (float) textured_rect->v1;
-        CuiColor color = textured_rect->color;
+        binning->primitive_hashes[i] = _cui_renderer_software_hash_textured_rect(command_buffer, textured_rect);
+        binning->primitive_texture_changed[i] = _cui_renderer_software_samples_updated_texels(command_buffer, textured_rect);
 
-        int32_t x_min = x0;
-        int32_t y_min = y0;
-        int32_t x_max = x1;
-        int32_t y_max = y1;
+        uint32_t tile_x_min = (uint32_t) (rect.min.x / binning->tile_width);
+        uint32_t tile_y_min = (uint32_t) (rect.min.y / binning->tile_height);
+        uint32_t tile_x_max = (uint32_t) ((rect.max.x - 1) / binning->tile_width);
+        uint32_t tile_y_max = (uint32_t) ((rect.max.y - 1) / binning->tile_height);
 
-        if (x_min < clip_rect.min.x) x_min = clip_rect.min.x;
-        if (y_min < clip_rect.min.y) y_min = clip_rect.min.y;
-        if (x_max > clip_rect.max.x) x_max = clip_rect.max.x;
-        if (y_max > clip_rect.max.y) y_max = clip_rect.max.y;
+        binning->primitive_tile_bounds[i] = (tile_y_max << 24) | (tile_x_max << 16) | (tile_y_min << 8) | tile_x_min;
 
-        uint8_t *row = (uint8_t *) framebuffer->pixels + (framebuffer->stride * y_min) + (4 * x_min);
+        for (uint32_t tile_y = tile_y_min; tile_y <= tile_y_max; tile_y += 1)
+        {
+            for (uint32_t tile_x = tile_x_min; tile_x <= tile_x_max; tile_x += 1)
+            {
+                tile_counts[(tile_y * binning->tile_count_x) + tile_x] += 1;
+            }
+        }
+    }
+}
+
+static void
+_cui_renderer_software_do_scatter_work(void *data)
+{
+    CuiRenderBinningWork *job = (CuiRenderBinningWork *) data;
+    CuiRenderBinning *binning = job->binning;
+    CuiCommandBuffer *command_buffer = binning->command_buffer;
 
-        for (int32_t y = y_min; y < y_max; y += 1)
+    uint32_t tile_count = binning->tile_count_x * binning->tile_count_y;
+    uint32_t *tile_offsets = binning->chunk_tile_offsets + (job->chunk_index * tile_count);
+
+    uint32_t start = job->chunk_index * binning->chunk_size;
+    uint32_t end = cui_min_uint32(start + binning->chunk_size, command_buffer->index_buffer_count);
+
+    for (uint32_t i = start; i < end; i += 1)
+    {
+        uint32_t bounds = binning->primitive_tile_bounds[i];
+
+        if (bounds == _CUI_EMPTY_TILE_BOUNDS)
         {
-            uint32_t *pixel = (uint32_t *) row;
+            continue;
+        }
+
+        uint32_t tile_x_min = (bounds >>  0) & 0xFF;
+        uint32_t tile_y_min = (bounds >>  8) & 0xFF;
+        uint32_t tile_x_max = (bounds >> 16) & 0xFF;
+        uint32_t tile_y_max = (bounds >> 24) & 0xFF;
 
-            for (int32_t x = x_min; x < x_max; x += 1)
+        for (uint32_t tile_y = tile_y_min; tile_y <= tile_y_max; tile_y += 1)
+        {
+            for (uint32_t tile_x = tile_x_min; tile_x <= tile_x_max; tile_x += 1)
             {
-                float wx = ((float) (x - x0) + 0.5f) / (float) (x1 - x0);
-                float wy = ((float) (y - y0) + 0.5f) / (float) (y1 - y0);
+                uint32_t tile_index = (tile_y * binning->tile_count_x) + tile_x;
+                binning->tile_primitives[tile_offsets[tile_index]++] = i;
+            }
+        }
+    }
+}
 
-                int32_t u = (int32_t) (u0 + (u1 - u0) * wx);
-                int32_t v = (int32_t) (v0 + (v1 - v0) * wy);
+static uint8_t *
+_cui_renderer_software_reserve_scratch_memory(uint8_t **memory, uint64_t *memory_size, uint64_t size)
+{
+    if (size > *memory_size)
+    {
+        if (*memory)
+        {
+            cui_platform_deallocate(*memory, *memory_size);
+        }
 
-                // TODO: clamp
+        *memory_size = CuiAlign(size + (size / 2), CuiKiB(64));
+        *memory = (uint8_t *) cui_platform_allocate(*memory_size);
+    }
 
-                uint32_t *texture_pixel = (uint32_t *) ((uint8_t *) texture->pixels + (texture->stride * v) + (4 * u));
+    return *memory;
+}
 
-                CuiColor texel = cui_color_unpack_bgra(*texture_pixel);
+static void
+_cui_renderer_software_run_binning_pass(CuiRenderBinning *binning, void (*task_func)(void *))
+{
+    CuiRenderBinningWork binning_jobs[CUI_SOFTWARE_RENDERER_MAX_BIN_CHUNK_COUNT];
 
-                texel.r = texel.r * color.r;
-                texel.g = texel.g * color.g;
-                texel.b = texel.b * color.b;
-                texel.a = texel.a * color.a;
+    if (binning->chunk_count == 1)
+    {
+        binning_jobs[0].binning = binning;
+        binning_jobs[0].chunk_index = 0;
 
-                CuiColor result = cui_color_unpack_bgra(*pixel);
+        task_func(binning_jobs);
+    }
+    else
+    {
+        CuiWorkerThreadQueue *queue = &_cui_context.common.worker_thread_queue;
+        CuiWorkerThreadTaskGroup binning_group = _cui_begin_worker_thread_task_group(task_func);
 
-                result.r = texel.r + result.r * (1.0f - texel.a);
-                result.g = texel.g + result.g * (1.0f - texel.a);
-                result.b = texel.b + result.b * (1.0f - texel.a);
-                result.a = texel.a + result.a * (1.0f - texel.a);
+        for (uint32_t chunk_index = 0; chunk_index < binning->chunk_count; chunk_index += 1)
+        {
+            CuiRenderBinningWork *job = binning_jobs + chunk_index;
 
-                *pixel++ = cui_color_pack_bgra(result);
-            }
+            job->binning = binning;
+            job->chunk_index = chunk_index;
+        }
+
+        _cui_add_worker_thread_queue_entries(queue, &binning_group, binning_jobs, sizeof(CuiRenderBinningWork), binning->chunk_count);
+
+        _cui_complete_worker_thread_task_group(queue, &binning_group);
 
-            row += framebuffer->stride;
+        binning->wait_time += binning_group.wait_time;
+        binning->park_count += binning_group.park_count;
+    }
+}
+
+static void
+_cui_renderer_software_bin_primitives(CuiRendererSoftware *renderer, CuiRenderBinning *binning)
+{
+    CuiCommandBuffer *command_buffer = binning->command_buffer;
+
+    uint32_t tile_count = binning->tile_count_x * binning->tile_count_y;
+    uint32_t primitive_count = command_buffer->index_buffer_count;
+
+    binning->chunk_count = (primitive_count + (CUI_SOFTWARE_RENDERER_MIN_BIN_CHUNK_SIZE - 1)) / CUI_SOFTWARE_RENDERER_MIN_BIN_CHUNK_SIZE;
+    binning->chunk_count = cui_max_uint32(1, cui_min_uint32(binning->chunk_count, CUI_SOFTWARE_RENDERER_MAX_BIN_CHUNK_COUNT));
+    binning->chunk_size = (primitive_count + (binning->chunk_count - 1)) / binning->chunk_count;
+
+    uint64_t bounds_size = CuiAlign(primitive_count * sizeof(uint32_t), 16);
+    uint64_t hashes_size = CuiAlign(primitive_count * sizeof(uint64_t), 16);
+    uint64_t texture_changed_size = CuiAlign(primitive_count * sizeof(uint8_t), 16);
+    uint64_t chunk_tile_offsets_size = CuiAlign(binning->chunk_count * tile_count * sizeof(uint32_t), 16);
+    uint64_t tile_offsets_size = CuiAlign((tile_count + 1) * sizeof(uint32_t), 16);
+
+    uint8_t *memory = _cui_renderer_software_reserve_scratch_memory(&renderer->binning_memory, &renderer->binning_memory_size,
+                                                                    bounds_size + hashes_size + texture_changed_size +
+                                                                    chunk_tile_offsets_size + tile_offsets_size);
+
+    binning->primitive_tile_bounds = (uint32_t *) memory;
+    memory += bounds_size;
+    binning->primitive_hashes = (uint64_t *) memory;
+    memory += hashes_size;
+    binning->primitive_texture_changed = (uint8_t *) memory;
+    memory += texture_changed_size;
+    binning->chunk_tile_offsets = (uint32_t *) memory;
+    memory += chunk_tile_offsets_size;
+    binning->tile_offsets = (uint32_t *) memory;
+
+    _cui_renderer_software_run_binning_pass(binning, _cui_renderer_software_do_count_work);
+
+    uint32_t offset = 0;
+
+    for (uint32_t tile_index = 0; tile_index < tile_count; tile_index += 1)
+    {
+        binning->tile_offsets[tile_index] = offset;
+
+        for (uint32_t chunk_index = 0; chunk_index < binning->chunk_count; chunk_index += 1)
+        {
+            uint32_t *chunk_tile_offset = binning->chunk_tile_offsets + (chunk_index * tile_count) + tile_index;
+            uint32_t count = *chunk_tile_offset;
+            *chunk_tile_offset = offset;
+            offset += count;
         }
     }
+
+    binning->tile_offsets[tile_count] = offset;
+
+    binning->tile_primitives = (uint32_t *) _cui_renderer_software_reserve_scratch_memory(&renderer->tile_primitive_memory,
+                                                                                         &renderer->tile_primitive_memory_size,
+                                                                                         offset * sizeof(uint32_t));
+
+    _cui_renderer_software_run_binning_pass(binning, _cui_renderer_software_do_scatter_work);
+}
+
+// Returns true if the rect is a solid, fully opaque fill that covers the whole tile. Everything
+// drawn before it in that tile, including the clear, is hidden.
+static inline bool
+_cui_renderer_software_occludes_tile(CuiTexture *texture, CuiTexturedRect *textured_rect, CuiRect clip_rect, CuiRect tile_rect)
+{
+    if ((textured_rect->x0 > tile_rect.min.x) || (textured_rect->y0 > tile_rect.min.y) ||
+        (textured_rect->x1 < tile_rect.max.x) || (textured_rect->y1 < tile_rect.max.y) ||
+        (clip_rect.min.x > tile_rect.min.x) || (clip_rect.min.y > tile_rect.min.y) ||
+        (clip_rect.max.x < tile_rect.max.x) || (clip_rect.max.y < tile_rect.max.y))
+    {
+        return false;
+    }
+
+    if (_cui_renderer_software_classify_textured_rect(textured_rect) != CUI_TEXTURED_RECT_KIND_SOLID)
+    {
+        return false;
+    }
+
+    uint32_t texel = _cui_renderer_software_get_texel(texture, textured_rect->u0, textured_rect->v0);
+    uint32_t src = _cui_renderer_software_blend_pixel(0, texel, cui_color_pack_bgra(textured_rect->color));
+
+    return ((src >> 24) == 0xFF);
+}
+
+static inline CuiRect
+_cui_renderer_software_get_clip_rect(CuiCommandBuffer *command_buffer, CuiTexturedRect *textured_rect, CuiRect tile_rect)
+{
+    CuiRect clip_rect = tile_rect;
+
+    if (textured_rect->clip_rect)
+    {
+        CuiClipRect *rect = (CuiClipRect *) (command_buffer->push_buffer + textured_rect->clip_rect - 1);
+        clip_rect = cui_make_rect(rect->x_min, rect->y_min, rect->x_max, rect->y_max);
+        clip_rect = cui_rect_get_intersection(tile_rect, clip_rect);
+    }
+
+    return clip_rect;
+}
+
+static void
+_cui_renderer_software_render_tile(CuiRendererSoftware *renderer, CuiBitmap *framebuffer, CuiCommandBuffer *command_buffer,
+                                   uint32_t *primitives, uint32_t primitive_count, CuiRect tile_rect, CuiColor clear_color)
+{
+    uint32_t first_primitive = 0;
+    bool needs_clear = true;
+
+    if (renderer->occlusion_culling_enabled)
+    {
+        for (uint32_t i = primitive_count; i > 0; i -= 1)
+        {
+            CuiTexturedRect *textured_rect = (CuiTexturedRect *) (command_buffer->push_buffer + command_buffer->index_buffer[primitives[i - 1]]);
+            CuiRect clip_rect = _cui_renderer_software_get_clip_rect(command_buffer, textured_rect, tile_rect);
+
+            CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, textured_rect->texture_id);
+
+            if (_cui_renderer_software_occludes_tile(texture, textured_rect, clip_rect, tile_rect))
+            {
+                first_primitive = i - 1;
+                needs_clear = false;
+                break;
+            }
+        }
+    }
+
+    if (needs_clear)
+    {
+        CuiBitmap clear_bitmap = *framebuffer;
+        clear_bitmap.width  = cui_rect_get_width(tile_rect);
+        clear_bitmap.height = cui_rect_get_height(tile_rect);
+        clear_bitmap.pixels = (uint8_t *) clear_bitmap.pixels + (tile_rect.min.y * clear_bitmap.stride) + (tile_rect.min.x * 4);
+
+        cui_bitmap_clear(&clear_bitmap, clear_color);
+    }
+
+    for (uint32_t i = first_primitive; i < primitive_count; i += 1)
+    {
+        uint32_t rect_offset = command_buffer->index_buffer[primitives[i]];
+
+        CuiTexturedRect *textured_rect = (CuiTexturedRect *) (command_buffer->push_buffer + rect_offset);
+        CuiTexture *texture = _cui_texture_table_get(&renderer->texture_table, textured_rect->texture_id);
+
+        CuiRect clip_rect = _cui_renderer_software_get_clip_rect(command_buffer, textured_rect, tile_rect);
+
+        _cui_renderer_software_draw_textured_rect(framebuffer, texture, textured_rect, clip_rect);
+    }
 }
 
 typedef struct CuiRenderWork
 {
     CuiRendererSoftware *renderer;
-    CuiBitmap *framebuffer;
+    CuiFramebuffer *framebuffer;
     CuiCommandBuffer *command_buffer;
+    CuiRenderBinning *binning;
+    uint32_t tile_index;
+    bool tile_state_is_valid;
     CuiRect tile_rect;
     CuiColor clear_color;
 } CuiRenderWork;
@@ -162,7 +901,194 @@ static void
 _cui_renderer_software_do_render_work(void *data)
 {
     CuiRenderWork *job = (CuiRenderWork *) data;
-    _cui_renderer_software_render_tile(job->renderer, job->framebuffer, job->command_buffer, job->tile_rect, job->clear_color);
+    CuiRendererSoftware *renderer = job->renderer;
+    CuiRenderBinning *binning = job->binning;
+
+    uint32_t *primitives = binning->tile_primitives + binning->tile_offsets[job->tile_index];
+    uint32_t primitive_count = binning->tile_offsets[job->tile_index + 1] - binning->tile_offsets[job->tile_index];
+
+    uint64_t tile_hash = _cui_hash_mix_u64(0, cui_color_pack_bgra(job->clear_color));
+    bool texture_changed = false;
+
+    for (uint32_t i = 0; i < primitive_count; i += 1)
+    {
+        tile_hash = _cui_hash_mix_u64(tile_hash, binning->primitive_hashes[primitives[i]]);
+        texture_changed = texture_changed || binning->primitive_texture_changed[primitives[i]];
+    }
+
+    if (!job->tile_state_is_valid || texture_changed || (renderer->tile_hashes[job->tile_index] != tile_hash))
+    {
+        renderer->tile_hashes[job->tile_index] = tile_hash;
+        renderer->tile_change_frames[job->tile_index] = renderer->frame_index;
+    }
+
+    // The framebuffer still holds the pixels of the frame it was last rendered in. Only tiles
+    // that changed since then need to be rasterized again.
+    if (renderer->tile_change_frames[job->tile_index] > job->framebuffer->rendered_frame_index)
+    {
+        _cui_renderer_software_render_tile(renderer, &job->framebuffer->bitmap, job->command_buffer,
+                                           primitives, primitive_count, job->tile_rect, job->clear_color);
+    }
+}
+
+static void
+_cui_renderer_software_set_dirty_rects(CuiRendererSoftware *renderer, CuiFramebuffer *framebuffer, CuiRenderWork *render_jobs,
+                                       uint32_t tile_count_x, uint32_t tile_count_y)
+{
+    framebuffer->dirty_rect_count = 0;
+
+    bool overflow = false;
+    CuiRect bounding_rect = { { INT32_MAX, INT32_MAX }, { INT32_MIN, INT32_MIN } };
+
+    for (uint32_t tile_y = 0; tile_y < tile_count_y; tile_y += 1)
+    {
+        int32_t row_start = framebuffer->dirty_rect_count;
+
+        for (uint32_t tile_x = 0; tile_x < tile_count_x; tile_x += 1)
+        {
+            uint32_t tile_index = (tile_y * tile_count_x) + tile_x;
+            CuiRect tile_rect = render_jobs[tile_index].tile_rect;
+
+            if ((renderer->tile_change_frames[tile_index] != renderer->frame_index) ||
+                (tile_rect.min.x >= tile_rect.max.x) || (tile_rect.min.y >= tile_rect.max.y))
+            {
+                continue;
+            }
+
+            bounding_rect = cui_rect_get_union(bounding_rect, tile_rect);
+
+            if (overflow)
+            {
+                continue;
+            }
+
+            // Extend a run of dirty tiles in this row.
+            if ((framebuffer->dirty_rect_count > row_start) &&
+                (framebuffer->dirty_rects[framebuffer->dirty_rect_count - 1].max.x == tile_rect.min.x))
+            {
+                framebuffer->dirty_rects[framebuffer->dirty_rect_count - 1].max.x = tile_rect.max.x;
+                continue;
+            }
+
+            if (framebuffer->dirty_rect_count == CuiArrayCount(framebuffer->dirty_rects))
+            {
+                overflow = true;
+                continue;
+            }
+
+            framebuffer->dirty_rects[framebuffer->dirty_rect_count++] = tile_rect;
+        }
+
+        // Merge runs with the same horizontal extent into rects ending at this row.
+        int32_t write_index = row_start;
+
+        for (int32_t read_index = row_start; !overflow && (read_index < framebuffer->dirty_rect_count); read_index += 1)
+        {
+            CuiRect rect = framebuffer->dirty_rects[read_index];
+            bool merged = false;
+
+            for (int32_t index = 0; index < row_start; index += 1)
+            {
+                CuiRect *previous = framebuffer->dirty_rects + index;
+
+                if ((previous->min.x == rect.min.x) && (previous->max.x == rect.max.x) && (previous->max.y == rect.min.y))
+                {
+                    previous->max.y = rect.max.y;
+                    merged = true;
+                    break;
+                }
+            }
+
+            if (!merged)
+            {
+                framebuffer->dirty_rects[write_index++] = rect;
+            }
+        }
+
+        if (!overflow)
+        {
+            framebuffer->dirty_rect_count = write_index;
+        }
+    }
+
+    if (overflow)
+    {
+        framebuffer->dirty_rect_count = 1;
+        framebuffer->dirty_rects[0] = bounding_rect;
+    }
+}
+
+static void
+_cui_renderer_software_update_tile_grid(CuiRendererSoftware *renderer, int32_t width, int32_t height)
+{
+    uint32_t max_tile_count = CUI_SOFTWARE_RENDERER_MAX_TILE_COUNT;
+
+    int32_t tile_width = renderer->tile_width_override;
+    int32_t tile_height = renderer->tile_height_override;
+
+    width = cui_max_int32(width, 1);
+    height = cui_max_int32(height, 1);
+
+    if ((tile_width <= 0) || (tile_height <= 0))
+    {
+        // Use a few tiles per core for load balancing, but more if a tile doesn't fit into the cache.
+        uint64_t core_count = cui_max_uint32(cui_platform_get_core_count(), 1);
+        uint64_t framebuffer_size = 4 * (uint64_t) width * (uint64_t) height;
+        uint64_t tile_count = (framebuffer_size + (CUI_SOFTWARE_RENDERER_TARGET_TILE_SIZE - 1)) / CUI_SOFTWARE_RENDERER_TARGET_TILE_SIZE;
+
+        if (tile_count < (CUI_SOFTWARE_RENDERER_TILES_PER_CORE * core_count))
+        {
+            tile_count = CUI_SOFTWARE_RENDERER_TILES_PER_CORE * core_count;
+        }
+
+        if (tile_count > max_tile_count)
+        {
+            tile_count = max_tile_count;
+        }
+
+        // Keep the tiles roughly square.
+        int32_t tile_count_x = (int32_t) (sqrtf((float) tile_count * (float) width / (float) height) + 0.5f);
+        tile_count_x = cui_max_int32(1, cui_min_int32(tile_count_x, (int32_t) tile_count));
+        int32_t tile_count_y = cui_max_int32(1, (int32_t) tile_count / tile_count_x);
+
+        if (tile_width <= 0)
+        {
+            tile_width = (width + (tile_count_x - 1)) / tile_count_x;
+        }
+
+        if (tile_height <= 0)
+        {
+            tile_height = (height + (tile_count_y - 1)) / tile_count_y;
+        }
+    }
+
+    tile_width = CuiAlign(cui_max_int32(tile_width, 16), 16); // align to cache-line
+    tile_height = cui_max_int32(tile_height, 1);
+
+    uint32_t tile_count_x = (width + (tile_width - 1)) / tile_width;
+    uint32_t tile_count_y = (height + (tile_height - 1)) / tile_height;
+
+    // The packed tile bounds of the binning pass store 8 bit per tile coordinate.
+    while ((tile_count_x > CUI_SOFTWARE_RENDERER_MAX_TILE_COUNT_PER_AXIS) ||
+           (tile_count_y > CUI_SOFTWARE_RENDERER_MAX_TILE_COUNT_PER_AXIS) ||
+           ((tile_count_x * tile_count_y) > max_tile_count))
+    {
+        if (tile_count_x >= tile_count_y)
+        {
+            tile_width *= 2;
+            tile_count_x = (width + (tile_width - 1)) / tile_width;
+        }
+        else
+        {
+            tile_height *= 2;
+            tile_count_y = (height + (tile_height - 1)) / tile_height;
+        }
+    }
+
+    renderer->tile_width = tile_width;
+    renderer->tile_height = tile_height;
+    renderer->tile_count_x = tile_count_x;
+    renderer->tile_count_y = tile_count_y;
 }
 
 static void
@@ -170,55 +1096,100 @@ _cui_renderer_software_render(CuiRendererSoftware *renderer, CuiFramebuffer *fra
 {
     CuiAssert(&renderer->command_buffer == command_buffer);
 
+#if CUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED
+    uint64_t render_start = cui_platform_get_performance_counter();
+#endif
+
     for (uint32_t index = 0; index < command_buffer->texture_operation_count; index += 1)
     {
         CuiTextureOperation *texture_op = command_buffer->texture_operations + index;
 
-        int32_t texture_id = texture_op->texture_id;
-        CuiAssert(texture_id >= 0);
-        CuiAssert(texture_id < CUI_MAX_TEXTURE_COUNT);
+        uint32_t texture_id = texture_op->texture_id;
 
         switch (texture_op->type)
         {
             case CUI_TEXTURE_OPERATION_ALLOCATE:
             {
-                renderer->bitmaps[texture_id] = texture_op->payload.bitmap;
+                // The bitmap stays owned by the application, it is only referenced.
+                CuiBitmap bitmap = texture_op->payload.bitmap;
+                _cui_texture_table_allocate(&renderer->texture_table, texture_id, (CuiTextureFormat) texture_op->format, bitmap,
+                                            (uint64_t) bitmap.stride * (uint64_t) bitmap.height);
             } break;
 
             case CUI_TEXTURE_OPERATION_DEALLOCATE:
             {
-                CuiClearStruct(renderer->bitmaps[texture_id]);
+                _cui_texture_table_deallocate(&renderer->texture_table, texture_id);
             } break;
 
             case CUI_TEXTURE_OPERATION_UPDATE:
             {
+                CuiAssert(_cui_texture_table_get(&renderer->texture_table, texture_id));
             } break;
         }
     }
 
     CuiBitmap *render_target = &framebuffer->bitmap;
 
-    CuiRenderWork render_jobs[CUI_SOFTWARE_RENDERER_TILE_COUNT_X *
-                              CUI_SOFTWARE_RENDERER_TILE_COUNT_Y];
+    renderer->frame_index += 1;
 
-    uint32_t tile_width  = (render_target->width  + (CUI_SOFTWARE_RENDERER_TILE_COUNT_X - 1)) /
-                           CUI_SOFTWARE_RENDERER_TILE_COUNT_X;
-    uint32_t tile_height = (render_target->height + (CUI_SOFTWARE_RENDERER_TILE_COUNT_Y - 1)) /
-                           CUI_SOFTWARE_RENDERER_TILE_COUNT_Y;
+    // The tile hashes of the previous frame can only be compared if the tile grid is the same.
+    bool tile_state_is_valid = (renderer->tile_state_width == render_target->width) &&
+                               (renderer->tile_state_height == render_target->height);
+
+    if (!tile_state_is_valid)
+    {
+        _cui_renderer_software_update_tile_grid(renderer, render_target->width, render_target->height);
+
+        uint32_t tile_count = renderer->tile_count_x * renderer->tile_count_y;
+
+        if (tile_count > renderer->max_tile_state_count)
+        {
+            if (renderer->tile_hashes)
+            {
+                cui_platform_deallocate(renderer->tile_hashes, 2 * renderer->max_tile_state_count * sizeof(uint64_t));
+            }
+
+            renderer->max_tile_state_count = tile_count;
+            renderer->tile_hashes = (uint64_t *) cui_platform_allocate(2 * renderer->max_tile_state_count * sizeof(uint64_t));
+            renderer->tile_change_frames = renderer->tile_hashes + renderer->max_tile_state_count;
+        }
+
+        renderer->tile_state_width = render_target->width;
+        renderer->tile_state_height = render_target->height;
+    }
 
-    tile_width = CuiAlign(tile_width, 16); // align to cache-line
+    int32_t tile_width = renderer->tile_width;
+    int32_t tile_height = renderer->tile_height;
+    uint32_t tile_count = renderer->tile_count_x * renderer->tile_count_y;
+
+    CuiRenderWork *render_jobs = (CuiRenderWork *) _cui_renderer_software_reserve_scratch_memory(&renderer->render_job_memory,
+                                                                                                &renderer->render_job_memory_size,
+                                                                                                tile_count * sizeof(CuiRenderWork));
 
     CuiRect framebuffer_rect = cui_make_rect(0, 0, render_target->width, render_target->height);
 
+    CuiRenderBinning binning;
+    binning.command_buffer = command_buffer;
+    binning.framebuffer_rect = framebuffer_rect;
+    binning.tile_width = tile_width;
+    binning.tile_height = tile_height;
+    binning.tile_count_x = renderer->tile_count_x;
+    binning.tile_count_y = renderer->tile_count_y;
+    binning.wait_time = 0;
+    binning.park_count = 0;
+
+    _cui_renderer_software_bin_primitives(renderer, &binning);
+
     CuiWorkerThreadQueue *queue = &_cui_context.common.worker_thread_queue;
     CuiWorkerThreadTaskGroup render_group = _cui_begin_worker_thread_task_group(_cui_renderer_software_do_render_work);
 
     uint32_t job_index = 0;
 
-    for (uint32_t tile_y = 0; tile_y < CUI_SOFTWARE_RENDERER_TILE_COUNT_Y; tile_y += 1)
+    for (uint32_t tile_y = 0; tile_y < renderer->tile_count_y; tile_y += 1)
     {
-        for (uint32_t tile_x = 0; tile_x < CUI_SOFTWARE_RENDERER_TILE_COUNT_X; tile_x += 1)
+        for (uint32_t tile_x = 0; tile_x < renderer->tile_count_x; tile_x += 1)
         {
+            uint32_t tile_index = job_index;
             CuiRenderWork *job = render_jobs + job_index++;
 
             CuiRect tile_rect;
@@ -228,17 +1199,93 @@ _cui_renderer_software_render(CuiRendererSoftware *renderer, CuiFramebuffer *fra
             tile_rect.max.y = tile_rect.min.y + tile_height;
 
             job->renderer = renderer;
-            job->framebuffer = render_target;
+            job->framebuffer = framebuffer;
             job->command_buffer = command_buffer;
+            job->binning = &binning;
+            job->tile_index = tile_index;
+            job->tile_state_is_valid = tile_state_is_valid;
             job->tile_rect = cui_rect_get_intersection(tile_rect, framebuffer_rect);
             job->clear_color = clear_color;
-
-            _cui_add_worker_thread_queue_entry(queue, &render_group, job);
         }
     }
 
+    _cui_add_worker_thread_queue_entries(queue, &render_group, render_jobs, sizeof(CuiRenderWork), job_index);
+
     _cui_complete_worker_thread_task_group(queue, &render_group);
 
+    framebuffer->rendered_frame_index = renderer->frame_index;
+
+    _cui_renderer_software_set_dirty_rects(renderer, framebuffer, render_jobs, renderer->tile_count_x, renderer->tile_count_y);
+
+#if CUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED
+    uint64_t render_end = cui_platform_get_performance_counter();
+    double render_time = (1000.0 * (double) (render_end - render_start)) / (double) renderer->platform_performance_frequency;
+    float render_time_ms = render_time;
+
+    if (render_time_ms < renderer->min_render_time)
+    {
+        renderer->min_render_time = render_time_ms;
+    }
+
+    if (render_time_ms > renderer->max_render_time)
+    {
+        renderer->max_render_time = render_time_ms;
+    }
+
+    for (uint32_t tile_index = 0; tile_index < tile_count; tile_index += 1)
+    {
+        uint32_t tile_primitive_count = binning.tile_offsets[tile_index + 1] - binning.tile_offsets[tile_index];
+        renderer->max_tile_primitive_count = cui_max_uint32(renderer->max_tile_primitive_count, tile_primitive_count);
+    }
+
+    for (int32_t index = 0; index < framebuffer->dirty_rect_count; index += 1)
+    {
+        CuiRect dirty_rect = framebuffer->dirty_rects[index];
+        renderer->sum_dirty_pixel_count += (uint64_t) cui_rect_get_width(dirty_rect) * (uint64_t) cui_rect_get_height(dirty_rect);
+    }
+
+    renderer->sum_tile_primitive_count += binning.tile_offsets[tile_count];
+    renderer->sum_wait_time += binning.wait_time + render_group.wait_time;
+    renderer->sum_park_count += binning.park_count + render_group.park_count;
+    renderer->sum_unmerged_primitive_count += command_buffer->unmerged_index_buffer_count;
+    renderer->sum_primitive_count += command_buffer->index_buffer_count;
+    renderer->sum_render_time += render_time;
+    renderer->frame_count += 1;
+
+    if (renderer->frame_count == 300)
+    {
+        printf("render time:  min=%fms  max=%fms  avg=%fms\n", renderer->min_render_time, renderer->max_render_time,
+               renderer->sum_render_time * (1.0 / 300.0));
+        printf("tile grid:  %ux%u tiles of %dx%d pixels\n", renderer->tile_count_x, renderer->tile_count_y,
+               renderer->tile_width, renderer->tile_height);
+        printf("primitives per tile:  max=%u  avg=%f\n", renderer->max_tile_primitive_count,
+               (double) renderer->sum_tile_primitive_count / (300.0 * (double) tile_count));
+        printf("presented pixels:  avg=%f\n", (double) renderer->sum_dirty_pixel_count * (1.0 / 300.0));
+        printf("worker wait time:  avg=%fms  parks=%f\n",
+               (1000.0 * (double) renderer->sum_wait_time) / (300.0 * (double) renderer->platform_performance_frequency),
+               (double) renderer->sum_park_count * (1.0 / 300.0));
+        printf("command buffer high-water mark:  push buffer=%u bytes  primitives=%u  texture operations=%u\n",
+               command_buffer->push_buffer_high_water_mark, command_buffer->index_buffer_high_water_mark,
+               command_buffer->texture_operation_high_water_mark);
+        printf("primitives:  avg=%f  after merging=%f\n", (double) renderer->sum_unmerged_primitive_count * (1.0 / 300.0),
+               (double) renderer->sum_primitive_count * (1.0 / 300.0));
+        printf("textures:  count=%u  memory=%llu bytes  max memory=%llu bytes\n", renderer->texture_table.texture_count,
+               (unsigned long long) renderer->texture_table.memory_size, (unsigned long long) renderer->texture_table.max_memory_size);
+
+        renderer->min_render_time = 1000.0f;
+        renderer->max_render_time = 0.0f;
+        renderer->sum_render_time = 0.0;
+        renderer->sum_tile_primitive_count = 0;
+        renderer->max_tile_primitive_count = 0;
+        renderer->sum_dirty_pixel_count = 0;
+        renderer->sum_wait_time = 0;
+        renderer->sum_park_count = 0;
+        renderer->sum_unmerged_primitive_count = 0;
+        renderer->sum_primitive_count = 0;
+        renderer->frame_count = 0;
+    }
+#endif
+
 #if 0
     for (int32_t x = 0; x < render_target->width; x += 1)
     {
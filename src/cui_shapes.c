@@ -41,11 +41,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -65,7 +61,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_CHECKBOX_INNER_16:
@@ -75,11 +75,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -99,7 +95,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_CHECKMARK_16:
@@ -109,11 +109,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -135,7 +131,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_ANGLE_UP_12:
@@ -145,11 +145,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -170,7 +166,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_ANGLE_RIGHT_12:
@@ -180,11 +180,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -205,7 +201,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_ANGLE_DOWN_12:
@@ -215,11 +215,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -240,7 +236,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_ANGLE_LEFT_12:
@@ -250,11 +250,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -275,7 +271,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_INFO_12:
@@ -285,11 +285,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -318,7 +314,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_EXPAND_12:
@@ -328,11 +328,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -364,7 +360,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_SEARCH_12:
@@ -374,11 +374,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -405,7 +401,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_A_12:
@@ -415,11 +415,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -447,7 +443,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_B_12:
@@ -457,11 +457,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -503,7 +499,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_G_12:
@@ -513,11 +513,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -527,7 +523,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_H_12:
@@ -537,11 +537,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -569,7 +565,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_L_12:
@@ -579,11 +579,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -604,7 +600,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_R_12:
@@ -614,11 +614,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -651,7 +647,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_S_12:
@@ -661,11 +661,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -675,7 +671,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_UPPERCASE_V_12:
@@ -685,11 +685,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -710,7 +706,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
 
             case CUI_SHAPE_PLUS_12:
@@ -720,11 +720,7 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
 
                 uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);
 
-                CuiBitmap bitmap;
-                bitmap.width = cui_rect_get_width(uv);
-                bitmap.height = cui_rect_get_height(uv);
-                bitmap.stride = ctx->glyph_cache->texture.stride;
-                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);
+                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);
 
                 CuiPathCommand *path = 0;
                 cui_array_init(path, 16, ctx->temporary_memory);
@@ -752,7 +748,11 @@ cui_draw_fill_shape(CuiGraphicsContext *ctx, float x, float y, CuiShapeType shap
                 cui_array_init(edge_list, 16, ctx->temporary_memory);
 
                 _cui_path_to_edge_list(path, &edge_list);
-                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+
+                if (cui_rect_has_area(uv))
+                {
+                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+                }
             } break;
         }
 
@@ -11,7 +11,7 @@
 static void *
 _cui_worker_thread_proc(void *data)
 {
-    (void) data;
+    _cui_worker_thread_index = (uint32_t) (uintptr_t) data;
 
     CuiWorkerThreadQueue *queue = &_cui_context.common.worker_thread_queue;
 
@@ -20,7 +20,16 @@ _cui_worker_thread_proc(void *data)
         if (_cui_do_next_worker_thread_queue_entry(queue))
         {
             pthread_mutex_lock(&queue->semaphore_mutex);
-            pthread_cond_wait(&queue->semaphore_cond, &queue->semaphore_mutex);
+
+            _cui_atomic_increment(&queue->sleeping_count);
+
+            if (!_cui_atomic_read(&queue->pending_count))
+            {
+                pthread_cond_wait(&queue->semaphore_cond, &queue->semaphore_mutex);
+            }
+
+            _cui_atomic_decrement(&queue->sleeping_count);
+
             pthread_mutex_unlock(&queue->semaphore_mutex);
         }
     }
@@ -293,14 +302,35 @@ cui_platform_file_truncate(CuiFile *file, uint64_t size)
     ftruncate(*(int *) &file - 1, size);
 }
 
-void
+uint64_t
 cui_platform_file_read(CuiFile *file, void *buffer, uint64_t offset, uint64_t size)
 {
     CuiAssert(file);
     CuiAssert((uint64_t) file <= 0x80000000);
 
+    uint64_t bytes_read = 0;
+
     lseek(*(int *) &file - 1, offset, SEEK_SET);
-    read(*(int *) &file - 1, buffer, size);
+
+    // NOTE: read() may return less than requested, e.g. for more than 2 GiB on linux.
+    while (bytes_read < size)
+    {
+        ssize_t result = read(*(int *) &file - 1, (uint8_t *) buffer + bytes_read, size - bytes_read);
+
+        if (result <= 0)
+        {
+            if ((result < 0) && (errno == EINTR))
+            {
+                continue;
+            }
+
+            break;
+        }
+
+        bytes_read += (uint64_t) result;
+    }
+
+    return bytes_read;
 }
 
 void
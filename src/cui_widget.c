@@ -185,6 +185,7 @@ cui_widget_init(CuiWidget *widget, uint32_t type)
     CuiClearStruct(*widget);
 
     widget->type = type;
+    widget->drawing_version = ++_cui_context.common.widget_drawing_version;
     widget->color_normal_background = CUI_COLOR_DEFAULT_BG;
     widget->color_normal_border     = CUI_COLOR_DEFAULT_BORDER;
     widget->color_normal_text       = CUI_COLOR_DEFAULT_FG;
@@ -256,12 +257,16 @@ void
 cui_widget_add_flags(CuiWidget *widget, uint32_t flags)
 {
     widget->flags |= flags;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_remove_flags(CuiWidget *widget, uint32_t flags)
 {
     widget->flags &= ~flags;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -286,6 +291,8 @@ cui_widget_set_textinput_buffer(CuiWidget *widget, void *buffer, int64_t size)
     widget->text_input.count = 0;
     widget->text_input.capacity = size;
     widget->text_input.data = (uint8_t *) buffer;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -308,6 +315,8 @@ cui_widget_set_textinput_value(CuiWidget *widget, CuiString value)
     {
         _cui_widget_update_text_offset(widget);
     }
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 CuiString
@@ -335,6 +344,8 @@ cui_widget_append_child(CuiWidget *widget, CuiWidget *child)
     child->parent = widget;
     CuiDListInsertBefore(&widget->children, &child->list);
 
+    cui_widget_invalidate_drawing(widget);
+
     if (widget->window)
     {
         cui_widget_set_window(child, widget->window);
@@ -364,6 +375,8 @@ cui_widget_insert_before(CuiWidget *widget, CuiWidget *anchor_child, CuiWidget *
     new_child->parent = widget;
     CuiDListInsertBefore(&anchor_child->list, &new_child->list);
 
+    cui_widget_invalidate_drawing(widget);
+
     if (widget->window)
     {
         cui_widget_set_window(new_child, widget->window);
@@ -394,6 +407,8 @@ cui_widget_replace_child(CuiWidget *widget, CuiWidget *old_child, CuiWidget *new
     CuiDListInsertBefore(&old_child->list, &new_child->list);
     CuiDListRemove(&old_child->list);
 
+    cui_widget_invalidate_drawing(widget);
+
     if (widget->window)
     {
         cui_widget_set_window(new_child, widget->window);
@@ -426,42 +441,56 @@ cui_widget_remove_child(CuiWidget *widget, CuiWidget *old_child)
     }
 
     CuiDListRemove(&old_child->list);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_main_axis(CuiWidget *widget, CuiAxis axis)
 {
     widget->main_axis = axis;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_x_axis_gravity(CuiWidget *widget, CuiGravity gravity)
 {
     widget->x_gravity = gravity;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_y_axis_gravity(CuiWidget *widget, CuiGravity gravity)
 {
     widget->y_gravity = gravity;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_value(CuiWidget *widget, uint32_t value)
 {
     widget->value = value;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_label(CuiWidget *widget, CuiString label)
 {
     widget->label = label;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_icon(CuiWidget *widget, CuiIconType icon_type)
 {
     widget->icon_type = icon_type;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -470,6 +499,8 @@ cui_widget_set_inline_padding(CuiWidget *widget, float padding)
     widget->inline_padding = padding;
 
     widget->effective_inline_padding = lroundf(widget->ui_scale * widget->inline_padding);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -480,6 +511,8 @@ cui_widget_set_preferred_size(CuiWidget *widget, float width, float height)
 
     widget->effective_preferred_size.x = lroundf(widget->ui_scale * widget->preferred_size.x);
     widget->effective_preferred_size.y = lroundf(widget->ui_scale * widget->preferred_size.y);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -494,6 +527,8 @@ cui_widget_set_padding(CuiWidget *widget, float padding_top, float padding_right
     widget->effective_padding.min.y = lroundf(widget->ui_scale * widget->padding.min.y);
     widget->effective_padding.max.x = lroundf(widget->ui_scale * widget->padding.max.x);
     widget->effective_padding.max.y = lroundf(widget->ui_scale * widget->padding.max.y);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -508,6 +543,8 @@ cui_widget_set_border_width(CuiWidget *widget, float border_top, float border_ri
     widget->effective_border_width.min.y = lroundf(widget->ui_scale * widget->border_width.min.y);
     widget->effective_border_width.max.x = lroundf(widget->ui_scale * widget->border_width.max.x);
     widget->effective_border_width.max.y = lroundf(widget->ui_scale * widget->border_width.max.y);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -522,6 +559,8 @@ cui_widget_set_border_radius(CuiWidget *widget, float topleft, float topright, f
     widget->effective_border_radius.min.y = lroundf(widget->ui_scale * widget->border_radius.min.y);
     widget->effective_border_radius.max.x = lroundf(widget->ui_scale * widget->border_radius.max.x);
     widget->effective_border_radius.max.y = lroundf(widget->ui_scale * widget->border_radius.max.y);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
@@ -534,6 +573,8 @@ cui_widget_set_box_shadow(CuiWidget *widget, float x_offset, float y_offset, flo
     widget->effective_blur_radius = lroundf(widget->ui_scale * widget->blur_radius);
     widget->effective_shadow_offset.x = lroundf(widget->ui_scale * widget->shadow_offset.x);
     widget->effective_shadow_offset.y = lroundf(widget->ui_scale * widget->shadow_offset.y);
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 bool
@@ -560,6 +601,8 @@ cui_widget_set_ui_scale(CuiWidget *widget, float ui_scale)
 
     widget->ui_scale = ui_scale;
 
+    cui_widget_invalidate_drawing(widget);
+
     widget->effective_padding.min.x = lroundf(widget->ui_scale * widget->padding.min.x);
     widget->effective_padding.min.y = lroundf(widget->ui_scale * widget->padding.min.y);
     widget->effective_padding.max.x = lroundf(widget->ui_scale * widget->padding.max.x);
@@ -646,12 +689,28 @@ void
 cui_widget_set_font(CuiWidget *widget, CuiFontId font_id)
 {
     widget->font_id = font_id;
+
+    cui_widget_invalidate_drawing(widget);
 }
 
 void
 cui_widget_set_color_theme(CuiWidget *widget, const CuiColorTheme *color_theme)
 {
     widget->color_theme = color_theme;
+
+    cui_widget_invalidate_drawing(widget);
+}
+
+void
+cui_widget_invalidate_drawing(CuiWidget *widget)
+{
+    uint32_t drawing_version = ++_cui_context.common.widget_drawing_version;
+
+    // NOTE: The retained drawing of a widget also contains its children.
+    for (; widget; widget = widget->parent)
+    {
+        widget->drawing_version = drawing_version;
+    }
 }
 
 void
@@ -1280,14 +1339,9 @@ cui_widget_layout(CuiWidget *widget, CuiRect rect)
     }
 }
 
-void
-cui_widget_draw(CuiWidget *widget, CuiGraphicsContext *ctx, const CuiColorTheme *color_theme)
+static void
+_cui_widget_draw(CuiWidget *widget, CuiGraphicsContext *ctx, const CuiColorTheme *color_theme)
 {
-    if (widget->color_theme)
-    {
-        color_theme = widget->color_theme;
-    }
-
     if (widget->type >= CUI_WIDGET_TYPE_CUSTOM)
     {
         widget->draw(widget, ctx, color_theme);
@@ -1483,8 +1537,46 @@ cui_widget_draw(CuiWidget *widget, CuiGraphicsContext *ctx, const CuiColorTheme
     }
 }
 
-bool
-cui_widget_handle_event(CuiWidget *widget, CuiEventType event_type)
+void
+cui_widget_draw(CuiWidget *widget, CuiGraphicsContext *ctx, const CuiColorTheme *color_theme)
+{
+    if (widget->color_theme)
+    {
+        color_theme = widget->color_theme;
+    }
+
+    if ((widget->flags & CUI_WIDGET_FLAG_RETAIN_DRAWING) && ctx->retained_drawing_cache)
+    {
+        CuiRetainedDrawing key;
+
+        key.widget      = widget;
+        key.version     = widget->drawing_version;
+        key.state       = widget->state;
+        key.value       = widget->value;
+        key.flags       = widget->flags;
+        key.ui_scale    = widget->ui_scale;
+        key.color_theme = color_theme;
+        key.rect        = widget->rect;
+        key.clip_rect   = ctx->clip_rect;
+
+        if (!_cui_retained_drawing_replay(ctx, &key))
+        {
+            uint32_t push_buffer_offset = ctx->command_buffer->push_buffer_size;
+            uint32_t first_index = ctx->command_buffer->index_buffer_count;
+
+            _cui_widget_draw(widget, ctx, color_theme);
+
+            _cui_retained_drawing_record(ctx, &key, push_buffer_offset, first_index);
+        }
+    }
+    else
+    {
+        _cui_widget_draw(widget, ctx, color_theme);
+    }
+}
+
+static bool
+_cui_widget_handle_event(CuiWidget *widget, CuiEventType event_type)
 {
     bool result = false;
 
@@ -2352,3 +2444,21 @@ cui_widget_handle_event(CuiWidget *widget, CuiEventType event_type)
 
     return result;
 }
+
+bool
+cui_widget_handle_event(CuiWidget *widget, CuiEventType event_type)
+{
+    uint32_t state = widget->state;
+    uint32_t value = widget->value;
+
+    bool result = _cui_widget_handle_event(widget, event_type);
+
+    // NOTE: The retained drawings of the parents contain this widget, but their keys
+    // only cover their own state. A handled event may have changed anything else.
+    if (result || (widget->state != state) || (widget->value != value))
+    {
+        cui_widget_invalidate_drawing(widget);
+    }
+
+    return result;
+}
@@ -1,3 +1,319 @@
+static void
+_cui_glyph_prewarm_task(CuiBackgroundTask *task, void *data)
+{
+    CuiGlyphPrewarm *prewarm = (CuiGlyphPrewarm *) data;
+
+    CuiArena arena;
+    cui_arena_allocate(&arena, CuiMiB(2));
+
+    for (uint32_t index = 0; index < prewarm->count; index += 1)
+    {
+        if (_cui_atomic_read(&task->state) == CUI_BACKGROUND_TASK_STATE_CANCELING)
+        {
+            break;
+        }
+
+        _cui_glyph_rasterization_fill(prewarm->rasterizations + index, &arena);
+    }
+
+    cui_arena_deallocate(&arena);
+}
+
+// Collects the glyphs of the request at the current ui scale and starts rasterizing
+// them into bitmaps of their own. The glyphs are placed like widgets place text:
+// starting at whole pixels plus the baseline offset with any horizontal 8th substep.
+static void
+_cui_window_prewarm_glyphs(CuiWindow *window, CuiGlyphPrewarmRequest *request)
+{
+    CuiFontManager *font_manager = &window->base.font_manager;
+    CuiFont *font = _cui_font_manager_get_font_from_id(font_manager, request->font_id);
+
+    CuiAssert(font);
+
+    CuiArena *temporary_memory = &window->base.temporary_memory;
+    CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(temporary_memory);
+
+    CuiGlyphKey *keys = 0;
+    CuiGlyphRasterization *rasterizations = 0;
+    CuiFontFile **font_files = 0;
+    CuiColoredGlyphLayer *layers = 0;
+
+    cui_array_init(keys, 256, temporary_memory);
+    cui_array_init(rasterizations, 256, temporary_memory);
+    cui_array_init(font_files, 4, temporary_memory);
+    cui_array_init(layers, 16, temporary_memory);
+
+    uint64_t pixels_size = 0;
+
+    for (int32_t range_index = 0; range_index < request->range_count; range_index += 1)
+    {
+        CuiCodepointRange range = request->ranges[range_index];
+
+        uint32_t last = cui_min_uint32(range.last, 0x10FFFF);
+
+        for (uint32_t codepoint = range.first; codepoint <= last; codepoint += 1)
+        {
+            uint32_t glyph_index = 0;
+            CuiFont *used_font = font;
+
+            while (used_font)
+            {
+                CuiFontFile *font_file = _cui_font_file_manager_get_font_file_from_id(font_manager->font_file_manager, used_font->file_id);
+                glyph_index = _cui_font_file_get_glyph_index_from_codepoint(font_file, codepoint);
+
+                if (glyph_index) break;
+
+                used_font = _cui_font_manager_get_font_from_id(font_manager, used_font->fallback_id);
+            }
+
+            if (!used_font)
+            {
+                used_font = font;
+                glyph_index = 0;
+            }
+
+            CuiFontFile *used_font_file = _cui_font_file_manager_get_font_file_from_id(font_manager->font_file_manager, used_font->file_id);
+
+            // NOTE: Colored glyphs are drawn from their own cache, they are not prewarmed.
+            _cui_array_header(layers)->count = 0;
+
+            if (_cui_font_file_get_glyph_colored_layers(used_font_file, &layers, glyph_index))
+            {
+                continue;
+            }
+
+            CuiRect bounding_box = _cui_font_file_get_glyph_bounding_box(used_font_file, glyph_index);
+
+            if (!cui_rect_has_area(bounding_box))
+            {
+                continue;
+            }
+
+            CuiFloatRect bound;
+            bound.min.x = used_font->font_scale * (float) bounding_box.min.x;
+            bound.min.y = used_font->font_scale * (float) bounding_box.min.y;
+            bound.max.x = used_font->font_scale * (float) bounding_box.max.x;
+            bound.max.y = used_font->font_scale * (float) bounding_box.max.y;
+
+            int32_t first_key_index = cui_array_count(keys);
+
+            for (int32_t substep = 0; substep < 8; substep += 1)
+            {
+                float x = 0.125f * (float) substep;
+                float y = font->baseline_offset;
+
+                float draw_x = x + bound.min.x;
+                float draw_y = y - bound.max.y;
+
+                float bitmap_x = floorf(draw_x);
+                float bitmap_y = floorf(draw_y);
+
+                float offset_x = 0.125f * roundf((draw_x - bitmap_x) * 8.0f);
+                float offset_y = 0.125f * roundf((draw_y - bitmap_y) * 8.0f);
+
+                bool is_duplicate = false;
+
+                for (int32_t key_index = first_key_index; key_index < cui_array_count(keys); key_index += 1)
+                {
+                    if ((keys[key_index].offset_x == offset_x) && (keys[key_index].offset_y == offset_y))
+                    {
+                        is_duplicate = true;
+                        break;
+                    }
+                }
+
+                if (is_duplicate)
+                {
+                    continue;
+                }
+
+                CuiGlyphRasterization *rasterization = cui_array_append(rasterizations);
+
+                rasterization->font_file = used_font_file;
+                rasterization->glyph_index = glyph_index;
+                rasterization->format = CUI_TEXTURE_FORMAT_A8;
+
+                rasterization->bitmap.width  = (int32_t) ceilf(x + bound.max.x) - (int32_t) bitmap_x;
+                rasterization->bitmap.height = (int32_t) ceilf(y - bound.min.y) - (int32_t) bitmap_y;
+                rasterization->bitmap.stride = rasterization->bitmap.width;
+                rasterization->bitmap.pixels = 0;
+
+                rasterization->coverage_mode = CUI_COVERAGE_MODE_SAMPLED;
+
+                if ((float) rasterization->bitmap.height >= window->base.glyph_coverage_min_height)
+                {
+                    rasterization->coverage_mode = window->base.glyph_coverage_mode;
+                }
+
+                *cui_array_append(keys) = _cui_make_glyph_key(used_font->file_id.value, codepoint, used_font->font_scale,
+                                                              offset_x, offset_y, rasterization->coverage_mode);
+
+                CuiClearStruct(rasterization->transform);
+                rasterization->transform.m[0] = used_font->font_scale;
+                rasterization->transform.m[3] = -used_font->font_scale;
+                rasterization->transform.m[4] = offset_x - bound.min.x;
+                rasterization->transform.m[5] = offset_y + bound.max.y;
+
+                pixels_size += (uint64_t) rasterization->bitmap.width * (uint64_t) rasterization->bitmap.height;
+            }
+
+            bool is_known_font_file = false;
+
+            for (int32_t font_file_index = 0; font_file_index < cui_array_count(font_files); font_file_index += 1)
+            {
+                if (font_files[font_file_index] == used_font_file)
+                {
+                    is_known_font_file = true;
+                    break;
+                }
+            }
+
+            if (!is_known_font_file)
+            {
+                *cui_array_append(font_files) = used_font_file;
+            }
+        }
+    }
+
+    uint32_t count = (uint32_t) cui_array_count(keys);
+
+    if (count)
+    {
+        int32_t font_file_count = cui_array_count(font_files);
+
+        // NOTE: The font files are copied because the array of the font file manager can move
+        // while the glyphs are rasterized in the background. Their contents stay in place.
+        uint64_t prewarm_size = CuiAlign(sizeof(CuiGlyphPrewarm), 16);
+        uint64_t font_files_size = CuiAlign(font_file_count * sizeof(CuiFontFile), 16);
+        uint64_t keys_size = CuiAlign(count * sizeof(CuiGlyphKey), 16);
+        uint64_t rasterizations_size = CuiAlign(count * sizeof(CuiGlyphRasterization), 16);
+        uint64_t allocation_size = prewarm_size + font_files_size + keys_size + rasterizations_size + pixels_size;
+
+        uint8_t *allocation = (uint8_t *) cui_platform_allocate(allocation_size);
+
+        CuiGlyphPrewarm *prewarm = (CuiGlyphPrewarm *) allocation;
+        CuiFontFile *font_file_copies = (CuiFontFile *) (allocation + prewarm_size);
+
+        prewarm->next = 0;
+        prewarm->in_background = request->in_background;
+        prewarm->ui_scale = window->base.ui_scale;
+        prewarm->count = count;
+        prewarm->keys = (CuiGlyphKey *) (allocation + prewarm_size + font_files_size);
+        prewarm->rasterizations = (CuiGlyphRasterization *) (allocation + prewarm_size + font_files_size + keys_size);
+        prewarm->allocation_size = allocation_size;
+
+        for (int32_t font_file_index = 0; font_file_index < font_file_count; font_file_index += 1)
+        {
+            font_file_copies[font_file_index] = *font_files[font_file_index];
+        }
+
+        cui_copy_memory(prewarm->keys, keys, count * sizeof(CuiGlyphKey));
+        cui_copy_memory(prewarm->rasterizations, rasterizations, count * sizeof(CuiGlyphRasterization));
+
+        uint8_t *pixels = allocation + prewarm_size + font_files_size + keys_size + rasterizations_size;
+
+        for (uint32_t index = 0; index < count; index += 1)
+        {
+            CuiGlyphRasterization *rasterization = prewarm->rasterizations + index;
+
+            for (int32_t font_file_index = 0; font_file_index < font_file_count; font_file_index += 1)
+            {
+                if (font_files[font_file_index] == rasterization->font_file)
+                {
+                    rasterization->font_file = font_file_copies + font_file_index;
+                    break;
+                }
+            }
+
+            rasterization->bitmap.pixels = pixels;
+            pixels += rasterization->bitmap.width * rasterization->bitmap.height;
+        }
+
+        CuiGlyphPrewarm **last_prewarm = &window->base.glyph_prewarms;
+
+        while (*last_prewarm)
+        {
+            last_prewarm = &(*last_prewarm)->next;
+        }
+
+        *last_prewarm = prewarm;
+
+        if (!prewarm->in_background || !cui_background_task_start(&prewarm->task, _cui_glyph_prewarm_task, prewarm, true))
+        {
+            CuiGlyphRasterizationQueue queue;
+            queue.count = count;
+            queue.allocated = count;
+            queue.entries = prewarm->rasterizations;
+
+            cui_parallel_for(count, 0, _cui_glyph_rasterization_task, &queue);
+
+            prewarm->in_background = false;
+        }
+    }
+
+    cui_end_temporary_memory(temp_memory);
+}
+
+// Copies the glyphs that were rasterized ahead of time into the glyph cache.
+static void
+_cui_window_insert_prewarmed_glyphs(CuiWindow *window, CuiCommandBuffer *command_buffer)
+{
+    CuiGlyphCache *glyph_cache = window->base.glyph_cache;
+    CuiGlyphPrewarm **link = &window->base.glyph_prewarms;
+
+    while (*link)
+    {
+        CuiGlyphPrewarm *prewarm = *link;
+
+        if (prewarm->in_background && !cui_background_task_has_finished(&prewarm->task))
+        {
+            link = &prewarm->next;
+            continue;
+        }
+
+        // NOTE: Glyphs of a previous ui scale are not going to be drawn anymore.
+        if (prewarm->ui_scale == window->base.ui_scale)
+        {
+            for (uint32_t index = 0; index < prewarm->count; index += 1)
+            {
+                CuiGlyphKey *key = prewarm->keys + index;
+
+                CuiRect uv;
+
+                if (!_cui_glyph_cache_find_key(glyph_cache, key, &uv))
+                {
+                    CuiBitmap *src = &prewarm->rasterizations[index].bitmap;
+
+                    uv = _cui_glyph_cache_allocate_texture(glyph_cache, src->width, src->height, command_buffer);
+
+                    // NOTE: If the glyph cache is full the rest is left to drawing.
+                    if (!cui_rect_has_area(uv))
+                    {
+                        break;
+                    }
+
+                    CuiBitmap dst = _cui_glyph_cache_get_bitmap(glyph_cache, uv);
+
+                    uint8_t *src_row = (uint8_t *) src->pixels;
+                    uint8_t *dst_row = (uint8_t *) dst.pixels;
+
+                    for (int32_t y = 0; y < src->height; y += 1)
+                    {
+                        cui_copy_memory(dst_row, src_row, src->width);
+                        src_row += src->stride;
+                        dst_row += dst.stride;
+                    }
+
+                    _cui_glyph_cache_put_key(glyph_cache, key, uv);
+                }
+            }
+        }
+
+        *link = prewarm->next;
+        cui_platform_deallocate(prewarm, prewarm->allocation_size);
+    }
+}
+
 static inline void
 _cui_window_set_ui_scale(CuiWindow *window, float ui_scale)
 {
@@ -11,6 +327,11 @@ _cui_window_set_ui_scale(CuiWindow *window, float ui_scale)
             _cui_sized_font_update(sized_font, window->base.font_manager.font_file_manager, window->base.ui_scale);
         }
 
+        for (int32_t i = 0; i < cui_array_count(window->base.glyph_prewarm_requests); i += 1)
+        {
+            _cui_window_prewarm_glyphs(window, window->base.glyph_prewarm_requests + i);
+        }
+
         if (window->base.platform_root_widget)
         {
             cui_widget_set_ui_scale(window->base.platform_root_widget, window->base.ui_scale);
@@ -18,6 +339,124 @@ _cui_window_set_ui_scale(CuiWindow *window, float ui_scale)
     }
 }
 
+static inline void
+_cui_window_store_glyph_cache(CuiWindow *window)
+{
+    if ((window->base.creation_flags & CUI_WINDOW_CREATION_FLAG_PERSISTENT_GLYPH_CACHE) &&
+        window->base.glyph_cache && window->base.glyph_cache->allocated)
+    {
+        _cui_glyph_cache_store(window->base.glyph_cache, window->base.font_manager.font_file_manager, &window->base.temporary_memory);
+    }
+}
+
+static void
+_cui_window_set_up_glyph_caches(CuiWindow *window)
+{
+    if (window->base.creation_flags & CUI_WINDOW_CREATION_FLAG_SHARED_GLYPH_CACHE)
+    {
+        // NOTE: The glyph caches are shared per renderer type, because the size
+        // of the texture depends on the limits of the renderer.
+        CuiSharedGlyphCache *shared_glyph_cache = _cui_context.common.shared_glyph_caches + window->base.renderer->type;
+
+        shared_glyph_cache->ref_count += 1;
+
+        window->base.shared_glyph_cache = shared_glyph_cache;
+        window->base.glyph_cache = &shared_glyph_cache->glyph_cache;
+        window->base.color_glyph_cache = &shared_glyph_cache->color_glyph_cache;
+    }
+    else
+    {
+        window->base.glyph_cache = &window->base.window_glyph_cache;
+        window->base.color_glyph_cache = &window->base.window_color_glyph_cache;
+    }
+
+    // NOTE: The texture of the color glyph cache is allocated with the first colored glyph.
+    window->base.glyph_cache_texture.texture_id = cui_window_allocate_texture_id(window);
+    window->base.color_glyph_cache_texture.texture_id = cui_window_allocate_texture_id(window);
+
+    _cui_glyph_cache_add_window_texture(window->base.glyph_cache, &window->base.glyph_cache_texture);
+    _cui_glyph_cache_add_window_texture(window->base.color_glyph_cache, &window->base.color_glyph_cache_texture);
+}
+
+static inline void
+_cui_window_deallocate_glyph_caches(CuiWindow *window)
+{
+    if (window->base.glyph_cache)
+    {
+        _cui_glyph_cache_remove_window_texture(window->base.glyph_cache, &window->base.glyph_cache_texture);
+        _cui_glyph_cache_remove_window_texture(window->base.color_glyph_cache, &window->base.color_glyph_cache_texture);
+
+        if (window->base.shared_glyph_cache)
+        {
+            CuiSharedGlyphCache *shared_glyph_cache = window->base.shared_glyph_cache;
+
+            CuiAssert(shared_glyph_cache->ref_count > 0);
+            shared_glyph_cache->ref_count -= 1;
+
+            if (!shared_glyph_cache->ref_count)
+            {
+                _cui_glyph_cache_deallocate(&shared_glyph_cache->glyph_cache);
+                _cui_glyph_cache_deallocate(&shared_glyph_cache->color_glyph_cache);
+            }
+        }
+        else
+        {
+            _cui_glyph_cache_deallocate(&window->base.window_glyph_cache);
+            _cui_glyph_cache_deallocate(&window->base.window_color_glyph_cache);
+        }
+
+        window->base.glyph_cache = 0;
+        window->base.color_glyph_cache = 0;
+        window->base.shared_glyph_cache = 0;
+    }
+}
+
+static inline void
+_cui_window_deallocate_retained_drawings(CuiWindow *window)
+{
+    _cui_retained_drawing_cache_deallocate(window->base.retained_drawing_caches + 0);
+    _cui_retained_drawing_cache_deallocate(window->base.retained_drawing_caches + 1);
+}
+
+static inline void
+_cui_window_deallocate_glyph_rasterizations(CuiWindow *window)
+{
+    _cui_glyph_rasterization_queue_deallocate(&window->base.glyph_rasterization_queue);
+
+    while (window->base.glyph_prewarms)
+    {
+        CuiGlyphPrewarm *prewarm = window->base.glyph_prewarms;
+
+        // NOTE: A canceled task is still referenced by the background queue until it is finished.
+        if (prewarm->in_background)
+        {
+            cui_background_task_cancel(&prewarm->task);
+
+            while (!cui_background_task_has_finished(&prewarm->task))
+            {
+                _cui_cpu_relax();
+            }
+        }
+
+        window->base.glyph_prewarms = prewarm->next;
+        cui_platform_deallocate(prewarm, prewarm->allocation_size);
+    }
+}
+
+static inline void
+_cui_window_deallocate_texture_slots(CuiWindow *window)
+{
+    if (window->base.texture_slots)
+    {
+        cui_platform_deallocate(window->base.texture_slots, window->base.max_texture_slot_count * sizeof(CuiTextureSlot));
+    }
+
+    window->base.texture_slot_count = 0;
+    window->base.max_texture_slot_count = 0;
+    window->base.first_free_texture_slot = 0;
+    window->base.texture_slots = 0;
+}
+
 static CuiFramebuffer *
 _cui_window_frame_routine(CuiWindow *window, CuiEvent *events, CuiWindowFrameResult *window_frame_result)
 {
@@ -45,14 +484,54 @@ _cui_window_frame_routine(CuiWindow *window, CuiEvent *events, CuiWindowFrameRes
 
         if (window->base.platform_root_widget)
         {
-            if (!window->base.glyph_cache.allocated)
+            if (!window->base.glyph_cache)
             {
-                _cui_glyph_cache_initialize(&window->base.glyph_cache, command_buffer,
-                                            cui_window_allocate_texture_id(window));
+                _cui_window_set_up_glyph_caches(window);
+            }
+
+            CuiGlyphCache *glyph_cache = window->base.glyph_cache;
+            CuiGlyphCache *color_glyph_cache = window->base.color_glyph_cache;
+
+            _cui_glyph_cache_bind_texture(glyph_cache, &window->base.glyph_cache_texture, command_buffer);
+            _cui_glyph_cache_bind_texture(color_glyph_cache, &window->base.color_glyph_cache_texture, command_buffer);
+
+            if (!glyph_cache->allocated)
+            {
+                _cui_glyph_cache_initialize(glyph_cache, command_buffer, glyph_cache->texture_id,
+                                            CUI_TEXTURE_FORMAT_A8, CUI_GLYPH_CACHE_TEXTURE_SIZE);
+
+                if (window->base.creation_flags & CUI_WINDOW_CREATION_FLAG_PERSISTENT_GLYPH_CACHE)
+                {
+                    _cui_glyph_cache_load(glyph_cache, window->base.font_manager.font_file_manager,
+                                          command_buffer, &window->base.temporary_memory);
+                }
             }
             else
             {
-                _cui_glyph_cache_maybe_reset(&window->base.glyph_cache, command_buffer);
+                _cui_glyph_cache_maybe_evict(glyph_cache, command_buffer);
+            }
+
+            if (color_glyph_cache->allocated)
+            {
+                _cui_glyph_cache_maybe_evict(color_glyph_cache, command_buffer);
+            }
+
+            _cui_window_insert_prewarmed_glyphs(window, command_buffer);
+
+            window->base.retained_drawing_index ^= 1;
+
+            CuiRetainedDrawingCache *retained_drawing_cache = window->base.retained_drawing_caches + window->base.retained_drawing_index;
+            CuiRetainedDrawingCache *prev_retained_drawing_cache = window->base.retained_drawing_caches + (window->base.retained_drawing_index ^ 1);
+
+            _cui_retained_drawing_cache_clear(retained_drawing_cache);
+
+            // The drawings of the last frame may reference glyphs that are no longer in the cache.
+            if ((window->base.retained_drawing_glyph_cache_generation != glyph_cache->generation) ||
+                (window->base.retained_drawing_color_glyph_cache_generation != color_glyph_cache->generation))
+            {
+                _cui_retained_drawing_cache_clear(prev_retained_drawing_cache);
+                window->base.retained_drawing_glyph_cache_generation = glyph_cache->generation;
+                window->base.retained_drawing_color_glyph_cache_generation = color_glyph_cache->generation;
             }
 
             CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(&window->base.temporary_memory);
@@ -64,9 +543,15 @@ _cui_window_frame_routine(CuiWindow *window, CuiEvent *events, CuiWindowFrameRes
             ctx.clip_rect = window_rect;
             ctx.window_rect = window_rect;
             ctx.command_buffer = command_buffer;
-            ctx.glyph_cache = &window->base.glyph_cache;
+            ctx.glyph_cache = glyph_cache;
+            ctx.color_glyph_cache = color_glyph_cache;
+            ctx.glyph_rasterization_queue = &window->base.glyph_rasterization_queue;
+            ctx.glyph_coverage_mode = window->base.glyph_coverage_mode;
+            ctx.glyph_coverage_min_height = window->base.glyph_coverage_min_height;
             ctx.temporary_memory = &window->base.temporary_memory;
             ctx.font_manager = &window->base.font_manager;
+            ctx.retained_drawing_cache = retained_drawing_cache;
+            ctx.prev_retained_drawing_cache = prev_retained_drawing_cache;
 
             const CuiColorTheme *color_theme = &cui_color_theme_default_dark;
 
@@ -77,6 +562,8 @@ _cui_window_frame_routine(CuiWindow *window, CuiEvent *events, CuiWindowFrameRes
 
             cui_widget_draw(window->base.platform_root_widget, &ctx, color_theme);
 
+            _cui_glyph_rasterization_queue_flush(ctx.glyph_rasterization_queue);
+
 #if 0
             int32_t texture_width = ctx.glyph_cache->texture.width;
             int32_t texture_height = ctx.glyph_cache->texture.height;
@@ -124,6 +611,36 @@ _cui_window_frame_routine(CuiWindow *window, CuiEvent *events, CuiWindowFrameRes
             clear_color = CuiHexColor(0x00000000);
         }
 
+#endif
+
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+
+        // The capture is written before rendering, because the renderer might merge primitives
+        // and the textures of the renderer still have to be combined with this frame's operations.
+        if (window->base.capture_command_buffer)
+        {
+            CuiTextureTable *texture_table = _cui_renderer_get_texture_table(window->base.renderer);
+
+            CuiArena capture_arena;
+            cui_arena_allocate(&capture_arena, _cui_command_buffer_get_capture_size(command_buffer, texture_table) + CuiKiB(4));
+
+            CuiString capture_data = _cui_command_buffer_encode_capture(command_buffer, texture_table, window->base.width,
+                                                                        window->base.height, clear_color, &capture_arena);
+
+            CuiFile *capture_file = cui_platform_file_create(&capture_arena, CuiStringLiteral("capture_cui.bin"));
+
+            if (capture_file)
+            {
+                cui_platform_file_truncate(capture_file, capture_data.count);
+                cui_platform_file_write(capture_file, capture_data.data, 0, capture_data.count);
+                cui_platform_file_close(capture_file);
+            }
+
+            cui_arena_deallocate(&capture_arena);
+
+            window->base.capture_command_buffer = false;
+        }
+
 #endif
 
         framebuffer = _cui_acquire_framebuffer(window, window->base.width, window->base.height);
@@ -573,33 +1090,81 @@ cui_window_handle_event(CuiWindow *window, CuiEventType event_type)
 int32_t
 cui_window_allocate_texture_id(CuiWindow *window)
 {
-    CuiAssert((8 * sizeof(window->base.allocated_texture_ids)) >= CUI_MAX_TEXTURE_COUNT);
-
     int32_t texture_id = -1;
 
-    uint32_t index = 0;
-    uint32_t mask = ~window->base.allocated_texture_ids;
-
-    if (cui_count_trailing_zeros_u32(&index, mask) && (index < CUI_MAX_TEXTURE_COUNT))
+    if (!window->base.first_free_texture_slot)
     {
-        window->base.allocated_texture_ids |= ((uint32_t) 1 << index);
-        texture_id = (int32_t) index;
+        uint32_t max_texture_count = CUI_MAX_TEXTURE_COUNT;
+
+        if (window->base.renderer)
+        {
+            max_texture_count = _cui_renderer_get_max_texture_count(window->base.renderer);
+        }
+
+        if (window->base.texture_slot_count >= max_texture_count)
+        {
+            return texture_id;
+        }
+
+        if (window->base.texture_slot_count == window->base.max_texture_slot_count)
+        {
+            uint32_t max_texture_slot_count = cui_max_uint32(2 * window->base.max_texture_slot_count, CUI_MAX_TEXTURE_COUNT);
+            CuiTextureSlot *texture_slots = (CuiTextureSlot *) cui_platform_allocate(max_texture_slot_count * sizeof(CuiTextureSlot));
+
+            if (window->base.texture_slots)
+            {
+                cui_copy_memory(texture_slots, window->base.texture_slots, window->base.texture_slot_count * sizeof(CuiTextureSlot));
+                cui_platform_deallocate(window->base.texture_slots, window->base.max_texture_slot_count * sizeof(CuiTextureSlot));
+            }
+
+            window->base.max_texture_slot_count = max_texture_slot_count;
+            window->base.texture_slots = texture_slots;
+        }
+
+        CuiTextureSlot *slot = window->base.texture_slots + window->base.texture_slot_count;
+
+        slot->generation = 1;
+        slot->is_allocated = false;
+        slot->next_free = 0;
+
+        window->base.texture_slot_count += 1;
+        window->base.first_free_texture_slot = window->base.texture_slot_count;
     }
 
+    uint32_t index = window->base.first_free_texture_slot - 1;
+    CuiTextureSlot *slot = window->base.texture_slots + index;
+
+    CuiAssert(!slot->is_allocated);
+
+    window->base.first_free_texture_slot = slot->next_free;
+
+    slot->is_allocated = true;
+    slot->next_free = 0;
+
+    texture_id = (int32_t) (((uint32_t) slot->generation << CUI_TEXTURE_ID_INDEX_BITS) | index);
+
     return texture_id;
 }
 
 void
 cui_window_deallocate_texture_id(CuiWindow *window, int32_t texture_id)
 {
-    CuiAssert(texture_id >= 0);
-    CuiAssert(texture_id < CUI_MAX_TEXTURE_COUNT);
+    CuiAssert(texture_id > 0);
 
-    uint32_t bit_mask = (1 << texture_id);
+    uint32_t index = _cui_texture_id_get_index((uint32_t) texture_id);
 
-    CuiAssert(window->base.allocated_texture_ids & bit_mask);
+    CuiAssert(index < window->base.texture_slot_count);
 
-    window->base.allocated_texture_ids &= ~bit_mask;
+    CuiTextureSlot *slot = window->base.texture_slots + index;
+
+    CuiAssert(slot->is_allocated);
+    CuiAssert(slot->generation == ((uint32_t) texture_id >> CUI_TEXTURE_ID_INDEX_BITS));
+
+    slot->generation = (slot->generation < CUI_TEXTURE_ID_MAX_GENERATION) ? (slot->generation + 1) : 1;
+    slot->is_allocated = false;
+    slot->next_free = window->base.first_free_texture_slot;
+
+    window->base.first_free_texture_slot = index + 1;
 }
 
 CuiFontId
@@ -635,6 +1200,78 @@ cui_window_update_font(CuiWindow *window, CuiFontId font_id, float size, float l
     }
 }
 
+void
+cui_window_prewarm_font(CuiWindow *window, CuiFontId font_id, const CuiCodepointRange *ranges, int32_t range_count, bool in_background)
+{
+    CuiArena *arena = &window->base.font_manager.arena;
+
+    if (!window->base.glyph_prewarm_requests)
+    {
+        cui_array_init(window->base.glyph_prewarm_requests, 4, arena);
+    }
+
+    CuiGlyphPrewarmRequest *request = cui_array_append(window->base.glyph_prewarm_requests);
+
+    request->font_id = font_id;
+    request->in_background = in_background;
+
+    if (range_count > 0)
+    {
+        request->range_count = range_count;
+        request->ranges = cui_alloc_array(arena, CuiCodepointRange, range_count, CuiDefaultAllocationParams());
+
+        cui_copy_memory(request->ranges, (void *) ranges, range_count * sizeof(CuiCodepointRange));
+    }
+    else
+    {
+        request->range_count = 1;
+        request->ranges = cui_alloc_type(arena, CuiCodepointRange, CuiDefaultAllocationParams());
+        request->ranges[0] = cui_make_codepoint_range(0x20, 0x7E);
+    }
+
+    _cui_window_prewarm_glyphs(window, request);
+}
+
+void
+cui_window_set_glyph_coverage_mode(CuiWindow *window, CuiCoverageMode coverage_mode, float min_glyph_height)
+{
+    if ((window->base.glyph_coverage_mode != coverage_mode) ||
+        (window->base.glyph_coverage_min_height != min_glyph_height))
+    {
+        window->base.glyph_coverage_mode = coverage_mode;
+        window->base.glyph_coverage_min_height = min_glyph_height;
+
+        // NOTE: Retained drawings still reference the glyphs of the previous mode.
+        _cui_retained_drawing_cache_clear(window->base.retained_drawing_caches + 0);
+        _cui_retained_drawing_cache_clear(window->base.retained_drawing_caches + 1);
+
+        window->base.needs_redraw = true;
+    }
+}
+
+void
+cui_window_set_occlusion_culling(CuiWindow *window, bool enabled)
+{
+    if (window->base.renderer && (_cui_renderer_get_occlusion_culling(window->base.renderer) != enabled))
+    {
+        _cui_renderer_set_occlusion_culling(window->base.renderer, enabled);
+        window->base.needs_redraw = true;
+    }
+}
+
+bool
+cui_window_get_occlusion_culling(CuiWindow *window)
+{
+    bool enabled = false;
+
+    if (window->base.renderer)
+    {
+        enabled = _cui_renderer_get_occlusion_culling(window->base.renderer);
+    }
+
+    return enabled;
+}
+
 int32_t
 cui_window_get_font_line_height(CuiWindow *window, CuiFontId font_id)
 {
@@ -8,7 +8,7 @@
 static DWORD
 _cui_worker_thread_proc(void *data)
 {
-    (void) data;
+    _cui_worker_thread_index = (uint32_t) (uintptr_t) data;
 
     CuiWorkerThreadQueue *queue = &_cui_context.common.worker_thread_queue;
 
@@ -16,7 +16,14 @@ _cui_worker_thread_proc(void *data)
     {
         if (_cui_do_next_worker_thread_queue_entry(queue))
         {
-            WaitForSingleObject(queue->semaphore, INFINITE);
+            _cui_atomic_increment(&queue->sleeping_count);
+
+            if (!_cui_atomic_read(&queue->pending_count))
+            {
+                WaitForSingleObject(queue->semaphore, INFINITE);
+            }
+
+            _cui_atomic_decrement(&queue->sleeping_count);
         }
     }
 
@@ -182,6 +189,12 @@ _cui_initialize_direct3d11(CuiWindow *window)
 static void
 _cui_window_destroy(CuiWindow *window)
 {
+    _cui_window_store_glyph_cache(window);
+    _cui_window_deallocate_retained_drawings(window);
+    _cui_window_deallocate_glyph_rasterizations(window);
+    _cui_window_deallocate_glyph_caches(window);
+    _cui_window_deallocate_texture_slots(window);
+
     switch (window->base.renderer->type)
     {
         case CUI_RENDERER_TYPE_SOFTWARE:
@@ -944,6 +957,14 @@ _cui_window_callback(HWND window_handle, UINT message, WPARAM w_param, LPARAM l_
                         window->base.needs_redraw = true;
                     }
                     else
+#endif
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+                    if (w_param == VK_F3)
+                    {
+                        window->base.capture_command_buffer = true;
+                        window->base.needs_redraw = true;
+                    }
+                    else
 #endif
                     {
                         _CUI_KEY_DOWN_EVENT(CUI_KEY_F1 + (w_param - VK_F1));
@@ -1457,7 +1478,7 @@ cui_platform_file_truncate(CuiFile *file, uint64_t size)
     SetFilePointerEx((HANDLE) file, trunc_size, 0, FILE_BEGIN);
 }
 
-void
+uint64_t
 cui_platform_file_read(CuiFile *file, void *buffer, uint64_t offset, uint64_t size)
 {
     CuiAssert(file);
@@ -1466,7 +1487,13 @@ cui_platform_file_read(CuiFile *file, void *buffer, uint64_t offset, uint64_t si
     LARGE_INTEGER seek_offset;
     seek_offset.QuadPart = offset;
     SetFilePointerEx((HANDLE) file, seek_offset, 0, FILE_BEGIN);
-    ReadFile((HANDLE) file, buffer, size, &bytes_read, 0);
+
+    if (!ReadFile((HANDLE) file, buffer, size, &bytes_read, 0))
+    {
+        return 0;
+    }
+
+    return bytes_read;
 }
 
 void
@@ -1614,10 +1641,15 @@ cui_init(int argument_count, char **arguments)
 
     int32_t worker_thread_count = cui_platform_get_performance_core_count() - 1;
 
-    worker_thread_count = cui_max_int32(1, cui_min_int32(worker_thread_count, 15));
+    worker_thread_count = cui_max_int32(1, worker_thread_count);
+
+    if (!_cui_init_worker_thread_queue(&_cui_context.common.worker_thread_queue, worker_thread_count))
+    {
+        return false;
+    }
 
     _cui_context.common.worker_thread_queue.semaphore =
-        CreateSemaphore(0, 0, CuiArrayCount(_cui_context.common.worker_thread_queue.entries), 0);
+        CreateSemaphore(0, 0, INT32_MAX, 0);
     _cui_context.common.interactive_background_thread_queue.semaphore =
         CreateSemaphore(0, 0, CuiArrayCount(_cui_context.common.interactive_background_thread_queue.entries), 0);
     _cui_context.common.non_interactive_background_thread_queue.semaphore =
@@ -1627,7 +1659,7 @@ cui_init(int argument_count, char **arguments)
          worker_thread_index < worker_thread_count;
          worker_thread_index += 1)
     {
-        CreateThread(0, 0, _cui_worker_thread_proc, 0, 0, 0);
+        CreateThread(0, 0, _cui_worker_thread_proc, (void *) (uintptr_t) (worker_thread_index + 1), 0, 0);
     }
 
     CreateThread(0, 0, _cui_background_thread_proc, &_cui_context.common.interactive_background_thread_queue, 0, 0);
@@ -0,0 +1,285 @@
+// Rasterizes every glyph of the given TrueType fonts with both coverage modes (see CuiCoverageMode)
+// and prints how long that took for every pixel size.
+//
+//   glyph_benchmark <font file>... [-n <iterations>] [-s <pixel size>]...
+//
+// The outlines are converted to edge lists up front, so only the fill itself is measured.
+// 'difference' is the mean absolute difference between both modes in steps of 1/255.
+
+#include <stdio.h>
+
+#include "cui.c"
+
+typedef struct CuiBenchmarkGlyph
+{
+    CuiEdge *edges;
+    CuiBitmap bitmap;
+} CuiBenchmarkGlyph;
+
+static bool
+_cui_benchmark_load_font(CuiFontFile *font_file, CuiString filename, CuiArena *arena)
+{
+    CuiFile *file = cui_platform_file_open(&_cui_context.common.temporary_memory, filename, CUI_FILE_MODE_READ);
+
+    if (!file)
+    {
+        fprintf(stderr, "error: could not open '%.*s'\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    uint64_t size = cui_platform_file_get_size(file);
+    uint8_t *data = (uint8_t *) cui_alloc(arena, size, CuiDefaultAllocationParams());
+
+    if (!data)
+    {
+        fprintf(stderr, "error: could not allocate %llu bytes\n", (unsigned long long) size);
+        cui_platform_file_close(file);
+        return false;
+    }
+
+    cui_platform_file_read(file, data, 0, size);
+    cui_platform_file_close(file);
+
+    if (!_cui_font_file_init(font_file, data, size) || !font_file->glyf)
+    {
+        fprintf(stderr, "error: '%.*s' is not a TrueType font\n", (int) filename.count, filename.data);
+        return false;
+    }
+
+    return true;
+}
+
+// Places the glyph on the pixel grid like _cui_draw_glyph does for a glyph at the origin.
+static bool
+_cui_benchmark_add_glyph(CuiBenchmarkGlyph **glyphs, CuiFontFile *font_file, uint32_t glyph_index, float font_scale, CuiArena *arena)
+{
+    CuiRect bounding_box = _cui_font_file_get_glyph_bounding_box(font_file, glyph_index);
+
+    if (!cui_rect_has_area(bounding_box))
+    {
+        return false;
+    }
+
+    CuiFloatRect bound;
+    bound.min.x = font_scale * (float) bounding_box.min.x;
+    bound.min.y = font_scale * (float) bounding_box.min.y;
+    bound.max.x = font_scale * (float) bounding_box.max.x;
+    bound.max.y = font_scale * (float) bounding_box.max.y;
+
+    float bitmap_x = floorf(bound.min.x);
+    float bitmap_y = floorf(-bound.max.y);
+
+    CuiTransform transform;
+    CuiClearStruct(transform);
+    transform.m[0] = font_scale;
+    transform.m[3] = -font_scale;
+    transform.m[4] = (bound.min.x - bitmap_x) - bound.min.x;
+    transform.m[5] = (-bound.max.y - bitmap_y) + bound.max.y;
+
+    CuiBenchmarkGlyph *glyph = cui_array_append(*glyphs);
+
+    CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(&_cui_context.common.temporary_memory);
+
+    CuiPathCommand *outline = 0;
+    cui_array_init(outline, 16, &_cui_context.common.temporary_memory);
+
+    _cui_font_file_get_glyph_outline(font_file, &outline, glyph_index, transform, &_cui_context.common.temporary_memory);
+
+    glyph->edges = 0;
+    cui_array_init(glyph->edges, 16, arena);
+    _cui_path_to_edge_list(outline, &glyph->edges);
+
+    cui_end_temporary_memory(temp_memory);
+
+    glyph->bitmap.width = (int32_t) ceilf(bound.max.x) - (int32_t) bitmap_x;
+    glyph->bitmap.height = (int32_t) ceilf(-bound.min.y) - (int32_t) bitmap_y;
+    glyph->bitmap.stride = glyph->bitmap.width;
+    glyph->bitmap.pixels = 0;
+
+    return true;
+}
+
+static inline void
+_cui_benchmark_fill(CuiBenchmarkGlyph *glyph, CuiBitmap *bitmap, CuiCoverageMode coverage_mode)
+{
+    *bitmap = glyph->bitmap;
+    cui_clear_memory(bitmap->pixels, (uint64_t) bitmap->stride * (uint64_t) bitmap->height);
+
+    if (coverage_mode == CUI_COVERAGE_MODE_ANALYTIC)
+    {
+        _cui_edge_list_fill_analytic(&_cui_context.common.temporary_memory, bitmap, CUI_TEXTURE_FORMAT_A8,
+                                     glyph->edges, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+    }
+    else
+    {
+        _cui_edge_list_fill(&_cui_context.common.temporary_memory, bitmap, CUI_TEXTURE_FORMAT_A8,
+                            glyph->edges, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));
+    }
+}
+
+static inline double
+_cui_benchmark_to_ms(uint64_t time)
+{
+    return (1000.0 * (double) time) / (double) _cui_context.common.perf_frequency;
+}
+
+int main(int argument_count, char **arguments)
+{
+    CuiArena arena;
+    cui_arena_allocate(&arena, CuiGiB(1));
+
+    _cui_context.common.perf_frequency = cui_platform_get_performance_frequency();
+    cui_arena_allocate(&_cui_context.common.temporary_memory, CuiMiB(16));
+
+    CuiString *font_filenames = 0;
+    cui_array_init(font_filenames, 8, &arena);
+
+    float *sizes = 0;
+    cui_array_init(sizes, 8, &arena);
+
+    int32_t iteration_count = 5;
+
+    for (int argument_index = 1; argument_index < argument_count; argument_index += 1)
+    {
+        CuiString argument = CuiCString(arguments[argument_index]);
+
+        if (cui_string_equals(argument, CuiStringLiteral("-n")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            iteration_count = cui_max_int32(1, cui_string_parse_int32(CuiCString(arguments[argument_index])));
+        }
+        else if (cui_string_equals(argument, CuiStringLiteral("-s")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            *cui_array_append(sizes) = (float) cui_max_int32(1, cui_string_parse_int32(CuiCString(arguments[argument_index])));
+        }
+        else
+        {
+            *cui_array_append(font_filenames) = argument;
+        }
+    }
+
+    if (!cui_array_count(font_filenames))
+    {
+        fprintf(stderr, "usage: %s <font file>... [-n <iterations>] [-s <pixel size>]...\n", arguments[0]);
+        return 1;
+    }
+
+    if (!cui_array_count(sizes))
+    {
+        float default_sizes[] = { 10.0f, 14.0f, 20.0f, 32.0f, 64.0f, 128.0f, 256.0f };
+
+        for (uint32_t index = 0; index < CuiArrayCount(default_sizes); index += 1)
+        {
+            *cui_array_append(sizes) = default_sizes[index];
+        }
+    }
+
+    int32_t font_count = cui_array_count(font_filenames);
+    CuiFontFile *font_files = cui_alloc_array(&arena, CuiFontFile, font_count, CuiDefaultAllocationParams());
+
+    for (int32_t font_index = 0; font_index < font_count; font_index += 1)
+    {
+        if (!_cui_benchmark_load_font(font_files + font_index, font_filenames[font_index], &arena))
+        {
+            return 1;
+        }
+    }
+
+    printf("%d fonts, %d iterations\n", font_count, iteration_count);
+    printf("  %6s  %7s  %10s  %13s  %13s  %8s  %10s\n", "size", "glyphs", "pixels", "sampled", "analytic", "speedup", "difference");
+
+    for (int32_t size_index = 0; size_index < cui_array_count(sizes); size_index += 1)
+    {
+        CuiTemporaryMemory temp_memory = cui_begin_temporary_memory(&arena);
+
+        CuiBenchmarkGlyph *glyphs = 0;
+        cui_array_init(glyphs, 1024, &arena);
+
+        int32_t max_width = 0;
+        int32_t max_height = 0;
+        uint64_t pixel_count = 0;
+
+        for (int32_t font_index = 0; font_index < font_count; font_index += 1)
+        {
+            CuiFontFile *font_file = font_files + font_index;
+            float font_scale = _cui_font_file_get_scale_for_unit_height(font_file, sizes[size_index]);
+
+            for (uint32_t glyph_index = 1; glyph_index < font_file->glyph_count; glyph_index += 1)
+            {
+                if (_cui_benchmark_add_glyph(&glyphs, font_file, glyph_index, font_scale, &arena))
+                {
+                    CuiBitmap *bitmap = &glyphs[cui_array_count(glyphs) - 1].bitmap;
+
+                    max_width = cui_max_int32(max_width, bitmap->width);
+                    max_height = cui_max_int32(max_height, bitmap->height);
+                    pixel_count += (uint64_t) bitmap->width * (uint64_t) bitmap->height;
+                }
+            }
+        }
+
+        uint64_t max_pixel_count = (uint64_t) max_width * (uint64_t) max_height;
+
+        uint8_t *sampled_pixels = (uint8_t *) cui_alloc(&arena, max_pixel_count, CuiDefaultAllocationParams());
+        uint8_t *analytic_pixels = (uint8_t *) cui_alloc(&arena, max_pixel_count, CuiDefaultAllocationParams());
+
+        if (!sampled_pixels || !analytic_pixels)
+        {
+            fprintf(stderr, "error: could not allocate the glyphs of size %g\n", sizes[size_index]);
+            return 1;
+        }
+
+        uint64_t times[2] = { UINT64_MAX, UINT64_MAX };
+
+        for (int32_t iteration = 0; iteration < iteration_count; iteration += 1)
+        {
+            for (int32_t mode = 0; mode < 2; mode += 1)
+            {
+                CuiCoverageMode coverage_mode = mode ? CUI_COVERAGE_MODE_ANALYTIC : CUI_COVERAGE_MODE_SAMPLED;
+
+                CuiBitmap bitmap;
+                bitmap.pixels = mode ? analytic_pixels : sampled_pixels;
+
+                uint64_t start = cui_platform_get_performance_counter();
+
+                for (int32_t glyph_index = 0; glyph_index < cui_array_count(glyphs); glyph_index += 1)
+                {
+                    glyphs[glyph_index].bitmap.pixels = bitmap.pixels;
+                    _cui_benchmark_fill(glyphs + glyph_index, &bitmap, coverage_mode);
+                }
+
+                uint64_t time = cui_platform_get_performance_counter() - start;
+
+                if (time < times[mode]) times[mode] = time;
+            }
+        }
+
+        uint64_t difference_sum = 0;
+
+        for (int32_t glyph_index = 0; glyph_index < cui_array_count(glyphs); glyph_index += 1)
+        {
+            CuiBitmap sampled, analytic;
+
+            glyphs[glyph_index].bitmap.pixels = sampled_pixels;
+            _cui_benchmark_fill(glyphs + glyph_index, &sampled, CUI_COVERAGE_MODE_SAMPLED);
+
+            glyphs[glyph_index].bitmap.pixels = analytic_pixels;
+            _cui_benchmark_fill(glyphs + glyph_index, &analytic, CUI_COVERAGE_MODE_ANALYTIC);
+
+            for (int32_t index = 0; index < (sampled.stride * sampled.height); index += 1)
+            {
+                int32_t difference = (int32_t) sampled_pixels[index] - (int32_t) analytic_pixels[index];
+                difference_sum += (uint64_t) ((difference < 0) ? -difference : difference);
+            }
+        }
+
+        printf("  %6g  %7d  %10llu  %10.3fms  %10.3fms  %7.2fx  %10.3f\n", sizes[size_index], cui_array_count(glyphs),
+               (unsigned long long) pixel_count, _cui_benchmark_to_ms(times[0]), _cui_benchmark_to_ms(times[1]),
+               (double) times[0] / (double) times[1],
+               pixel_count ? ((double) difference_sum / (double) pixel_count) : 0.0);
+
+        cui_end_temporary_memory(temp_memory);
+    }
+
+    return 0;
+}
@@ -0,0 +1,286 @@
+// Measures the glyph cache allocator and its eviction with synthetic glyphs, without rasterizing them.
+//
+//   glyph_cache_benchmark [-n <frames>] [-p <glyphs per page>] [-v <glyphs scrolled per frame>]
+//
+// 'packing' allocates glyphs of random sizes into an empty cache until the first allocation fails.
+// 'scrolling' draws a page of a long document every frame, which moves by some glyphs per frame.
+// On top of that every frame uses the same small glyphs of a user interface. The glyph sizes are
+// derived from their keys, so every run sees the same sequence of lookups.
+
+#include <stdio.h>
+
+#if !defined(CUI_RENDERER_SOFTWARE_ENABLED)
+#  define CUI_RENDERER_SOFTWARE_ENABLED 1
+#endif
+
+#include "cui.c"
+
+static const float _cui_benchmark_font_sizes[] = { 11.0f, 13.0f, 16.0f, 20.0f, 28.0f, 40.0f, 64.0f };
+
+static inline uint32_t
+_cui_benchmark_hash(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x7FEB352D;
+    value ^= value >> 15;
+    value *= 0x846CA68B;
+    value ^= value >> 16;
+    return value;
+}
+
+static inline double
+_cui_benchmark_to_ms(uint64_t time)
+{
+    return (1000.0 * (double) time) / (double) _cui_context.common.perf_frequency;
+}
+
+// Picks the key of the n-th glyph of a text. Every paragraph of 300 glyphs has its own font and
+// size, and most glyphs are lower case letters.
+static CuiGlyphKey
+_cui_benchmark_get_key(uint32_t seed, uint32_t index)
+{
+    uint32_t paragraph_hash = _cui_benchmark_hash(seed ^ (index / 300));
+    uint32_t glyph_hash = _cui_benchmark_hash((seed * 31) ^ index);
+
+    CuiGlyphKey key;
+    key.id = 1 + (paragraph_hash % 3);
+    key.codepoint = ((glyph_hash & 3) == 3) ? (32 + ((glyph_hash >> 2) % 95)) : ('a' + ((glyph_hash >> 2) % 26));
+    key.scale = _cui_benchmark_font_sizes[(paragraph_hash >> 8) % CuiArrayCount(_cui_benchmark_font_sizes)];
+    key.offset_x = 0.125f * (float) ((glyph_hash >> 12) % 8);
+    key.offset_y = 0.0f;
+    key.coverage_mode = CUI_COVERAGE_MODE_SAMPLED;
+
+    return key;
+}
+
+static void
+_cui_benchmark_get_glyph_size(CuiGlyphKey key, int32_t *width, int32_t *height)
+{
+    uint32_t hash = _cui_benchmark_hash((key.id * 131) ^ (key.codepoint * 7919) ^ (uint32_t) key.scale);
+
+    *width  = 1 + (int32_t) ceilf(key.scale * (0.25f + 0.5f * (float) (hash & 0xFF) / 255.0f) + key.offset_x);
+    *height = 1 + (int32_t) ceilf(key.scale * (0.5f + 0.5f * (float) ((hash >> 8) & 0xFF) / 255.0f));
+}
+
+typedef struct CuiBenchmarkStatistics
+{
+    uint64_t lookup_count;
+    uint64_t miss_count;
+    uint64_t failed_allocation_count;
+
+    uint64_t allocation_time;
+    uint64_t eviction_time;
+    uint64_t max_eviction_time;
+    uint64_t max_frame_time;
+
+    uint32_t eviction_count;
+    uint32_t reset_count;
+} CuiBenchmarkStatistics;
+
+static void
+_cui_benchmark_lookup(CuiGlyphCache *cache, CuiCommandBuffer *command_buffer, CuiGlyphKey key, CuiBenchmarkStatistics *statistics)
+{
+    CuiRect uv;
+
+    statistics->lookup_count += 1;
+
+    if (!_cui_glyph_cache_find_key(cache, &key, &uv))
+    {
+        int32_t width, height;
+        _cui_benchmark_get_glyph_size(key, &width, &height);
+
+        uint64_t start = cui_platform_get_performance_counter();
+
+        uv = _cui_glyph_cache_allocate_texture(cache, width, height, command_buffer);
+
+        statistics->allocation_time += cui_platform_get_performance_counter() - start;
+
+        statistics->miss_count += 1;
+
+        if (!cui_rect_has_area(uv))
+        {
+            statistics->failed_allocation_count += 1;
+        }
+
+        _cui_glyph_cache_put_key(cache, &key, uv);
+    }
+}
+
+static void
+_cui_benchmark_packing(CuiRendererSoftware *renderer)
+{
+    CuiCommandBuffer *command_buffer = _cui_renderer_software_begin_command_buffer(renderer);
+
+    CuiGlyphCache cache;
+    CuiClearStruct(cache);
+
+    _cui_glyph_cache_initialize(&cache, command_buffer, 1, CUI_TEXTURE_FORMAT_A8, CUI_GLYPH_CACHE_TEXTURE_SIZE);
+
+    uint32_t count = 0;
+    int64_t glyph_area = 0;
+
+    uint64_t start = cui_platform_get_performance_counter();
+
+    for (;;)
+    {
+        int32_t width, height;
+        _cui_benchmark_get_glyph_size(_cui_benchmark_get_key(1, count), &width, &height);
+
+        CuiRect rect = _cui_glyph_cache_allocate_texture(&cache, width, height, command_buffer);
+
+        if (!cui_rect_has_area(rect))
+        {
+            break;
+        }
+
+        glyph_area += (int64_t) width * (int64_t) height;
+        count += 1;
+
+        // NOTE: The texture updates are not needed, but they would fill up the command buffer.
+        if (!(count % 1024))
+        {
+            command_buffer = _cui_renderer_software_begin_command_buffer(renderer);
+        }
+    }
+
+    uint64_t time = cui_platform_get_performance_counter() - start;
+
+    double texture_area = (double) cache.texture.width * (double) cache.texture.height;
+
+    printf("packing: %ux%u texture, %u plots of %dx%d\n", cache.texture.width, cache.texture.height,
+           cache.plot_count, cache.plot_width, cache.plot_height);
+    printf("  %8s  %11s  %11s  %13s  %11s\n", "glyphs", "glyph area", "used area", "time", "per glyph");
+    printf("  %8u  %10.1f%%  %10.1f%%  %10.3fms  %9.1fns\n\n", count,
+           100.0 * (double) glyph_area / texture_area,
+           100.0 * (double) _cui_glyph_cache_get_used_area(&cache) / texture_area,
+           _cui_benchmark_to_ms(time), 1000000.0 * _cui_benchmark_to_ms(time) / (double) cui_max_uint32(count, 1));
+
+    _cui_glyph_cache_deallocate(&cache);
+}
+
+static void
+_cui_benchmark_scrolling(CuiRendererSoftware *renderer, int32_t frame_count, int32_t page_glyph_count, int32_t scroll_speed)
+{
+    CuiCommandBuffer *command_buffer = _cui_renderer_software_begin_command_buffer(renderer);
+
+    CuiGlyphCache cache;
+    CuiClearStruct(cache);
+
+    _cui_glyph_cache_initialize(&cache, command_buffer, 1, CUI_TEXTURE_FORMAT_A8, CUI_GLYPH_CACHE_TEXTURE_SIZE);
+
+    CuiBenchmarkStatistics statistics;
+    CuiClearStruct(statistics);
+
+    for (int32_t frame = 0; frame < frame_count; frame += 1)
+    {
+        uint64_t frame_start = cui_platform_get_performance_counter();
+
+        command_buffer = _cui_renderer_software_begin_command_buffer(renderer);
+
+        uint32_t generation = cache.generation;
+        uint32_t entry_count = cache.count;
+
+        uint64_t eviction_start = cui_platform_get_performance_counter();
+
+        _cui_glyph_cache_maybe_evict(&cache, command_buffer);
+
+        uint64_t eviction_time = cui_platform_get_performance_counter() - eviction_start;
+
+        statistics.eviction_time += eviction_time;
+        if (eviction_time > statistics.max_eviction_time) statistics.max_eviction_time = eviction_time;
+
+        if (cache.generation != generation)
+        {
+            if (entry_count && !cache.count)
+            {
+                statistics.reset_count += 1;
+            }
+            else
+            {
+                statistics.eviction_count += 1;
+            }
+        }
+
+        // The user interface, two fonts in two small sizes.
+        for (uint32_t index = 0; index < (4 * 95); index += 1)
+        {
+            CuiGlyphKey key;
+            key.id = 1 + (index / 190);
+            key.codepoint = 32 + (index % 95);
+            key.scale = _cui_benchmark_font_sizes[(index / 95) % 2];
+            key.offset_x = 0.0f;
+            key.offset_y = 0.0f;
+            key.coverage_mode = CUI_COVERAGE_MODE_SAMPLED;
+
+            _cui_benchmark_lookup(&cache, command_buffer, key, &statistics);
+        }
+
+        uint32_t first_glyph = (uint32_t) frame * (uint32_t) scroll_speed;
+
+        for (uint32_t index = 0; index < (uint32_t) page_glyph_count; index += 1)
+        {
+            _cui_benchmark_lookup(&cache, command_buffer, _cui_benchmark_get_key(2, first_glyph + index), &statistics);
+        }
+
+        uint64_t frame_time = cui_platform_get_performance_counter() - frame_start;
+
+        if (frame_time > statistics.max_frame_time) statistics.max_frame_time = frame_time;
+    }
+
+    uint64_t lookup_count = statistics.lookup_count ? statistics.lookup_count : 1;
+    uint64_t miss_count = statistics.miss_count ? statistics.miss_count : 1;
+
+    printf("scrolling: %d frames, %d glyphs per page, %d glyphs per frame scrolled\n", frame_count, page_glyph_count, scroll_speed);
+    printf("  %9s  %9s  %10s  %10s  %13s  %13s  %13s\n", "hit rate", "failed", "evictions", "resets",
+           "allocation", "eviction", "max frame");
+    printf("  %8.2f%%  %9llu  %10u  %10u  %10.1fns  %10.3fms  %10.3fms\n",
+           100.0 * (1.0 - ((double) statistics.miss_count / (double) lookup_count)),
+           (unsigned long long) statistics.failed_allocation_count, statistics.eviction_count, statistics.reset_count,
+           1000000.0 * _cui_benchmark_to_ms(statistics.allocation_time) / (double) miss_count,
+           _cui_benchmark_to_ms(statistics.max_eviction_time), _cui_benchmark_to_ms(statistics.max_frame_time));
+
+    _cui_glyph_cache_deallocate(&cache);
+}
+
+int main(int argument_count, char **arguments)
+{
+    int32_t frame_count = 2000;
+    int32_t page_glyph_count = 2000;
+    int32_t scroll_speed = 40;
+
+    for (int argument_index = 1; argument_index < argument_count; argument_index += 1)
+    {
+        CuiString argument = CuiCString(arguments[argument_index]);
+
+        if (cui_string_equals(argument, CuiStringLiteral("-n")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            frame_count = cui_max_int32(1, cui_string_parse_int32(CuiCString(arguments[argument_index])));
+        }
+        else if (cui_string_equals(argument, CuiStringLiteral("-p")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            page_glyph_count = cui_max_int32(0, cui_string_parse_int32(CuiCString(arguments[argument_index])));
+        }
+        else if (cui_string_equals(argument, CuiStringLiteral("-v")) && ((argument_index + 1) < argument_count))
+        {
+            argument_index += 1;
+            scroll_speed = cui_max_int32(0, cui_string_parse_int32(CuiCString(arguments[argument_index])));
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n <frames>] [-p <glyphs per page>] [-v <glyphs scrolled per frame>]\n", arguments[0]);
+            return 1;
+        }
+    }
+
+    _cui_context.common.perf_frequency = cui_platform_get_performance_frequency();
+    cui_arena_allocate(&_cui_context.common.temporary_memory, CuiMiB(4));
+
+    CuiRendererSoftware *renderer = CuiContainerOf(_cui_renderer_software_create(), CuiRendererSoftware, base);
+
+    _cui_benchmark_packing(renderer);
+    _cui_benchmark_scrolling(renderer, frame_count, page_glyph_count, scroll_speed);
+
+    return 0;
+}
@@ -26,14 +26,36 @@
 #  define CUI_FRAMEBUFFER_SCREENSHOT_ENABLED 0
 #endif
 
+#if !defined(CUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED)
+#  define CUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED 0
+#endif
+
 #if !defined(CUI_RENDERER_OPENGLES2_RENDER_TIMES_ENABLED)
 #  define CUI_RENDERER_OPENGLES2_RENDER_TIMES_ENABLED 0
 #endif
 
+#if !defined(CUI_PRIMITIVE_MERGING_ENABLED)
+#  define CUI_PRIMITIVE_MERGING_ENABLED 0
+#endif
+
+#if !defined(CUI_COMMAND_BUFFER_CAPTURE_ENABLED)
+#  define CUI_COMMAND_BUFFER_CAPTURE_ENABLED 0
+#endif
+
+#if !defined(CUI_GLYPH_CACHE_STATISTICS_ENABLED)
+#  define CUI_GLYPH_CACHE_STATISTICS_ENABLED 0
+#endif
+
 #if !CUI_PLATFORM_WINDOWS
 #include <pthread.h>
 #endif
 
+#if CUI_PLATFORM_LINUX || CUI_PLATFORM_ANDROID
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
 typedef enum CuiJpegMode
 {
     CUI_JPEG_MODE_UNKNOWN     = 0,
@@ -69,6 +91,22 @@ typedef struct CuiJpegQuantizationTable
     uint8_t values[64];
 } CuiJpegQuantizationTable;
 
+typedef struct CuiJpegBand
+{
+    CuiBitmap *bitmap;
+    CuiJpegComponent *components;
+    int32_t component_count;
+
+    int32_t max_factor_x;
+    int32_t max_factor_y;
+    int32_t block_count_x;
+    int32_t blocks_per_mcu;
+
+    int32_t first_block_y;
+    float *coefficients; // dequantized, in natural order
+    float *mcu;          // one mcu per row of the band
+} CuiJpegBand;
+
 typedef struct CuiJpegBitReader
 {
     CuiString *stream;
@@ -95,6 +133,19 @@ typedef struct CuiEdge
     float x1, y1;
 } CuiEdge;
 
+// An edge is active from the first to the last row it crosses. The edges are sorted into
+// buckets by their first row, so that every row only visits the edges that are active.
+typedef struct CuiActiveEdgeTable
+{
+    int32_t *last_rows;
+    int32_t *row_ends; // end of the bucket of every row in 'sorted_edges'
+    int32_t *sorted_edges;
+    int32_t sorted_edge_index;
+
+    int32_t active_edge_count;
+    int32_t *active_edges;
+} CuiActiveEdgeTable;
+
 typedef struct CuiColoredGlyphLayer
 {
     uint32_t glyph_index;
@@ -131,6 +182,9 @@ typedef struct CuiFontFile
     CuiString name;
     CuiString contents;
 
+    // hash of the path, the size and the modification time of the file
+    uint64_t identity;
+
     int16_t ascent;
     int16_t descent;
     int16_t line_gap;
@@ -194,7 +248,9 @@ typedef struct CuiFontManager
 #ifndef CUI_NO_BACKEND
 
 #define CUI_MAX_WINDOW_COUNT 16
+// The number of textures of renderers that bind all textures at once (Metal, Direct3D 11).
 #define CUI_MAX_TEXTURE_COUNT 16
+#define CUI_MAX_DIRTY_RECT_COUNT 32
 #define CUI_DEFAULT_WINDOW_WIDTH 800
 #define CUI_DEFAULT_WINDOW_HEIGHT 600
 
@@ -204,27 +260,71 @@ typedef struct CuiWorkerThreadTaskGroup
     volatile uint32_t completion_count;
 
     void (*task_func)(void *);
+
+    // Time in performance counter ticks the completing thread waited for other threads.
+    uint64_t wait_time;
+    uint32_t park_count;
 } CuiWorkerThreadTaskGroup;
 
+typedef struct CuiParallelFor
+{
+    CuiWorkerThreadTaskGroup task_group;
+
+    void (*func)(void *data, int64_t begin, int64_t end);
+    void *data;
+
+    int64_t count;
+    int64_t grain;
+
+    volatile uint32_t next_chunk_index;
+    uint32_t chunk_count;
+} CuiParallelFor;
+
 typedef struct CuiWorkerThreadQueueEntry
 {
     CuiWorkerThreadTaskGroup *task_group;
     void *data;
 } CuiWorkerThreadQueueEntry;
 
+// Every worker thread owns one deque. The owner pushes and pops at the bottom,
+// other threads steal the oldest entries from the top. Deque 0 belongs to all
+// threads that are not worker threads (e.g. the main thread).
+typedef struct CuiWorkerThreadDeque
+{
+    volatile uint32_t lock;
+    volatile uint32_t top;
+    volatile uint32_t bottom;
+
+    uint32_t capacity; // always a power of two
+    CuiWorkerThreadQueueEntry *entries;
+
+    // NOTE: keep every deque on its own cache line
+    uint8_t padding[64 - 3 * sizeof(uint32_t) - sizeof(uint32_t) - sizeof(CuiWorkerThreadQueueEntry *)];
+} CuiWorkerThreadDeque;
+
 typedef struct CuiWorkerThreadQueue
 {
-    volatile uint32_t write_index;
-    volatile uint32_t read_index;
+    volatile uint32_t pending_count;
+    volatile uint32_t sleeping_count;
+    volatile uint32_t parked_count;
+
+    uint32_t deque_count;
 
 #if CUI_PLATFORM_WINDOWS
     HANDLE semaphore;
+    SRWLOCK completion_lock;
+    CONDITION_VARIABLE completion_cond;
 #else
     pthread_mutex_t semaphore_mutex;
     pthread_cond_t semaphore_cond;
+#  if !CUI_PLATFORM_LINUX && !CUI_PLATFORM_ANDROID
+    pthread_mutex_t completion_mutex;
+    pthread_cond_t completion_cond;
+#  endif
 #endif
 
-    CuiWorkerThreadQueueEntry entries[64];
+    // NOTE: 'deque_count' deques, one more than there are worker threads.
+    CuiWorkerThreadDeque *deques;
 } CuiWorkerThreadQueue;
 
 typedef enum CuiBackgroundTaskState
@@ -257,6 +357,18 @@ typedef struct CuiBackgroundThreadQueue
     CuiBackgroundThreadQueueEntry entries[8];
 } CuiBackgroundThreadQueue;
 
+typedef enum CuiTextureFormat
+{
+    CUI_TEXTURE_FORMAT_BGRA8 = 0,
+    CUI_TEXTURE_FORMAT_A8    = 1, // coverage only, samples as premultiplied white
+} CuiTextureFormat;
+
+static inline int32_t
+_cui_texture_format_get_bytes_per_pixel(CuiTextureFormat format)
+{
+    return (format == CUI_TEXTURE_FORMAT_A8) ? 1 : 4;
+}
+
 typedef struct CuiGlyphKey
 {
     // NOTE: id 0 is for shapes, aller others are font ids
@@ -267,8 +379,52 @@ typedef struct CuiGlyphKey
     float scale;
     float offset_x;
     float offset_y;
+
+    // NOTE: Shapes are always rasterized with CUI_COVERAGE_MODE_SAMPLED.
+    CuiCoverageMode coverage_mode;
 } CuiGlyphKey;
 
+#define CUI_GLYPH_CACHE_RECENT_FRAME_COUNT 8
+
+// Glyphs and shapes only need coverage and go into an A8 texture. Colored glyphs,
+// e.g. emoji, go into a separate BGRA texture, that is only allocated once needed.
+#define CUI_GLYPH_CACHE_TEXTURE_SIZE 2048
+#define CUI_COLOR_GLYPH_CACHE_TEXTURE_SIZE 1024
+
+#define CUI_GLYPH_CACHE_PLOT_SIZE 512
+
+// A skyline node covers the columns [x, x + width) of a plot, which are used up to row 'y'.
+typedef struct CuiGlyphSkylineNode
+{
+    int16_t x;
+    int16_t y;
+    int16_t width;
+} CuiGlyphSkylineNode;
+
+// The glyph cache texture is split into plots, that are packed with a skyline allocator.
+// Glyphs are evicted per plot, the one that wasn't used for the longest time goes first.
+typedef struct CuiGlyphPlot
+{
+    int32_t x;
+    int32_t y;
+
+    uint32_t node_count;
+    CuiGlyphSkylineNode *nodes;
+
+    // The last frame in which a replayed retained drawing sampled from this plot.
+    uint32_t last_replayed_frame;
+
+    // Only set on the first plot of an allocation that is larger than a single plot. The allocation
+    // covers 'span_x' x 'span_y' plots, the others are marked as full and are reset together with it.
+    int32_t span_x;
+    int32_t span_y;
+
+    // Only valid during an eviction.
+    uint32_t last_used_frame;
+    uint32_t entry_count;
+    uint32_t recent_entry_count;
+} CuiGlyphPlot;
+
 typedef struct CuiGlyphCache
 {
     uint32_t count;
@@ -276,18 +432,126 @@ typedef struct CuiGlyphCache
 
     uint32_t insertion_failure_count;
 
-    uint32_t *hashes;
+    uint32_t *hashes; // the hash of the key, 0 for an empty bucket
     CuiGlyphKey *keys;
     CuiRect *rects;
+    uint32_t *last_used_frames;
+
+    // Counts the frames, every glyph stores the frame it was last used in.
+    uint32_t frame;
 
-    int32_t x, y, y_max;
+    uint32_t plot_count;
+    int32_t plot_count_x;
+    int32_t plot_width;
+    int32_t plot_height;
+    CuiGlyphPlot *plots;
 
     int32_t texture_id;
+    CuiTextureFormat texture_format;
     CuiBitmap texture;
 
+    // Incremented whenever entries are removed, so that
+    // retained drawings that reference them can be dropped.
+    uint32_t generation;
+
+    // Every window that draws with the glyph cache has a texture of its own. The texture of the
+    // window that is drawing right now is the bound one, the others collect the updates they miss.
+    struct CuiGlyphCacheTexture *bound_texture;
+    uint32_t window_texture_count;
+    struct CuiGlyphCacheTexture *window_textures[CUI_MAX_WINDOW_COUNT];
+
+#if CUI_GLYPH_CACHE_STATISTICS_ENABLED
+    uint64_t lookup_count;
+    uint64_t hit_count;
+    uint64_t probe_count;
+    uint64_t key_compare_count;
+    uint32_t max_probe_length;
+#endif
+
     uint64_t allocation_size;
 } CuiGlyphCache;
 
+// The glyph caches of all windows with CUI_WINDOW_CREATION_FLAG_SHARED_GLYPH_CACHE
+// that use the same renderer type. They are deallocated with the last of these windows.
+typedef struct CuiSharedGlyphCache
+{
+    uint32_t ref_count;
+    CuiGlyphCache glyph_cache;
+    CuiGlyphCache color_glyph_cache;
+} CuiSharedGlyphCache;
+
+// The glyph cache file stores the glyphs of the glyph cache texture across runs of the
+// application. It starts with the header, followed by the entries and their pixels.
+#define CUI_GLYPH_CACHE_FILE_MAGIC   0x48434743 // 'CGCH'
+#define CUI_GLYPH_CACHE_FILE_VERSION 2
+
+typedef struct CuiGlyphCacheFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t pixels_size;
+} CuiGlyphCacheFileHeader;
+
+typedef struct CuiGlyphCacheFileEntry
+{
+    uint64_t font_identity;
+    uint32_t codepoint;
+    float scale;
+    float offset_x;
+    float offset_y;
+    uint16_t width;
+    uint16_t height;
+    uint32_t pixels_offset;
+    uint32_t coverage_mode;
+    uint32_t reserved;
+} CuiGlyphCacheFileEntry;
+
+// A glyph that already got its place in a glyph cache texture, but is only rasterized
+// together with all other glyphs of the frame, before the frame is rendered.
+typedef struct CuiGlyphRasterization
+{
+    CuiFontFile *font_file;
+    uint32_t glyph_index;
+    CuiTextureFormat format;
+    CuiCoverageMode coverage_mode;
+    CuiTransform transform;
+    CuiBitmap bitmap;
+} CuiGlyphRasterization;
+
+typedef struct CuiGlyphRasterizationQueue
+{
+    uint32_t count;
+    uint32_t allocated;
+    CuiGlyphRasterization *entries;
+} CuiGlyphRasterizationQueue;
+
+typedef struct CuiGlyphPrewarmRequest
+{
+    CuiFontId font_id;
+    bool in_background;
+    int32_t range_count;
+    CuiCodepointRange *ranges;
+} CuiGlyphPrewarmRequest;
+
+// Glyphs that are rasterized ahead of time into bitmaps of their own. These
+// are copied into the glyph cache with the first frame after they are finished.
+typedef struct CuiGlyphPrewarm
+{
+    struct CuiGlyphPrewarm *next;
+
+    CuiBackgroundTask task;
+    bool in_background;
+    float ui_scale;
+
+    uint32_t count;
+    CuiGlyphKey *keys;
+    CuiGlyphRasterization *rasterizations;
+
+    uint64_t allocation_size;
+} CuiGlyphPrewarm;
+
 typedef enum CuiTextureOperationType
 {
     CUI_TEXTURE_OPERATION_ALLOCATE   = 0,
@@ -295,42 +559,201 @@ typedef enum CuiTextureOperationType
     CUI_TEXTURE_OPERATION_UPDATE     = 2,
 } CuiTextureOperationType;
 
+// A texture id contains the index of its slot in the lower bits and the generation of
+// the slot in the upper bits. The generation changes every time a slot is reused, so
+// ids of textures that were deallocated in the meantime can be detected.
+#define CUI_TEXTURE_ID_INDEX_BITS 16
+#define CUI_TEXTURE_ID_INDEX_MASK ((1 << CUI_TEXTURE_ID_INDEX_BITS) - 1)
+#define CUI_TEXTURE_ID_MAX_GENERATION 0x7FFF
+#define CUI_MAX_TEXTURE_TABLE_COUNT (1 << CUI_TEXTURE_ID_INDEX_BITS)
+
+static inline uint32_t
+_cui_texture_id_get_index(uint32_t texture_id)
+{
+    return texture_id & CUI_TEXTURE_ID_INDEX_MASK;
+}
+
+typedef struct CuiTextureSlot
+{
+    uint16_t generation;
+    uint16_t is_allocated;
+    uint32_t next_free; // index + 1 of the next free slot, 0 for none
+} CuiTextureSlot;
+
+#define CUI_MAX_TEXTURE_UPDATE_RECT_COUNT 8
+
+// The rects of an update are disjoint. Rects that overlap, or that would
+// waste little area when combined, are merged into their bounding rect.
+typedef struct CuiTextureUpdate
+{
+    uint32_t rect_count;
+    CuiRect rects[CUI_MAX_TEXTURE_UPDATE_RECT_COUNT];
+} CuiTextureUpdate;
+
 typedef struct CuiTextureOperation
 {
     uint16_t type;
-    uint16_t texture_id;
+    uint16_t format; // CuiTextureFormat of an allocation
+    uint32_t texture_id;
 
     union
     {
         CuiBitmap bitmap;
-        CuiRect rect;
+        CuiTextureUpdate update;
     } payload;
 } CuiTextureOperation;
 
-typedef struct CuiTextureState
+// The texture of a glyph cache in the renderer of one window.
+typedef struct CuiGlyphCacheTexture
+{
+    int32_t texture_id;
+    bool is_allocated;
+    CuiTextureUpdate update; // changes of other windows since the last frame of this window
+} CuiGlyphCacheTexture;
+
+// A texture as the renderer sees it. 'texture_id' is 0 if the slot is not in use.
+typedef struct CuiTexture
 {
     uint32_t texture_id;
+    uint32_t backend_texture; // e.g. the OpenGL texture name
+    uint64_t memory_size;
+    CuiTextureFormat format;
     CuiBitmap bitmap;
-} CuiTextureState;
+} CuiTexture;
+
+// The textures of a renderer, indexed by the slot index of the texture id.
+typedef struct CuiTextureTable
+{
+    uint32_t allocated;
+    uint32_t texture_count;
+    CuiTexture *textures;
+
+    // Bytes of texture memory, for the GPU renderers this is the memory of the uploaded textures.
+    uint64_t memory_size;
+    uint64_t max_memory_size;
+} CuiTextureTable;
+
+// Push buffer memory that gets chained onto a full push buffer. The data follows the header.
+typedef struct CuiCommandBufferBlock
+{
+    struct CuiCommandBufferBlock *next;
+
+    uint32_t offset; // push buffer offset of the first byte
+    uint32_t capacity;
+} CuiCommandBufferBlock;
 
 typedef struct CuiCommandBuffer
 {
     int32_t max_texture_width;
     int32_t max_texture_height;
 
+    // 'push_buffer_size' is the offset of the next primitive. Once 'push_buffer' is full further
+    // primitives go into chained blocks, so offsets and pointers that were handed out stay valid.
+    // Before rendering, _cui_command_buffer_finish() merges the blocks back into 'push_buffer'.
     uint32_t push_buffer_size;
     uint32_t max_push_buffer_size;
     uint8_t *push_buffer;
 
+    CuiCommandBufferBlock *first_block;
+    CuiCommandBufferBlock *current_block;
+
     uint32_t index_buffer_count;
     uint32_t max_index_buffer_count;
     uint32_t *index_buffer;
 
+    // The number of primitives before _cui_command_buffer_merge_primitives() ran.
+    uint32_t unmerged_index_buffer_count;
+
     uint32_t texture_operation_count;
     uint32_t max_texture_operation_count;
     CuiTextureOperation *texture_operations;
+
+    // The largest frame so far, to size the initial allocation.
+    uint32_t push_buffer_high_water_mark;
+    uint32_t index_buffer_high_water_mark;
+    uint32_t texture_operation_high_water_mark;
 } CuiCommandBuffer;
 
+#define CUI_COMMAND_BUFFER_CAPTURE_MAGIC   0x43425543 // 'CUBC'
+#define CUI_COMMAND_BUFFER_CAPTURE_VERSION 4
+
+// A capture file starts with this header, followed by the push buffer, the index buffer,
+// 'texture_operation_count' CuiCommandBufferCaptureTextureOperation and 'texture_count'
+// CuiCommandBufferCaptureTexture, each directly followed by its tightly packed pixels.
+// Everything is stored in the byte order of the machine that wrote it.
+typedef struct CuiCommandBufferCaptureHeader
+{
+    uint32_t magic;
+    uint32_t version;
+
+    int32_t width;
+    int32_t height;
+    CuiColor clear_color;
+
+    uint32_t push_buffer_size;
+    uint32_t index_buffer_count;
+    uint32_t texture_operation_count;
+    uint32_t texture_count;
+} CuiCommandBufferCaptureHeader;
+
+typedef struct CuiCommandBufferCaptureTextureOperation
+{
+    uint16_t type;
+    uint16_t rect_count;
+    uint32_t texture_id;
+    CuiRect rects[CUI_MAX_TEXTURE_UPDATE_RECT_COUNT];
+} CuiCommandBufferCaptureTextureOperation;
+
+typedef struct CuiCommandBufferCaptureTexture
+{
+    uint32_t texture_id;
+    uint32_t format;
+    int32_t width;
+    int32_t height;
+} CuiCommandBufferCaptureTexture;
+
+// A recorded range of a command buffer for one widget. The key members decide if the
+// recording can be replayed in the next frame. In the recorded primitives every offset
+// is relative to the start of the range, a clip rect offset of 0 refers to the clip rect
+// that was active when the recording started.
+typedef struct CuiRetainedDrawing
+{
+    CuiWidget *widget;
+
+    // key
+    uint32_t version;
+    uint32_t state;
+    uint32_t value;
+    uint32_t flags;
+    float ui_scale;
+    const CuiColorTheme *color_theme;
+    CuiRect rect;
+    CuiRect clip_rect;
+
+    uint32_t push_buffer_offset;
+    uint32_t push_buffer_size;
+    uint32_t first_index;
+    uint32_t index_count;
+
+    uint32_t end_clip_rect_offset;
+} CuiRetainedDrawing;
+
+typedef struct CuiRetainedDrawingCache
+{
+    // hash map keyed by the widget pointer
+    uint32_t count;
+    uint32_t allocated;
+    CuiRetainedDrawing *drawings;
+
+    uint32_t push_buffer_size;
+    uint32_t max_push_buffer_size;
+    uint8_t *push_buffer;
+
+    uint32_t index_count;
+    uint32_t max_index_count;
+    uint32_t *indices;
+} CuiRetainedDrawingCache;
+
 typedef struct CuiKernel
 {
     float factor;
@@ -374,6 +797,8 @@ typedef enum CuiRendererType
     CUI_RENDERER_TYPE_DIRECT3D11 = 3,
 } CuiRendererType;
 
+#define CUI_RENDERER_TYPE_COUNT 4
+
 typedef struct CuiRenderer
 {
     CuiRendererType type;
@@ -412,9 +837,15 @@ typedef struct CuiWindowBase
     bool take_screenshot;
 #endif
 
-    // This is a bit mask where the index of the bit is the
-    // texture id and a bit being 1 means this texture id is in use.
-    uint32_t allocated_texture_ids;
+#if CUI_COMMAND_BUFFER_CAPTURE_ENABLED
+    bool capture_command_buffer;
+#endif
+
+    // The texture ids that were handed out by cui_window_allocate_texture_id().
+    uint32_t texture_slot_count;
+    uint32_t max_texture_slot_count;
+    uint32_t first_free_texture_slot; // index + 1, 0 for none
+    CuiTextureSlot *texture_slots;
 
     CuiCursorType cursor;
 
@@ -440,8 +871,31 @@ typedef struct CuiWindowBase
     // TODO: remove this, this should be handled by the window_frame_routine
     CuiWindowFrameResult window_frame_result;
 
-    CuiGlyphCache glyph_cache;
+    // These point to the glyph caches of the window or, with CUI_WINDOW_CREATION_FLAG_SHARED_GLYPH_CACHE,
+    // to the ones that are shared with other windows. They are set up with the first frame.
+    CuiGlyphCache *glyph_cache;
+    CuiGlyphCache *color_glyph_cache;
+    CuiSharedGlyphCache *shared_glyph_cache;
+
+    CuiGlyphCache window_glyph_cache;
+    CuiGlyphCache window_color_glyph_cache;
+    CuiGlyphCacheTexture glyph_cache_texture;
+    CuiGlyphCacheTexture color_glyph_cache_texture;
+
+    CuiGlyphRasterizationQueue glyph_rasterization_queue;
     CuiFontManager font_manager;
+
+    CuiCoverageMode glyph_coverage_mode;
+    float glyph_coverage_min_height;
+
+    CuiGlyphPrewarmRequest *glyph_prewarm_requests;
+    CuiGlyphPrewarm *glyph_prewarms; // oldest first
+
+    // The drawings of the current and the previous frame.
+    uint32_t retained_drawing_index;
+    uint32_t retained_drawing_glyph_cache_generation;
+    uint32_t retained_drawing_color_glyph_cache_generation;
+    CuiRetainedDrawingCache retained_drawing_caches[2];
 } CuiWindowBase;
 
 struct CuiGraphicsContext
@@ -451,8 +905,14 @@ struct CuiGraphicsContext
     CuiRect window_rect;
     CuiCommandBuffer *command_buffer;
     CuiGlyphCache *glyph_cache;
+    CuiGlyphCache *color_glyph_cache;
+    CuiGlyphRasterizationQueue *glyph_rasterization_queue;
+    CuiCoverageMode glyph_coverage_mode;
+    float glyph_coverage_min_height;
     CuiArena *temporary_memory;
     CuiFontManager *font_manager;
+    CuiRetainedDrawingCache *retained_drawing_cache;
+    CuiRetainedDrawingCache *prev_retained_drawing_cache;
 };
 
 typedef struct CuiContextCommon
@@ -476,7 +936,12 @@ typedef struct CuiContextCommon
 
     CuiFontFileManager font_file_manager;
 
+    uint32_t widget_drawing_version;
+
     CuiWorkerThreadQueue worker_thread_queue;
+
+    CuiSharedGlyphCache shared_glyph_caches[CUI_RENDERER_TYPE_COUNT];
+
     CuiBackgroundThreadQueue interactive_background_thread_queue;
     CuiBackgroundThreadQueue non_interactive_background_thread_queue;
 
@@ -491,7 +956,53 @@ typedef struct CuiRendererSoftware
     CuiRenderer base;
 
     CuiCommandBuffer command_buffer;
-    CuiBitmap bitmaps[CUI_MAX_TEXTURE_COUNT];
+    CuiTextureTable texture_table;
+
+    bool occlusion_culling_enabled;
+
+    int32_t tile_width_override;
+    int32_t tile_height_override;
+
+    int32_t tile_width;
+    int32_t tile_height;
+    uint32_t tile_count_x;
+    uint32_t tile_count_y;
+
+#if CUI_RENDERER_SOFTWARE_RENDER_TIMES_ENABLED
+    uint64_t platform_performance_frequency;
+
+    float min_render_time;
+    float max_render_time;
+    double sum_render_time;
+    int32_t frame_count;
+
+    uint64_t sum_tile_primitive_count;
+    uint32_t max_tile_primitive_count;
+    uint64_t sum_dirty_pixel_count;
+    uint64_t sum_wait_time;
+    uint32_t sum_park_count;
+    uint64_t sum_unmerged_primitive_count;
+    uint64_t sum_primitive_count;
+#endif
+
+    uint64_t frame_index;
+
+    // Hash of every tile's primitive list and the frame in which it last changed.
+    int32_t tile_state_width;
+    int32_t tile_state_height;
+    uint32_t max_tile_state_count;
+    uint64_t *tile_hashes;
+    uint64_t *tile_change_frames;
+
+    // Scratch memory for the binning pass. Grows on demand.
+    uint64_t binning_memory_size;
+    uint8_t *binning_memory;
+
+    uint64_t tile_primitive_memory_size;
+    uint8_t *tile_primitive_memory;
+
+    uint64_t render_job_memory_size;
+    uint8_t *render_job_memory;
 
     uint64_t allocation_size;
 } CuiRendererSoftware;
@@ -518,6 +1029,7 @@ typedef struct CuiOpengles2DrawCommand
     uint32_t vertex_offset;
     uint32_t vertex_count;
     GLuint texture_id;
+    bool alpha_texture;
     CuiFloatPoint texture_scale;
     int32_t clip_rect_x;
     int32_t clip_rect_y;
@@ -538,6 +1050,9 @@ typedef struct CuiRendererOpengles2
     float max_render_time;
     double sum_render_time;
     int32_t frame_count;
+
+    uint64_t sum_unmerged_primitive_count;
+    uint64_t sum_primitive_count;
 #endif
 
     GLuint program;
@@ -545,13 +1060,14 @@ typedef struct CuiRendererOpengles2
     GLuint vertex_scale_location;
     GLuint texture_scale_location;
     GLuint texture_location;
+    GLuint alpha_texture_location;
     GLuint position_location;
     GLuint color_location;
     GLuint uv_location;
 
-    CuiBitmap bitmaps[CUI_MAX_TEXTURE_COUNT];
-    GLuint textures[CUI_MAX_TEXTURE_COUNT];
+    CuiTextureTable texture_table;
 
+    uint32_t max_rect_count;
     CuiOpengles2Vertex *vertices;
     CuiOpengles2DrawCommand *draw_list;
 
@@ -581,7 +1097,7 @@ typedef struct CuiRendererMetal
     id<MTLBuffer> push_buffer;
     id<MTLBuffer> index_buffer;
 
-    CuiBitmap bitmaps[CUI_MAX_TEXTURE_COUNT];
+    CuiTextureTable texture_table;
     id<MTLTexture> textures[CUI_MAX_TEXTURE_COUNT];
 
     uint64_t allocation_size;
@@ -636,7 +1152,7 @@ typedef struct CuiRendererDirect3D11
     ID3D11RasterizerState *rasterizer_state;
     ID3D11BlendState *blend_state;
 
-    CuiBitmap bitmaps[CUI_MAX_TEXTURE_COUNT];
+    CuiTextureTable texture_table;
     ID3D11Texture2D *textures[CUI_MAX_TEXTURE_COUNT];
     ID3D11ShaderResourceView *texture_views[CUI_MAX_TEXTURE_COUNT];
     ID3D11SamplerState *samplers[CUI_MAX_TEXTURE_COUNT];
@@ -653,6 +1169,11 @@ typedef struct CuiFramebuffer
 
 #if CUI_RENDERER_SOFTWARE_ENABLED
     CuiBitmap bitmap;
+
+    // The frame the pixels are from and the regions that changed compared to the previous frame.
+    uint64_t rendered_frame_index;
+    int32_t dirty_rect_count;
+    CuiRect dirty_rects[CUI_MAX_DIRTY_RECT_COUNT];
 #endif
 
 #if CUI_RENDERER_METAL_ENABLED
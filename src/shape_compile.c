@@ -151,11 +151,7 @@ int main(void)
                           "\n"
                           "                uv = _cui_glyph_cache_allocate_texture(ctx->glyph_cache, width, height, ctx->command_buffer);\n"
                           "\n"
-                          "                CuiBitmap bitmap;\n"
-                          "                bitmap.width = cui_rect_get_width(uv);\n"
-                          "                bitmap.height = cui_rect_get_height(uv);\n"
-                          "                bitmap.stride = ctx->glyph_cache->texture.stride;\n"
-                          "                bitmap.pixels = (uint8_t *) ctx->glyph_cache->texture.pixels + (uv.min.y * bitmap.stride) + (uv.min.x * 4);\n"
+                          "                CuiBitmap bitmap = _cui_glyph_cache_get_bitmap(ctx->glyph_cache, uv);\n"
                           "\n"
                           "                CuiPathCommand *path = 0;\n"
                           "                cui_array_init(path, 16, ctx->temporary_memory);\n\n",
@@ -289,7 +285,11 @@ int main(void)
                           "                cui_array_init(edge_list, 16, ctx->temporary_memory);\n"
                           "\n"
                           "                _cui_path_to_edge_list(path, &edge_list);\n"
-                          "                _cui_edge_list_fill(ctx->temporary_memory, &bitmap, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));\n"
+                          "\n"
+                          "                if (cui_rect_has_area(uv))\n"
+                          "                {\n"
+                          "                    _cui_edge_list_fill(ctx->temporary_memory, &bitmap, ctx->glyph_cache->texture_format, edge_list, cui_make_color(1.0f, 1.0f, 1.0f, 1.0f));\n"
+                          "                }\n"
                           "            } break;\n");
         }
 